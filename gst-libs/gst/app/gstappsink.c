@@ -68,6 +68,7 @@
 
 #include <gst/gst.h>
 #include <gst/base/gstbasesink.h>
+#include <gst/base/gstqueuearray.h>
 #include <gst/gstbuffer.h>
 #include <gst/gstbufferlist.h>
 
@@ -86,7 +87,11 @@ struct _GstAppSinkPrivate
 
   GCond cond;
   GMutex mutex;
-  GQueue *queue;
+  GstQueueArray *queue;
+  /* number of application and streaming threads waiting on cond, so that
+   * queueing and dequeueing only signal when someone is waiting */
+  guint app_waiting;
+  guint stream_waiting;
   GstBuffer *preroll;
   GstCaps *preroll_caps;
   GstCaps *last_caps;
@@ -450,7 +455,7 @@ gst_app_sink_init (GstAppSink * appsink)
 
   g_mutex_init (&priv->mutex);
   g_cond_init (&priv->cond);
-  priv->queue = g_queue_new ();
+  priv->queue = gst_queue_array_new (16);
 
   priv->emit_signals = DEFAULT_PROP_EMIT_SIGNALS;
   priv->max_buffers = DEFAULT_PROP_MAX_BUFFERS;
@@ -480,7 +485,7 @@ gst_app_sink_dispose (GObject * obj)
   GST_OBJECT_UNLOCK (appsink);
 
   g_mutex_lock (&priv->mutex);
-  while ((queue_obj = g_queue_pop_head (priv->queue)))
+  while ((queue_obj = gst_queue_array_pop_head (priv->queue)))
     gst_mini_object_unref (queue_obj);
   gst_buffer_replace (&priv->preroll, NULL);
   gst_caps_replace (&priv->preroll_caps, NULL);
@@ -498,7 +503,7 @@ gst_app_sink_finalize (GObject * obj)
 
   g_mutex_clear (&priv->mutex);
   g_cond_clear (&priv->cond);
-  g_queue_free (priv->queue);
+  gst_queue_array_free (priv->queue);
 
   G_OBJECT_CLASS (parent_class)->finalize (obj);
 }
@@ -616,7 +621,7 @@ gst_app_sink_flush_unlocked (GstAppSink * appsink)
   GST_DEBUG_OBJECT (appsink, "flush stop appsink");
   priv->is_eos = FALSE;
   gst_buffer_replace (&priv->preroll, NULL);
-  while ((obj = g_queue_pop_head (priv->queue)))
+  while ((obj = gst_queue_array_pop_head (priv->queue)))
     gst_mini_object_unref (obj);
   priv->num_buffers = 0;
   g_cond_signal (&priv->cond);
@@ -668,7 +673,7 @@ gst_app_sink_setcaps (GstBaseSink * sink, GstCaps * caps)
 
   g_mutex_lock (&priv->mutex);
   GST_DEBUG_OBJECT (appsink, "receiving CAPS");
-  g_queue_push_tail (priv->queue, gst_event_new_caps (caps));
+  gst_queue_array_push_tail (priv->queue, gst_event_new_caps (caps));
   if (!priv->preroll)
     gst_caps_replace (&priv->preroll_caps, caps);
   g_mutex_unlock (&priv->mutex);
@@ -686,7 +691,7 @@ gst_app_sink_event (GstBaseSink * sink, GstEvent * event)
     case GST_EVENT_SEGMENT:
       g_mutex_lock (&priv->mutex);
       GST_DEBUG_OBJECT (appsink, "receiving SEGMENT");
-      g_queue_push_tail (priv->queue, gst_event_ref (event));
+      gst_queue_array_push_tail (priv->queue, gst_event_ref (event));
       if (!priv->preroll)
         gst_event_copy_segment (event, &priv->preroll_segment);
       g_mutex_unlock (&priv->mutex);
@@ -705,8 +710,11 @@ gst_app_sink_event (GstBaseSink * sink, GstEvent * event)
        * Otherwise we might signal EOS before all buffers are
        * consumed, which is a bit confusing for the application
        */
-      while (priv->num_buffers > 0 && !priv->flushing && priv->wait_on_eos)
+      while (priv->num_buffers > 0 && !priv->flushing && priv->wait_on_eos) {
+        priv->stream_waiting++;
         g_cond_wait (&priv->cond, &priv->mutex);
+        priv->stream_waiting--;
+      }
       if (priv->flushing)
         emit = FALSE;
       g_mutex_unlock (&priv->mutex);
@@ -783,7 +791,7 @@ dequeue_buffer (GstAppSink * appsink)
   GstMiniObject *obj;
 
   do {
-    obj = g_queue_pop_head (priv->queue);
+    obj = gst_queue_array_pop_head (priv->queue);
 
     if (GST_IS_BUFFER (obj) || GST_IS_BUFFER_LIST (obj)) {
       GST_DEBUG_OBJECT (appsink, "dequeued buffer/list %p", obj);
@@ -817,6 +825,29 @@ dequeue_buffer (GstAppSink * appsink)
   return obj;
 }
 
+/* must be called with the mutex and at least one queued buffer/list */
+static GstSample *
+dequeue_sample (GstAppSink * appsink)
+{
+  GstAppSinkPrivate *priv = appsink->priv;
+  GstSample *sample;
+  GstMiniObject *obj;
+
+  obj = dequeue_buffer (appsink);
+  if (GST_IS_BUFFER (obj)) {
+    GST_DEBUG_OBJECT (appsink, "we have a buffer %p", obj);
+    sample = gst_sample_new (GST_BUFFER_CAST (obj), priv->last_caps,
+        &priv->last_segment, NULL);
+  } else {
+    GST_DEBUG_OBJECT (appsink, "we have a list %p", obj);
+    sample = gst_sample_new (NULL, priv->last_caps, &priv->last_segment, NULL);
+    gst_sample_set_buffer_list (sample, GST_BUFFER_LIST_CAST (obj));
+  }
+  gst_mini_object_unref (obj);
+
+  return sample;
+}
+
 static GstFlowReturn
 gst_app_sink_render_common (GstBaseSink * psink, GstMiniObject * data,
     gboolean is_list)
@@ -867,15 +898,18 @@ restart:
       }
 
       /* wait for a buffer to be removed or flush */
+      priv->stream_waiting++;
       g_cond_wait (&priv->cond, &priv->mutex);
+      priv->stream_waiting--;
       if (priv->flushing)
         goto flushing;
     }
   }
   /* we need to ref the buffer/list when pushing it in the queue */
-  g_queue_push_tail (priv->queue, gst_mini_object_ref (data));
+  gst_queue_array_push_tail (priv->queue, gst_mini_object_ref (data));
   priv->num_buffers++;
-  g_cond_signal (&priv->cond);
+  if (priv->app_waiting)
+    g_cond_signal (&priv->cond);
   emit = priv->emit_signals;
   g_mutex_unlock (&priv->mutex);
 
@@ -1440,7 +1474,7 @@ gst_app_sink_try_pull_preroll (GstAppSink * appsink, GstClockTime timeout)
 {
   GstAppSinkPrivate *priv;
   GstSample *sample = NULL;
-  gboolean timeout_valid;
+  gboolean timeout_valid, woken;
   gint64 end_time;
 
   g_return_val_if_fail (GST_IS_APP_SINK (appsink), NULL);
@@ -1468,12 +1502,16 @@ gst_app_sink_try_pull_preroll (GstAppSink * appsink, GstClockTime timeout)
 
     /* nothing to return, wait */
     GST_DEBUG_OBJECT (appsink, "waiting for the preroll buffer");
+    priv->app_waiting++;
     if (timeout_valid) {
-      if (!g_cond_wait_until (&priv->cond, &priv->mutex, end_time))
-        goto expired;
+      woken = g_cond_wait_until (&priv->cond, &priv->mutex, end_time);
     } else {
       g_cond_wait (&priv->cond, &priv->mutex);
+      woken = TRUE;
     }
+    priv->app_waiting--;
+    if (!woken)
+      goto expired;
   }
   sample =
       gst_sample_new (priv->preroll, priv->preroll_caps, &priv->preroll_segment,
@@ -1532,8 +1570,7 @@ gst_app_sink_try_pull_sample (GstAppSink * appsink, GstClockTime timeout)
 {
   GstAppSinkPrivate *priv;
   GstSample *sample = NULL;
-  GstMiniObject *obj;
-  gboolean timeout_valid;
+  gboolean timeout_valid, woken;
   gint64 end_time;
 
   g_return_val_if_fail (GST_IS_APP_SINK (appsink), NULL);
@@ -1561,27 +1598,22 @@ gst_app_sink_try_pull_sample (GstAppSink * appsink, GstClockTime timeout)
 
     /* nothing to return, wait */
     GST_DEBUG_OBJECT (appsink, "waiting for a buffer");
+    priv->app_waiting++;
     if (timeout_valid) {
-      if (!g_cond_wait_until (&priv->cond, &priv->mutex, end_time))
-        goto expired;
+      woken = g_cond_wait_until (&priv->cond, &priv->mutex, end_time);
     } else {
       g_cond_wait (&priv->cond, &priv->mutex);
+      woken = TRUE;
     }
+    priv->app_waiting--;
+    if (!woken)
+      goto expired;
   }
 
-  obj = dequeue_buffer (appsink);
-  if (GST_IS_BUFFER (obj)) {
-    GST_DEBUG_OBJECT (appsink, "we have a buffer %p", obj);
-    sample = gst_sample_new (GST_BUFFER_CAST (obj), priv->last_caps,
-        &priv->last_segment, NULL);
-  } else {
-    GST_DEBUG_OBJECT (appsink, "we have a list %p", obj);
-    sample = gst_sample_new (NULL, priv->last_caps, &priv->last_segment, NULL);
-    gst_sample_set_buffer_list (sample, GST_BUFFER_LIST_CAST (obj));
-  }
-  gst_mini_object_unref (obj);
+  sample = dequeue_sample (appsink);
 
-  g_cond_signal (&priv->cond);
+  if (priv->stream_waiting)
+    g_cond_signal (&priv->cond);
   g_mutex_unlock (&priv->mutex);
 
   return sample;
@@ -1607,6 +1639,115 @@ not_started:
   }
 }
 
+/**
+ * gst_app_sink_pull_samples:
+ * @appsink: a #GstAppSink
+ * @max: the maximum number of samples to return, 0 for all queued samples
+ * @timeout: the maximum amount of time to wait for the first sample
+ *
+ * This function blocks until at least one sample or EOS becomes available or
+ * the appsink element is set to the READY/NULL state or the timeout expires.
+ * It then takes up to @max queued samples at once, without waiting for more.
+ *
+ * This is equivalent to calling gst_app_sink_try_pull_sample() until the
+ * queue is empty, but the samples are dequeued with a single lock and wakeup
+ * of the streaming thread.
+ *
+ * If an EOS event was received before any buffers or the timeout expires,
+ * this function returns %NULL. Use gst_app_sink_is_eos () to check for the EOS
+ * condition.
+ *
+ * Returns: (transfer full) (element-type GstSample) (nullable): an array of
+ * #GstSample or %NULL when the appsink is stopped or EOS or the timeout
+ * expires. Call g_ptr_array_unref() after usage.
+ *
+ * Since: 1.14
+ */
+GPtrArray *
+gst_app_sink_pull_samples (GstAppSink * appsink, guint max,
+    GstClockTime timeout)
+{
+  GstAppSinkPrivate *priv;
+  GPtrArray *samples;
+  gboolean timeout_valid, woken;
+  gint64 end_time;
+  guint n_samples;
+
+  g_return_val_if_fail (GST_IS_APP_SINK (appsink), NULL);
+
+  timeout_valid = GST_CLOCK_TIME_IS_VALID (timeout);
+
+  if (timeout_valid)
+    end_time =
+        g_get_monotonic_time () + timeout / (GST_SECOND / G_TIME_SPAN_SECOND);
+
+  priv = appsink->priv;
+
+  g_mutex_lock (&priv->mutex);
+
+  while (TRUE) {
+    GST_DEBUG_OBJECT (appsink, "trying to grab buffers");
+    if (!priv->started)
+      goto not_started;
+
+    if (priv->num_buffers > 0)
+      break;
+
+    if (priv->is_eos)
+      goto eos;
+
+    /* nothing to return, wait */
+    GST_DEBUG_OBJECT (appsink, "waiting for a buffer");
+    priv->app_waiting++;
+    if (timeout_valid) {
+      woken = g_cond_wait_until (&priv->cond, &priv->mutex, end_time);
+    } else {
+      g_cond_wait (&priv->cond, &priv->mutex);
+      woken = TRUE;
+    }
+    priv->app_waiting--;
+    if (!woken)
+      goto expired;
+  }
+
+  n_samples = priv->num_buffers;
+  if (max > 0 && max < n_samples)
+    n_samples = max;
+
+  samples = g_ptr_array_new_full (n_samples,
+      (GDestroyNotify) gst_sample_unref);
+  while (samples->len < n_samples)
+    g_ptr_array_add (samples, dequeue_sample (appsink));
+
+  GST_DEBUG_OBJECT (appsink, "dequeued %u samples", n_samples);
+
+  if (priv->stream_waiting)
+    g_cond_signal (&priv->cond);
+  g_mutex_unlock (&priv->mutex);
+
+  return samples;
+
+  /* special conditions */
+expired:
+  {
+    GST_DEBUG_OBJECT (appsink, "timeout expired, return NULL");
+    g_mutex_unlock (&priv->mutex);
+    return NULL;
+  }
+eos:
+  {
+    GST_DEBUG_OBJECT (appsink, "we are EOS, return NULL");
+    g_mutex_unlock (&priv->mutex);
+    return NULL;
+  }
+not_started:
+  {
+    GST_DEBUG_OBJECT (appsink, "we are stopped, return NULL");
+    g_mutex_unlock (&priv->mutex);
+    return NULL;
+  }
+}
+
 /**
  * gst_app_sink_set_callbacks: (skip)
  * @appsink: a #GstAppSink
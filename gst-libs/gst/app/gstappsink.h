@@ -155,6 +155,10 @@ GstSample *     gst_app_sink_try_pull_preroll (GstAppSink *appsink, GstClockTime
 GST_EXPORT
 GstSample *     gst_app_sink_try_pull_sample  (GstAppSink *appsink, GstClockTime timeout);
 
+GST_EXPORT
+GPtrArray *     gst_app_sink_pull_samples     (GstAppSink *appsink, guint max,
+                                               GstClockTime timeout);
+
 GST_EXPORT
 void            gst_app_sink_set_callbacks    (GstAppSink * appsink,
                                                GstAppSinkCallbacks *callbacks,
@@ -96,6 +96,7 @@
 
 #include <gst/gst.h>
 #include <gst/base/gstbasesrc.h>
+#include <gst/base/gstqueuearray.h>
 
 #include <string.h>
 
@@ -105,7 +106,11 @@ struct _GstAppSrcPrivate
 {
   GCond cond;
   GMutex mutex;
-  GQueue *queue;
+  GstQueueArray *queue;
+  /* number of application and streaming threads waiting on cond, so that
+   * queueing and dequeueing only signal when someone is waiting */
+  guint app_waiting;
+  guint stream_waiting;
 
   GstCaps *last_caps;
   GstCaps *current_caps;
@@ -543,7 +548,7 @@ gst_app_src_init (GstAppSrc * appsrc)
 
   g_mutex_init (&priv->mutex);
   g_cond_init (&priv->cond);
-  priv->queue = g_queue_new ();
+  priv->queue = gst_queue_array_new (16);
 
   priv->size = DEFAULT_PROP_SIZE;
   priv->duration = DEFAULT_PROP_DURATION;
@@ -567,8 +572,8 @@ gst_app_src_flush_queued (GstAppSrc * src, gboolean retain_last_caps)
   GstAppSrcPrivate *priv = src->priv;
   GstCaps *requeue_caps = NULL;
 
-  while (!g_queue_is_empty (priv->queue)) {
-    obj = g_queue_pop_head (priv->queue);
+  while (!gst_queue_array_is_empty (priv->queue)) {
+    obj = gst_queue_array_pop_head (priv->queue);
     if (obj) {
       if (GST_IS_CAPS (obj) && retain_last_caps) {
         gst_caps_replace (&requeue_caps, GST_CAPS_CAST (obj));
@@ -578,7 +583,7 @@ gst_app_src_flush_queued (GstAppSrc * src, gboolean retain_last_caps)
   }
 
   if (requeue_caps) {
-    g_queue_push_tail (priv->queue, requeue_caps);
+    gst_queue_array_push_tail (priv->queue, requeue_caps);
   }
 
   priv->queued_bytes = 0;
@@ -622,7 +627,7 @@ gst_app_src_finalize (GObject * obj)
 
   g_mutex_clear (&priv->mutex);
   g_cond_clear (&priv->cond);
-  g_queue_free (priv->queue);
+  gst_queue_array_free (priv->queue);
 
   g_free (priv->uri);
 
@@ -1144,9 +1149,9 @@ gst_app_src_create (GstBaseSrc * bsrc, guint64 offset, guint size,
 
   while (TRUE) {
     /* return data as long as we have some */
-    if (!g_queue_is_empty (priv->queue)) {
+    if (!gst_queue_array_is_empty (priv->queue)) {
       guint buf_size;
-      GstMiniObject *obj = g_queue_pop_head (priv->queue);
+      GstMiniObject *obj = gst_queue_array_pop_head (priv->queue);
 
       if (!GST_IS_BUFFER (obj)) {
         GstCaps *next_caps = GST_CAPS (obj);
@@ -1189,7 +1194,8 @@ gst_app_src_create (GstBaseSrc * bsrc, guint64 offset, guint size,
         priv->offset += buf_size;
 
       /* signal that we removed an item */
-      g_cond_broadcast (&priv->cond);
+      if (priv->app_waiting)
+        g_cond_broadcast (&priv->cond);
 
       /* see if we go lower than the empty-percent */
       if (priv->min_percent && priv->max_bytes) {
@@ -1212,7 +1218,7 @@ gst_app_src_create (GstBaseSrc * bsrc, guint64 offset, guint size,
        * signal) we can still be empty because the pushed buffer got flushed or
        * when the application pushes the requested buffer later, we support both
        * possibilities. */
-      if (!g_queue_is_empty (priv->queue))
+      if (!gst_queue_array_is_empty (priv->queue))
         continue;
 
       /* no buffer yet, maybe we are EOS, if not, block for more data. */
@@ -1223,7 +1229,9 @@ gst_app_src_create (GstBaseSrc * bsrc, guint64 offset, guint size,
       goto eos;
 
     /* nothing to return, wait a while for new data or flushing. */
+    priv->stream_waiting++;
     g_cond_wait (&priv->cond, &priv->mutex);
+    priv->stream_waiting--;
   }
   g_mutex_unlock (&priv->mutex);
   return ret;
@@ -1284,10 +1292,11 @@ gst_app_src_set_caps (GstAppSrc * appsrc, const GstCaps * caps)
     GstCaps *new_caps;
     new_caps = caps ? gst_caps_copy (caps) : NULL;
     GST_DEBUG_OBJECT (appsrc, "setting caps to %" GST_PTR_FORMAT, caps);
-    if (priv->queue->tail != NULL && GST_IS_CAPS (priv->queue->tail->data)) {
-      gst_caps_unref (g_queue_pop_tail (priv->queue));
+    if (!gst_queue_array_is_empty (priv->queue)
+        && GST_IS_CAPS (gst_queue_array_peek_tail (priv->queue))) {
+      gst_caps_unref (gst_queue_array_pop_tail (priv->queue));
     }
-    g_queue_push_tail (priv->queue, new_caps);
+    gst_queue_array_push_tail (priv->queue, new_caps);
     gst_caps_replace (&priv->last_caps, new_caps);
   }
 
@@ -1676,61 +1685,51 @@ gst_app_src_get_emit_signals (GstAppSrc * appsrc)
   return result;
 }
 
-static GstFlowReturn
-gst_app_src_push_buffer_full (GstAppSrc * appsrc, GstBuffer * buffer,
-    gboolean steal_ref)
+/* get the running time to put on buffers without timestamps when
+ * do-timestamp is enabled. Returns FALSE when there is no clock yet. */
+static gboolean
+gst_app_src_get_timestamp_now (GstAppSrc * appsrc, GstClockTime * now)
 {
-  gboolean first = TRUE;
-  GstAppSrcPrivate *priv;
-
-  g_return_val_if_fail (GST_IS_APP_SRC (appsrc), GST_FLOW_ERROR);
-  g_return_val_if_fail (GST_IS_BUFFER (buffer), GST_FLOW_ERROR);
-
-  priv = appsrc->priv;
-
-  if (GST_BUFFER_DTS (buffer) == GST_CLOCK_TIME_NONE &&
-      GST_BUFFER_PTS (buffer) == GST_CLOCK_TIME_NONE &&
-      gst_base_src_get_do_timestamp (GST_BASE_SRC_CAST (appsrc))) {
-    GstClock *clock;
-
-    clock = gst_element_get_clock (GST_ELEMENT_CAST (appsrc));
-    if (clock) {
-      GstClockTime now;
-      GstClockTime base_time =
-          gst_element_get_base_time (GST_ELEMENT_CAST (appsrc));
+  GstClock *clock;
+  GstClockTime base_time;
+
+  clock = gst_element_get_clock (GST_ELEMENT_CAST (appsrc));
+  if (!clock) {
+    GST_WARNING_OBJECT (appsrc,
+        "do-timestamp=TRUE but buffers are provided before "
+        "reaching the PLAYING state and having a clock. Timestamps will "
+        "not be accurate!");
+    return FALSE;
+  }
 
-      now = gst_clock_get_time (clock);
-      if (now > base_time)
-        now -= base_time;
-      else
-        now = 0;
-      gst_object_unref (clock);
+  base_time = gst_element_get_base_time (GST_ELEMENT_CAST (appsrc));
 
-      if (!steal_ref)
-        buffer = gst_buffer_copy (buffer);
-      else
-        buffer = gst_buffer_make_writable (buffer);
+  *now = gst_clock_get_time (clock);
+  if (*now > base_time)
+    *now -= base_time;
+  else
+    *now = 0;
+  gst_object_unref (clock);
 
-      GST_BUFFER_PTS (buffer) = now;
-      GST_BUFFER_DTS (buffer) = now;
-      steal_ref = TRUE;
-    } else {
-      GST_WARNING_OBJECT (appsrc,
-          "do-timestamp=TRUE but buffers are provided before "
-          "reaching the PLAYING state and having a clock. Timestamps will "
-          "not be accurate!");
-    }
-  }
+  return TRUE;
+}
 
-  g_mutex_lock (&priv->mutex);
+/* must be called with the appsrc mutex. Waits until there is space in the
+ * queue for more data when blocking, the mutex is released while emitting
+ * enough-data. */
+static GstFlowReturn
+gst_app_src_wait_for_space (GstAppSrc * appsrc)
+{
+  GstAppSrcPrivate *priv = appsrc->priv;
+  gboolean first = TRUE;
 
   while (TRUE) {
     /* can't accept buffers when we are flushing or EOS */
     if (priv->flushing)
-      goto flushing;
+      return GST_FLOW_FLUSHING;
 
     if (priv->is_eos)
-      goto eos;
+      return GST_FLOW_EOS;
 
     if (priv->max_bytes && priv->queued_bytes >= priv->max_bytes) {
       GST_DEBUG_OBJECT (appsrc,
@@ -1759,7 +1758,9 @@ gst_app_src_push_buffer_full (GstAppSrc * appsrc, GstBuffer * buffer,
         GST_DEBUG_OBJECT (appsrc, "waiting for free space");
         /* we are filled, wait until a buffer gets popped or when we
          * flush. */
+        priv->app_waiting++;
         g_cond_wait (&priv->cond, &priv->mutex);
+        priv->app_waiting--;
       } else {
         /* no need to wait for free space, we just pump more data into the
          * queue hoping that the caller reacts to the enough-data signal and
@@ -1769,34 +1770,91 @@ gst_app_src_push_buffer_full (GstAppSrc * appsrc, GstBuffer * buffer,
     } else
       break;
   }
+  return GST_FLOW_OK;
+}
+
+static GstFlowReturn
+gst_app_src_push_buffer_full (GstAppSrc * appsrc, GstBuffer * buffer,
+    gboolean steal_ref)
+{
+  GstAppSrcPrivate *priv;
+  GstFlowReturn ret;
+
+  g_return_val_if_fail (GST_IS_APP_SRC (appsrc), GST_FLOW_ERROR);
+  g_return_val_if_fail (GST_IS_BUFFER (buffer), GST_FLOW_ERROR);
+
+  priv = appsrc->priv;
+
+  if (GST_BUFFER_DTS (buffer) == GST_CLOCK_TIME_NONE &&
+      GST_BUFFER_PTS (buffer) == GST_CLOCK_TIME_NONE &&
+      gst_base_src_get_do_timestamp (GST_BASE_SRC_CAST (appsrc))) {
+    GstClockTime now;
+
+    if (gst_app_src_get_timestamp_now (appsrc, &now)) {
+      if (!steal_ref)
+        buffer = gst_buffer_copy (buffer);
+      else
+        buffer = gst_buffer_make_writable (buffer);
+
+      GST_BUFFER_PTS (buffer) = now;
+      GST_BUFFER_DTS (buffer) = now;
+      steal_ref = TRUE;
+    }
+  }
+
+  g_mutex_lock (&priv->mutex);
+
+  ret = gst_app_src_wait_for_space (appsrc);
+  if (G_UNLIKELY (ret != GST_FLOW_OK))
+    goto refused;
 
   GST_DEBUG_OBJECT (appsrc, "queueing buffer %p", buffer);
   if (!steal_ref)
     gst_buffer_ref (buffer);
-  g_queue_push_tail (priv->queue, buffer);
+  gst_queue_array_push_tail (priv->queue, buffer);
   priv->queued_bytes += gst_buffer_get_size (buffer);
-  g_cond_broadcast (&priv->cond);
+  if (priv->stream_waiting)
+    g_cond_broadcast (&priv->cond);
   g_mutex_unlock (&priv->mutex);
 
   return GST_FLOW_OK;
 
   /* ERRORS */
-flushing:
+refused:
   {
-    GST_DEBUG_OBJECT (appsrc, "refuse buffer %p, we are flushing", buffer);
+    GST_DEBUG_OBJECT (appsrc, "refuse buffer %p, %s", buffer,
+        gst_flow_get_name (ret));
     if (steal_ref)
       gst_buffer_unref (buffer);
     g_mutex_unlock (&priv->mutex);
-    return GST_FLOW_FLUSHING;
+    return ret;
   }
-eos:
-  {
-    GST_DEBUG_OBJECT (appsrc, "refuse buffer %p, we are EOS", buffer);
-    if (steal_ref)
-      gst_buffer_unref (buffer);
-    g_mutex_unlock (&priv->mutex);
-    return GST_FLOW_EOS;
+}
+
+static gboolean
+queue_list_buffer (GstBuffer ** buffer, guint idx, gpointer user_data)
+{
+  GstAppSrc *appsrc = user_data;
+  GstAppSrcPrivate *priv = appsrc->priv;
+
+  gst_queue_array_push_tail (priv->queue, gst_buffer_ref (*buffer));
+  priv->queued_bytes += gst_buffer_get_size (*buffer);
+
+  return TRUE;
+}
+
+static gboolean
+timestamp_list_buffer (GstBuffer ** buffer, guint idx, gpointer user_data)
+{
+  GstClockTime *now = user_data;
+
+  if (GST_BUFFER_DTS (*buffer) == GST_CLOCK_TIME_NONE &&
+      GST_BUFFER_PTS (*buffer) == GST_CLOCK_TIME_NONE) {
+    *buffer = gst_buffer_make_writable (*buffer);
+    GST_BUFFER_PTS (*buffer) = *now;
+    GST_BUFFER_DTS (*buffer) = *now;
   }
+  return TRUE;
 }
 
 static GstFlowReturn
@@ -1844,6 +1902,77 @@ gst_app_src_push_buffer (GstAppSrc * appsrc, GstBuffer * buffer)
   return gst_app_src_push_buffer_full (appsrc, buffer, TRUE);
 }
 
+/**
+ * gst_app_src_push_buffer_list:
+ * @appsrc: a #GstAppSrc
+ * @buffer_list: (transfer full): a #GstBufferList to push
+ *
+ * Adds all buffers of @buffer_list to the queue of buffers that the appsrc
+ * element will push to its source pad. This function takes ownership of
+ * @buffer_list.
+ *
+ * This is equivalent to calling gst_app_src_push_buffer() for each buffer in
+ * the list, but the buffers are queued with a single lock and wakeup of the
+ * streaming thread. The whole list is queued at once, so the queue can
+ * exceed the max-bytes property by the size of the list.
+ *
+ * When the block property is TRUE, this function can block until free
+ * space becomes available in the queue.
+ *
+ * Returns: #GST_FLOW_OK when the buffers were successfuly queued.
+ * #GST_FLOW_FLUSHING when @appsrc is not PAUSED or PLAYING.
+ * #GST_FLOW_EOS when EOS occured.
+ *
+ * Since: 1.14
+ */
+GstFlowReturn
+gst_app_src_push_buffer_list (GstAppSrc * appsrc, GstBufferList * buffer_list)
+{
+  GstAppSrcPrivate *priv;
+  GstFlowReturn ret;
+
+  g_return_val_if_fail (GST_IS_APP_SRC (appsrc), GST_FLOW_ERROR);
+  g_return_val_if_fail (GST_IS_BUFFER_LIST (buffer_list), GST_FLOW_ERROR);
+
+  priv = appsrc->priv;
+
+  if (gst_base_src_get_do_timestamp (GST_BASE_SRC_CAST (appsrc))) {
+    GstClockTime now;
+
+    if (gst_app_src_get_timestamp_now (appsrc, &now)) {
+      buffer_list = gst_buffer_list_make_writable (buffer_list);
+      gst_buffer_list_foreach (buffer_list, timestamp_list_buffer, &now);
+    }
+  }
+
+  g_mutex_lock (&priv->mutex);
+
+  ret = gst_app_src_wait_for_space (appsrc);
+  if (G_UNLIKELY (ret != GST_FLOW_OK))
+    goto refused;
+
+  GST_DEBUG_OBJECT (appsrc, "queueing buffer list %p of %u buffers",
+      buffer_list, gst_buffer_list_length (buffer_list));
+  gst_buffer_list_foreach (buffer_list, queue_list_buffer, appsrc);
+  if (priv->stream_waiting)
+    g_cond_broadcast (&priv->cond);
+  g_mutex_unlock (&priv->mutex);
+
+  gst_buffer_list_unref (buffer_list);
+
+  return GST_FLOW_OK;
+
+  /* ERRORS */
+refused:
+  {
+    GST_DEBUG_OBJECT (appsrc, "refuse buffer list %p, %s", buffer_list,
+        gst_flow_get_name (ret));
+    g_mutex_unlock (&priv->mutex);
+    gst_buffer_list_unref (buffer_list);
+    return ret;
+  }
+}
+
 /**
  * gst_app_src_push_sample:
  * @appsrc: a #GstAppSrc
@@ -167,6 +167,9 @@ gboolean         gst_app_src_get_emit_signals        (GstAppSrc *appsrc);
 GST_EXPORT
 GstFlowReturn    gst_app_src_push_buffer             (GstAppSrc *appsrc, GstBuffer *buffer);
 
+GST_EXPORT
+GstFlowReturn    gst_app_src_push_buffer_list        (GstAppSrc *appsrc, GstBufferList *buffer_list);
+
 GST_EXPORT
 GstFlowReturn    gst_app_src_end_of_stream           (GstAppSrc *appsrc);
 
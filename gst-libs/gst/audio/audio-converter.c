@@ -68,7 +68,11 @@ ensure_debug_category (void)
 #define ensure_debug_category() /* NOOP */
 #endif /* GST_DISABLE_GST_DEBUG */
 
+#include "gst/parallelized-task-private.h"
+
 typedef struct _AudioChain AudioChain;
+typedef struct _AudioMixTask AudioMixTask;
+typedef struct _AudioResampleTask AudioResampleTask;
 
 typedef void (*AudioConvertFunc) (gpointer dst, const gpointer src, gint count);
 typedef gboolean (*AudioConvertSamplesFunc) (GstAudioConverter * convert,
@@ -118,12 +122,19 @@ struct _GstAudioConverter
   /* convert in */
   AudioConvertFunc convert_in;
 
+  /* threads for mixing and resampling, NULL when single threaded */
+  GstParallelizedTaskRunner *runner;
+
   /* channel mix */
   gboolean mix_passthrough;
   GstAudioChannelMixer *mix;
+  AudioMixTask *mix_tasks;
+  gpointer *mix_tasks_p;
 
   /* resample */
-  GstAudioResampler *resampler;
+  GstAudioResampler *resampler; /* resampler of the first task when threaded */
+  AudioResampleTask *resample_tasks;
+  gpointer *resample_tasks_p;
 
   /* convert out */
   AudioConvertFunc convert_out;
@@ -242,7 +253,6 @@ audio_chain_get_samples (AudioChain * chain, gsize * avail)
   return res;
 }
 
-/*
 static guint
 get_opt_uint (GstAudioConverter * convert, const gchar * opt, guint def)
 {
@@ -251,7 +261,6 @@ get_opt_uint (GstAudioConverter * convert, const gchar * opt, guint def)
     res = def;
   return res;
 }
-*/
 
 static gint
 get_opt_enum (GstAudioConverter * convert, const gchar * opt, GType type,
@@ -267,6 +276,7 @@ get_opt_enum (GstAudioConverter * convert, const gchar * opt, GType type,
 #define DEFAULT_OPT_DITHER_METHOD GST_AUDIO_DITHER_NONE
 #define DEFAULT_OPT_NOISE_SHAPING_METHOD GST_AUDIO_NOISE_SHAPING_NONE
 #define DEFAULT_OPT_QUANTIZATION 1
+#define DEFAULT_OPT_THREADS 1
 
 #define GET_OPT_RESAMPLER_METHOD(c) get_opt_enum(c, \
     GST_AUDIO_CONVERTER_OPT_RESAMPLER_METHOD, GST_TYPE_AUDIO_RESAMPLER_METHOD, \
@@ -279,6 +289,8 @@ get_opt_enum (GstAudioConverter * convert, const gchar * opt, GType type,
     DEFAULT_OPT_NOISE_SHAPING_METHOD)
 #define GET_OPT_QUANTIZATION(c) get_opt_uint(c, \
     GST_AUDIO_CONVERTER_OPT_QUANTIZATION, DEFAULT_OPT_QUANTIZATION)
+#define GET_OPT_THREADS(c) get_opt_uint(c, \
+    GST_AUDIO_CONVERTER_OPT_THREADS, DEFAULT_OPT_THREADS)
 
 static gboolean
 copy_config (GQuark field_id, const GValue * value, gpointer user_data)
@@ -332,7 +344,13 @@ gst_audio_converter_update_config (GstAudioConverter * convert,
   convert->in.rate = in_rate;
   convert->out.rate = out_rate;
 
-  if (convert->resampler)
+  if (convert->resample_tasks) {
+    gint i;
+
+    for (i = 0; i < convert->runner->n_threads; i++)
+      gst_audio_resampler_update (convert->resample_tasks[i].resampler,
+          in_rate, out_rate, config);
+  } else if (convert->resampler)
     gst_audio_resampler_update (convert->resampler, in_rate, out_rate, config);
 
   if (config) {
@@ -410,6 +428,212 @@ get_temp_samples (AudioChain * chain, gsize num_samples, gpointer user_data)
   return chain->tmp;
 }
 
+/* below this many frames per thread, mixing is done in the calling thread */
+#define MIN_MIX_FRAMES_PER_THREAD 256
+
+struct _AudioMixTask
+{
+  GstAudioChannelMixer *mix;
+  gint in_bpf;
+  gint out_bpf;
+
+  /* set for each run */
+  gpointer in;
+  gpointer out;
+  gint samples;
+};
+
+static void
+audio_mix_task (AudioMixTask * task)
+{
+  gst_audio_channel_mixer_samples (task->mix, &task->in, &task->out,
+      task->samples);
+}
+
+static void
+mix_samples (GstAudioConverter * convert, gpointer in[], gpointer out[],
+    gsize num_samples)
+{
+  gint i, n_threads;
+  gsize offset, frames_per_thread;
+
+  if (convert->mix_tasks == NULL
+      || num_samples < convert->runner->n_threads * MIN_MIX_FRAMES_PER_THREAD) {
+    gst_audio_channel_mixer_samples (convert->mix, in, out, num_samples);
+    return;
+  }
+
+  /* the mixer works frame by frame, give each thread a range of frames of
+   * the interleaved samples */
+  n_threads = convert->runner->n_threads;
+  frames_per_thread = (num_samples + n_threads - 1) / n_threads;
+
+  for (i = 0, offset = 0; i < n_threads; i++) {
+    AudioMixTask *task = &convert->mix_tasks[i];
+    gsize frames = MIN (frames_per_thread, num_samples - offset);
+
+    task->in = (guint8 *) in[0] + offset * task->in_bpf;
+    task->out = (guint8 *) out[0] + offset * task->out_bpf;
+    task->samples = frames;
+    offset += frames;
+  }
+
+  gst_parallelized_task_runner_run (convert->runner,
+      (GstParallelizedTaskFunc) audio_mix_task, convert->mix_tasks_p);
+}
+
+/* Each resample task owns a resampler for a contiguous range of channels. It
+ * picks its channels out of the interleaved input, resamples them
+ * non-interleaved and interleaves the result back into the output. Tasks only
+ * touch their own channels so they can run concurrently. */
+struct _AudioResampleTask
+{
+  GstAudioResampler *resampler;
+  gint bps;
+  gint channels;
+  gint first_channel;
+  gint n_channels;
+
+  gpointer *in_planes;
+  gsize in_allocated;
+  gpointer *out_planes;
+  gsize out_allocated;
+
+  /* set for each run */
+  gpointer in;
+  gsize in_frames;
+  gpointer out;
+  gsize out_frames;
+};
+
+static void
+ensure_planes (gpointer ** planes, gsize * allocated, gint n_planes,
+    gsize frames, gint bps)
+{
+  gint i;
+  gint8 *s;
+  gsize stride;
+
+  if (frames <= *allocated)
+    return;
+
+  stride = GST_ROUND_UP_N (frames * bps, ALIGN);
+  /* first part contains the pointers, second part the aligned data */
+  *planes = g_realloc (*planes,
+      (stride + sizeof (gpointer)) * n_planes + ALIGN - 1);
+  *allocated = frames;
+
+  s = MEM_ALIGN (&(*planes)[n_planes], ALIGN);
+  for (i = 0; i < n_planes; i++)
+    (*planes)[i] = s + i * stride;
+}
+
+#define MAKE_SPLIT_FUNCS(type)                                          \
+static void                                                             \
+deinterleave_ ##type (gpointer planes[], const gpointer in,             \
+    gint first, gint n_channels, gint channels, gsize frames)           \
+{                                                                       \
+  gint c;                                                               \
+  gsize i;                                                              \
+  for (c = 0; c < n_channels; c++) {                                    \
+    type *d = planes[c];                                                \
+    const type *s = (const type *) in + first + c;                      \
+    for (i = 0; i < frames; i++, s += channels)                         \
+      d[i] = *s;                                                        \
+  }                                                                     \
+}                                                                       \
+static void                                                             \
+interleave_ ##type (gpointer out, gpointer planes[],                    \
+    gint first, gint n_channels, gint channels, gsize frames)           \
+{                                                                       \
+  gint c;                                                               \
+  gsize i;                                                              \
+  for (c = 0; c < n_channels; c++) {                                    \
+    const type *s = planes[c];                                          \
+    type *d = (type *) out + first + c;                                 \
+    for (i = 0; i < frames; i++, d += channels)                         \
+      *d = s[i];                                                        \
+  }                                                                     \
+}
+
+MAKE_SPLIT_FUNCS (guint16);
+MAKE_SPLIT_FUNCS (guint32);
+MAKE_SPLIT_FUNCS (guint64);
+
+static void
+audio_resample_task (AudioResampleTask * task)
+{
+  ensure_planes (&task->in_planes, &task->in_allocated, task->n_channels,
+      task->in_frames, task->bps);
+  ensure_planes (&task->out_planes, &task->out_allocated, task->n_channels,
+      task->out_frames, task->bps);
+
+  if (task->in) {
+    switch (task->bps) {
+      case 2:
+        deinterleave_guint16 (task->in_planes, task->in, task->first_channel,
+            task->n_channels, task->channels, task->in_frames);
+        break;
+      case 4:
+        deinterleave_guint32 (task->in_planes, task->in, task->first_channel,
+            task->n_channels, task->channels, task->in_frames);
+        break;
+      case 8:
+        deinterleave_guint64 (task->in_planes, task->in, task->first_channel,
+            task->n_channels, task->channels, task->in_frames);
+        break;
+      default:
+        g_assert_not_reached ();
+    }
+  }
+
+  gst_audio_resampler_resample (task->resampler,
+      task->in ? task->in_planes : NULL, task->in_frames, task->out_planes,
+      task->out_frames);
+
+  switch (task->bps) {
+    case 2:
+      interleave_guint16 (task->out, task->out_planes, task->first_channel,
+          task->n_channels, task->channels, task->out_frames);
+      break;
+    case 4:
+      interleave_guint32 (task->out, task->out_planes, task->first_channel,
+          task->n_channels, task->channels, task->out_frames);
+      break;
+    case 8:
+      interleave_guint64 (task->out, task->out_planes, task->first_channel,
+          task->n_channels, task->channels, task->out_frames);
+      break;
+    default:
+      g_assert_not_reached ();
+  }
+}
+
+static void
+resample_samples (GstAudioConverter * convert, gpointer in[], gsize in_frames,
+    gpointer out[], gsize out_frames)
+{
+  gint i;
+
+  if (convert->resample_tasks == NULL) {
+    gst_audio_resampler_resample (convert->resampler, in, in_frames, out,
+        out_frames);
+    return;
+  }
+
+  for (i = 0; i < convert->runner->n_threads; i++) {
+    AudioResampleTask *task = &convert->resample_tasks[i];
+
+    task->in = in ? in[0] : NULL;
+    task->in_frames = in_frames;
+    task->out = out[0];
+    task->out_frames = out_frames;
+  }
+
+  gst_parallelized_task_runner_run (convert->runner,
+      (GstParallelizedTaskFunc) audio_resample_task, convert->resample_tasks_p);
+}
+
 static gboolean
 do_unpack (AudioChain * chain, gpointer user_data)
 {
@@ -492,7 +716,7 @@ do_mix (AudioChain * chain, gpointer user_data)
   out = (chain->allow_ip ? in : audio_chain_alloc_samples (chain, num_samples));
   GST_LOG ("mix %p, %p, %" G_GSIZE_FORMAT, in, out, num_samples);
 
-  gst_audio_channel_mixer_samples (convert->mix, in, out, num_samples);
+  mix_samples (convert, in, out, num_samples);
 
   audio_chain_set_samples (chain, out, num_samples);
 
@@ -513,8 +737,7 @@ do_resample (AudioChain * chain, gpointer user_data)
   GST_LOG ("resample %p %p,%" G_GSIZE_FORMAT " %" G_GSIZE_FORMAT, in,
       out, in_frames, out_frames);
 
-  gst_audio_resampler_resample (convert->resampler, in, in_frames, out,
-      out_frames);
+  resample_samples (convert, in, in_frames, out, out_frames);
 
   audio_chain_set_samples (chain, out, out_frames);
 
@@ -651,6 +874,20 @@ chain_mix (GstAudioConverter * convert, AudioChain * prev)
       in->channels, out->channels);
 
   if (!convert->mix_passthrough) {
+    if (convert->runner) {
+      gint i, n_threads = convert->runner->n_threads;
+      gint bps = gst_audio_format_get_info (format)->width / 8;
+
+      convert->mix_tasks = g_new0 (AudioMixTask, n_threads);
+      convert->mix_tasks_p = g_new0 (gpointer, n_threads);
+      for (i = 0; i < n_threads; i++) {
+        convert->mix_tasks[i].mix = convert->mix;
+        convert->mix_tasks[i].in_bpf = in->channels * bps;
+        convert->mix_tasks[i].out_bpf = out->channels * bps;
+        convert->mix_tasks_p[i] = &convert->mix_tasks[i];
+      }
+    }
+
     prev = audio_chain_new (prev, convert);
     prev->allow_ip = FALSE;
     prev->pass_alloc = FALSE;
@@ -683,9 +920,40 @@ chain_resample (GstAudioConverter * convert, AudioChain * prev)
     if (variable_rate)
       flags |= GST_AUDIO_RESAMPLER_FLAG_VARIABLE_RATE;
 
-    convert->resampler =
-        gst_audio_resampler_new (method, flags, format, channels, in->rate,
-        out->rate, convert->config);
+    if (convert->runner) {
+      gint i, first, n_threads = convert->runner->n_threads;
+      gint bps = gst_audio_format_get_info (format)->width / 8;
+
+      /* split the channels over the threads, the layout is always
+       * interleaved here, each task resamples its channels non-interleaved */
+      flags |= GST_AUDIO_RESAMPLER_FLAG_NON_INTERLEAVED_IN;
+      flags |= GST_AUDIO_RESAMPLER_FLAG_NON_INTERLEAVED_OUT;
+
+      convert->resample_tasks = g_new0 (AudioResampleTask, n_threads);
+      convert->resample_tasks_p = g_new0 (gpointer, n_threads);
+      for (i = 0, first = 0; i < n_threads; i++) {
+        AudioResampleTask *task = &convert->resample_tasks[i];
+
+        task->bps = bps;
+        task->channels = channels;
+        task->first_channel = first;
+        task->n_channels = channels / n_threads
+            + (i < channels % n_threads ? 1 : 0);
+        first += task->n_channels;
+
+        task->resampler =
+            gst_audio_resampler_new (method, flags, format, task->n_channels,
+            in->rate, out->rate, convert->config);
+        convert->resample_tasks_p[i] = task;
+      }
+      convert->resampler = convert->resample_tasks[0].resampler;
+
+      GST_INFO ("resampling %d channels with %d threads", channels, n_threads);
+    } else {
+      convert->resampler =
+          gst_audio_resampler_new (method, flags, format, channels, in->rate,
+          out->rate, convert->config);
+    }
 
     prev = audio_chain_new (prev, convert);
     prev->allow_ip = FALSE;
@@ -1018,6 +1286,12 @@ converter_generic (GstAudioConverter * convert,
 
   chain = convert->chain_end;
 
+  /* in-place conversion, the input is our output so we can write to it */
+  if (in && in[0] == out[0]) {
+    g_return_val_if_fail (convert->in_place, FALSE);
+    flags |= GST_AUDIO_CONVERTER_FLAG_IN_WRITABLE;
+  }
+
   convert->in_writable = flags & GST_AUDIO_CONVERTER_FLAG_IN_WRITABLE;
   convert->in_data = in;
   convert->in_frames = in_frames;
@@ -1042,8 +1316,7 @@ converter_resample (GstAudioConverter * convert,
     GstAudioConverterFlags flags, gpointer in[], gsize in_frames,
     gpointer out[], gsize out_frames)
 {
-  gst_audio_resampler_resample (convert->resampler, in, in_frames, out,
-      out_frames);
+  resample_samples (convert, in, in_frames, out, out_frames);
 
   return TRUE;
 }
@@ -1077,6 +1350,7 @@ gst_audio_converter_new (GstAudioConverterFlags flags, GstAudioInfo * in_info,
 {
   GstAudioConverter *convert;
   AudioChain *prev;
+  guint n_threads;
 
   g_return_val_if_fail (in_info != NULL, FALSE);
   g_return_val_if_fail (out_info != NULL, FALSE);
@@ -1101,6 +1375,15 @@ gst_audio_converter_new (GstAudioConverterFlags flags, GstAudioInfo * in_info,
 
   GST_INFO ("unitsizes: %d -> %d", in_info->bpf, out_info->bpf);
 
+  n_threads = GET_OPT_THREADS (convert);
+  if (n_threads == 0 || n_threads > g_get_num_processors ())
+    n_threads = g_get_num_processors ();
+  /* resampling is split over the channels */
+  if (n_threads > out_info->channels)
+    n_threads = out_info->channels;
+  if (n_threads > 1)
+    convert->runner = gst_parallelized_task_runner_new (n_threads);
+
   /* step 1, unpack */
   prev = chain_unpack (convert);
   /* step 2, optional convert from S32 to F64 for channel mix */
@@ -1165,6 +1448,16 @@ gst_audio_converter_new (GstAudioConverterFlags flags, GstAudioInfo * in_info,
     }
   }
 
+  /* Without resampling and mixing every step of the generic chain works
+   * sample by sample and only writes samples it has already read. When the
+   * frame size does not change, the output can then be the input. */
+  if (convert->convert == converter_generic && convert->resampler == NULL
+      && convert->mix_passthrough && in_info->bpf == out_info->bpf) {
+    GST_INFO ("same frame size, no resampler and passthrough mixing -> "
+        "in-place conversion");
+    convert->in_place = TRUE;
+  }
+
   setup_allocators (convert);
 
   return convert;
@@ -1201,8 +1494,24 @@ gst_audio_converter_free (GstAudioConverter * convert)
     gst_audio_quantize_free (convert->quant);
   if (convert->mix)
     gst_audio_channel_mixer_free (convert->mix);
-  if (convert->resampler)
+  g_free (convert->mix_tasks);
+  g_free (convert->mix_tasks_p);
+  if (convert->resample_tasks) {
+    gint i;
+
+    for (i = 0; i < convert->runner->n_threads; i++) {
+      AudioResampleTask *task = &convert->resample_tasks[i];
+
+      gst_audio_resampler_free (task->resampler);
+      g_free (task->in_planes);
+      g_free (task->out_planes);
+    }
+    g_free (convert->resample_tasks);
+    g_free (convert->resample_tasks_p);
+  } else if (convert->resampler)
     gst_audio_resampler_free (convert->resampler);
+  if (convert->runner)
+    gst_parallelized_task_runner_free (convert->runner);
   gst_audio_info_init (&convert->in);
   gst_audio_info_init (&convert->out);
 
@@ -1280,7 +1589,12 @@ gst_audio_converter_get_max_latency (GstAudioConverter * convert)
 void
 gst_audio_converter_reset (GstAudioConverter * convert)
 {
-  if (convert->resampler)
+  if (convert->resample_tasks) {
+    gint i;
+
+    for (i = 0; i < convert->runner->n_threads; i++)
+      gst_audio_resampler_reset (convert->resample_tasks[i].resampler);
+  } else if (convert->resampler)
     gst_audio_resampler_reset (convert->resampler);
   if (convert->quant)
     gst_audio_quantize_reset (convert->quant);
@@ -1336,6 +1650,9 @@ gst_audio_converter_samples (GstAudioConverter * convert,
  * Returns whether the audio converter can perform the conversion in-place.
  * The return value would be typically input to gst_base_transform_set_in_place()
  *
+ * For an in-place conversion, pass the same memory as input and output to
+ * gst_audio_converter_samples().
+ *
  * Returns: %TRUE when the conversion can be done in place.
  */
 gboolean
@@ -0,0 +1,590 @@
+/* GStreamer
+ * Copyright (C) <2016> Wim Taymans <wim.taymans@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "audio-resampler-x86-avx2.h"
+
+#if defined (HAVE_IMMINTRIN_H) && defined (__AVX2__) && defined (__FMA__)
+#include <immintrin.h>
+
+/* horizontal sums, the integer versions are exact so the result is the
+ * same as the C code */
+static inline gint32
+hsum_epi32_avx2 (__m256i sum)
+{
+  __m128i res;
+
+  res = _mm_add_epi32 (_mm256_castsi256_si128 (sum),
+      _mm256_extracti128_si256 (sum, 1));
+  res = _mm_add_epi32 (res, _mm_shuffle_epi32 (res, _MM_SHUFFLE (2, 3, 2, 3)));
+  res = _mm_add_epi32 (res, _mm_shuffle_epi32 (res, _MM_SHUFFLE (1, 1, 1, 1)));
+  return _mm_cvtsi128_si32 (res);
+}
+
+#if defined (__x86_64__)
+static inline gint64
+hsum_epi64_avx2 (__m256i sum)
+{
+  __m128i res;
+
+  res = _mm_add_epi64 (_mm256_castsi256_si128 (sum),
+      _mm256_extracti128_si256 (sum, 1));
+  res = _mm_add_epi64 (res, _mm_unpackhi_epi64 (res, res));
+  return _mm_cvtsi128_si64 (res);
+}
+#endif
+
+static inline __m128
+hadd_ps_avx2 (__m256 sum)
+{
+  return _mm_add_ps (_mm256_castps256_ps128 (sum),
+      _mm256_extractf128_ps (sum, 1));
+}
+
+static inline __m128d
+hadd_pd_avx2 (__m256d sum)
+{
+  return _mm_add_pd (_mm256_castpd256_pd128 (sum),
+      _mm256_extractf128_pd (sum, 1));
+}
+
+static inline void
+inner_product_gint16_full_1_avx2 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i;
+  gint32 res;
+  __m256i sum = _mm256_setzero_si256 ();
+
+  for (i = 0; i < len; i += 16) {
+    sum = _mm256_add_epi32 (sum,
+        _mm256_madd_epi16 (_mm256_loadu_si256 ((__m256i *) (a + i)),
+            _mm256_loadu_si256 ((__m256i *) (b + i))));
+  }
+  res = (hsum_epi32_avx2 (sum) + (1 << (PRECISION_S16 - 1))) >> PRECISION_S16;
+  *o = CLAMP (res, G_MININT16, G_MAXINT16);
+}
+
+static inline void
+inner_product_gint16_linear_1_avx2 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i;
+  gint32 res[2];
+  __m256i sum[2], t;
+  const gint16 *c[2] = { (gint16 *) ((gint8 *) b + 0 * bstride),
+    (gint16 *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm256_setzero_si256 ();
+
+  for (i = 0; i < len; i += 16) {
+    t = _mm256_loadu_si256 ((__m256i *) (a + i));
+    sum[0] = _mm256_add_epi32 (sum[0], _mm256_madd_epi16 (t,
+            _mm256_loadu_si256 ((__m256i *) (c[0] + i))));
+    sum[1] = _mm256_add_epi32 (sum[1], _mm256_madd_epi16 (t,
+            _mm256_loadu_si256 ((__m256i *) (c[1] + i))));
+  }
+  res[0] = hsum_epi32_avx2 (sum[0]) >> PRECISION_S16;
+  res[1] = hsum_epi32_avx2 (sum[1]) >> PRECISION_S16;
+
+  res[0] = ((gint32) (gint16) res[0] - (gint32) (gint16) res[1]) * icoeff[0] +
+      ((gint32) (gint16) res[1] << PRECISION_S16);
+  res[0] = (res[0] + (1 << (PRECISION_S16 - 1))) >> PRECISION_S16;
+  *o = CLAMP (res[0], G_MININT16, G_MAXINT16);
+}
+
+static inline void
+inner_product_gint16_cubic_1_avx2 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i;
+  gint32 res;
+  __m256i sum[4], t;
+  const gint16 *c[4] = { (gint16 *) ((gint8 *) b + 0 * bstride),
+    (gint16 *) ((gint8 *) b + 1 * bstride),
+    (gint16 *) ((gint8 *) b + 2 * bstride),
+    (gint16 *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_si256 ();
+
+  for (i = 0; i < len; i += 16) {
+    t = _mm256_loadu_si256 ((__m256i *) (a + i));
+    sum[0] = _mm256_add_epi32 (sum[0], _mm256_madd_epi16 (t,
+            _mm256_loadu_si256 ((__m256i *) (c[0] + i))));
+    sum[1] = _mm256_add_epi32 (sum[1], _mm256_madd_epi16 (t,
+            _mm256_loadu_si256 ((__m256i *) (c[1] + i))));
+    sum[2] = _mm256_add_epi32 (sum[2], _mm256_madd_epi16 (t,
+            _mm256_loadu_si256 ((__m256i *) (c[2] + i))));
+    sum[3] = _mm256_add_epi32 (sum[3], _mm256_madd_epi16 (t,
+            _mm256_loadu_si256 ((__m256i *) (c[3] + i))));
+  }
+  res = (gint32) (gint16) (hsum_epi32_avx2 (sum[0]) >> PRECISION_S16) *
+      icoeff[0] +
+      (gint32) (gint16) (hsum_epi32_avx2 (sum[1]) >> PRECISION_S16) *
+      icoeff[1] +
+      (gint32) (gint16) (hsum_epi32_avx2 (sum[2]) >> PRECISION_S16) *
+      icoeff[2] +
+      (gint32) (gint16) (hsum_epi32_avx2 (sum[3]) >> PRECISION_S16) *
+      icoeff[3];
+  res = (res + (1 << (PRECISION_S16 - 1))) >> PRECISION_S16;
+  *o = CLAMP (res, G_MININT16, G_MAXINT16);
+}
+
+#if defined (__x86_64__)
+/* multiply the even and the odd 32 bits lanes into 64 bits sums */
+#define MUL_ADD_EPI32_AVX2(sum,ta,tb)                                   \
+  sum = _mm256_add_epi64 (sum, _mm256_mul_epi32 (ta, tb));              \
+  sum = _mm256_add_epi64 (sum, _mm256_mul_epi32 (                       \
+          _mm256_srli_epi64 (ta, 32), _mm256_srli_epi64 (tb, 32)));
+
+static inline void
+inner_product_gint32_full_1_avx2 (gint32 * o, const gint32 * a,
+    const gint32 * b, gint len, const gint32 * icoeff, gint bstride)
+{
+  gint i;
+  gint64 res;
+  __m256i sum, ta, tb;
+
+  sum = _mm256_setzero_si256 ();
+
+  for (i = 0; i < len; i += 8) {
+    ta = _mm256_loadu_si256 ((__m256i *) (a + i));
+    tb = _mm256_loadu_si256 ((__m256i *) (b + i));
+    MUL_ADD_EPI32_AVX2 (sum, ta, tb);
+  }
+  res = hsum_epi64_avx2 (sum);
+
+  res = (res + (1 << (PRECISION_S32 - 1))) >> PRECISION_S32;
+  *o = CLAMP (res, G_MININT32, G_MAXINT32);
+}
+
+static inline void
+inner_product_gint32_linear_1_avx2 (gint32 * o, const gint32 * a,
+    const gint32 * b, gint len, const gint32 * icoeff, gint bstride)
+{
+  gint i;
+  gint64 res[2];
+  __m256i sum[2], ta, tb;
+  const gint32 *c[2] = { (gint32 *) ((gint8 *) b + 0 * bstride),
+    (gint32 *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm256_setzero_si256 ();
+
+  for (i = 0; i < len; i += 8) {
+    ta = _mm256_loadu_si256 ((__m256i *) (a + i));
+
+    tb = _mm256_loadu_si256 ((__m256i *) (c[0] + i));
+    MUL_ADD_EPI32_AVX2 (sum[0], ta, tb);
+    tb = _mm256_loadu_si256 ((__m256i *) (c[1] + i));
+    MUL_ADD_EPI32_AVX2 (sum[1], ta, tb);
+  }
+  res[0] = hsum_epi64_avx2 (sum[0]) >> PRECISION_S32;
+  res[1] = hsum_epi64_avx2 (sum[1]) >> PRECISION_S32;
+
+  res[0] = ((gint64) (gint32) res[0] - (gint64) (gint32) res[1]) * icoeff[0] +
+      ((gint64) (gint32) res[1] << PRECISION_S32);
+  res[0] = (res[0] + ((gint64) 1 << (PRECISION_S32 - 1))) >> PRECISION_S32;
+  *o = CLAMP (res[0], G_MININT32, G_MAXINT32);
+}
+
+static inline void
+inner_product_gint32_cubic_1_avx2 (gint32 * o, const gint32 * a,
+    const gint32 * b, gint len, const gint32 * icoeff, gint bstride)
+{
+  gint i;
+  gint64 res;
+  __m256i sum[4], ta, tb;
+  const gint32 *c[4] = { (gint32 *) ((gint8 *) b + 0 * bstride),
+    (gint32 *) ((gint8 *) b + 1 * bstride),
+    (gint32 *) ((gint8 *) b + 2 * bstride),
+    (gint32 *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_si256 ();
+
+  for (i = 0; i < len; i += 8) {
+    ta = _mm256_loadu_si256 ((__m256i *) (a + i));
+
+    tb = _mm256_loadu_si256 ((__m256i *) (c[0] + i));
+    MUL_ADD_EPI32_AVX2 (sum[0], ta, tb);
+    tb = _mm256_loadu_si256 ((__m256i *) (c[1] + i));
+    MUL_ADD_EPI32_AVX2 (sum[1], ta, tb);
+    tb = _mm256_loadu_si256 ((__m256i *) (c[2] + i));
+    MUL_ADD_EPI32_AVX2 (sum[2], ta, tb);
+    tb = _mm256_loadu_si256 ((__m256i *) (c[3] + i));
+    MUL_ADD_EPI32_AVX2 (sum[3], ta, tb);
+  }
+  res = (gint64) (gint32) (hsum_epi64_avx2 (sum[0]) >> PRECISION_S32) *
+      icoeff[0] +
+      (gint64) (gint32) (hsum_epi64_avx2 (sum[1]) >> PRECISION_S32) *
+      icoeff[1] +
+      (gint64) (gint32) (hsum_epi64_avx2 (sum[2]) >> PRECISION_S32) *
+      icoeff[2] +
+      (gint64) (gint32) (hsum_epi64_avx2 (sum[3]) >> PRECISION_S32) *
+      icoeff[3];
+  res = (res + ((gint64) 1 << (PRECISION_S32 - 1))) >> PRECISION_S32;
+  *o = CLAMP (res, G_MININT32, G_MAXINT32);
+}
+
+MAKE_RESAMPLE_FUNC (gint32, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint32, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint32, cubic, 1, avx2);
+#endif
+
+static inline void
+inner_product_gfloat_full_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i;
+  __m256 sum = _mm256_setzero_ps ();
+  __m128 res;
+
+  for (i = 0; i < len; i += 8)
+    sum = _mm256_fmadd_ps (_mm256_loadu_ps (a + i), _mm256_loadu_ps (b + i),
+        sum);
+
+  res = hadd_ps_avx2 (sum);
+  res = _mm_add_ps (res, _mm_movehl_ps (res, res));
+  res = _mm_add_ss (res, _mm_shuffle_ps (res, res, 0x55));
+  _mm_store_ss (o, res);
+}
+
+static inline void
+inner_product_gfloat_linear_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i;
+  __m256 sum[2], t;
+  __m128 res;
+  const gfloat *c[2] = { (gfloat *) ((gint8 *) b + 0 * bstride),
+    (gfloat *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm256_setzero_ps ();
+
+  for (i = 0; i < len; i += 8) {
+    t = _mm256_loadu_ps (a + i);
+    sum[0] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[0] + i), sum[0]);
+    sum[1] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[1] + i), sum[1]);
+  }
+  sum[0] = _mm256_fmadd_ps (_mm256_sub_ps (sum[0], sum[1]),
+      _mm256_broadcast_ss (icoeff), sum[1]);
+  res = hadd_ps_avx2 (sum[0]);
+  res = _mm_add_ps (res, _mm_movehl_ps (res, res));
+  res = _mm_add_ss (res, _mm_shuffle_ps (res, res, 0x55));
+  _mm_store_ss (o, res);
+}
+
+static inline void
+inner_product_gfloat_cubic_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i;
+  __m256 sum[4], t;
+  __m128 res;
+  const gfloat *c[4] = { (gfloat *) ((gint8 *) b + 0 * bstride),
+    (gfloat *) ((gint8 *) b + 1 * bstride),
+    (gfloat *) ((gint8 *) b + 2 * bstride),
+    (gfloat *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_ps ();
+
+  for (i = 0; i < len; i += 8) {
+    t = _mm256_loadu_ps (a + i);
+    sum[0] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[0] + i), sum[0]);
+    sum[1] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[1] + i), sum[1]);
+    sum[2] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[2] + i), sum[2]);
+    sum[3] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[3] + i), sum[3]);
+  }
+  sum[0] = _mm256_mul_ps (sum[0], _mm256_broadcast_ss (icoeff + 0));
+  sum[0] = _mm256_fmadd_ps (sum[1], _mm256_broadcast_ss (icoeff + 1), sum[0]);
+  sum[0] = _mm256_fmadd_ps (sum[2], _mm256_broadcast_ss (icoeff + 2), sum[0]);
+  sum[0] = _mm256_fmadd_ps (sum[3], _mm256_broadcast_ss (icoeff + 3), sum[0]);
+  res = hadd_ps_avx2 (sum[0]);
+  res = _mm_add_ps (res, _mm_movehl_ps (res, res));
+  res = _mm_add_ss (res, _mm_shuffle_ps (res, res, 0x55));
+  _mm_store_ss (o, res);
+}
+
+static inline void
+inner_product_gdouble_full_1_avx2 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i;
+  __m256d sum[2];
+  __m128d res;
+
+  sum[0] = sum[1] = _mm256_setzero_pd ();
+
+  for (i = 0; i < len; i += 8) {
+    sum[0] = _mm256_fmadd_pd (_mm256_loadu_pd (a + i + 0),
+        _mm256_loadu_pd (b + i + 0), sum[0]);
+    sum[1] = _mm256_fmadd_pd (_mm256_loadu_pd (a + i + 4),
+        _mm256_loadu_pd (b + i + 4), sum[1]);
+  }
+  res = hadd_pd_avx2 (_mm256_add_pd (sum[0], sum[1]));
+  res = _mm_add_sd (res, _mm_unpackhi_pd (res, res));
+  _mm_store_sd (o, res);
+}
+
+static inline void
+inner_product_gdouble_linear_1_avx2 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i;
+  __m256d sum[2], t;
+  __m128d res;
+  const gdouble *c[2] = { (gdouble *) ((gint8 *) b + 0 * bstride),
+    (gdouble *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm256_setzero_pd ();
+
+  for (i = 0; i < len; i += 4) {
+    t = _mm256_loadu_pd (a + i);
+    sum[0] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[0] + i), sum[0]);
+    sum[1] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[1] + i), sum[1]);
+  }
+  sum[0] = _mm256_fmadd_pd (_mm256_sub_pd (sum[0], sum[1]),
+      _mm256_broadcast_sd (icoeff), sum[1]);
+  res = hadd_pd_avx2 (sum[0]);
+  res = _mm_add_sd (res, _mm_unpackhi_pd (res, res));
+  _mm_store_sd (o, res);
+}
+
+static inline void
+inner_product_gdouble_cubic_1_avx2 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i;
+  __m256d sum[4], t;
+  __m128d res;
+  const gdouble *c[4] = { (gdouble *) ((gint8 *) b + 0 * bstride),
+    (gdouble *) ((gint8 *) b + 1 * bstride),
+    (gdouble *) ((gint8 *) b + 2 * bstride),
+    (gdouble *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_pd ();
+
+  for (i = 0; i < len; i += 4) {
+    t = _mm256_loadu_pd (a + i);
+    sum[0] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[0] + i), sum[0]);
+    sum[1] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[1] + i), sum[1]);
+    sum[2] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[2] + i), sum[2]);
+    sum[3] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[3] + i), sum[3]);
+  }
+  sum[0] = _mm256_mul_pd (sum[0], _mm256_broadcast_sd (icoeff + 0));
+  sum[0] = _mm256_fmadd_pd (sum[1], _mm256_broadcast_sd (icoeff + 1), sum[0]);
+  sum[0] = _mm256_fmadd_pd (sum[2], _mm256_broadcast_sd (icoeff + 2), sum[0]);
+  sum[0] = _mm256_fmadd_pd (sum[3], _mm256_broadcast_sd (icoeff + 3), sum[0]);
+  res = hadd_pd_avx2 (sum[0]);
+  res = _mm_add_sd (res, _mm_unpackhi_pd (res, res));
+  _mm_store_sd (o, res);
+}
+
+MAKE_RESAMPLE_FUNC (gint16, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint16, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint16, cubic, 1, avx2);
+
+MAKE_RESAMPLE_FUNC (gfloat, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gfloat, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gfloat, cubic, 1, avx2);
+
+MAKE_RESAMPLE_FUNC (gdouble, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gdouble, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gdouble, cubic, 1, avx2);
+
+void
+interpolate_gint16_linear_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gint16 *o = op, *a = ap, *ic = icp;
+  __m256i ta, tb, t1, t2;
+  /* unpack and pack work per 128 bits lane so the order is kept */
+  __m256i f = _mm256_set1_epi32 (*((gint32 *) ic));
+  const gint16 *c[2] = { (gint16 *) ((gint8 *) a + 0 * astride),
+    (gint16 *) ((gint8 *) a + 1 * astride)
+  };
+
+  for (i = 0; i < len; i += 16) {
+    ta = _mm256_loadu_si256 ((__m256i *) (c[0] + i));
+    tb = _mm256_loadu_si256 ((__m256i *) (c[1] + i));
+
+    t1 = _mm256_madd_epi16 (_mm256_unpacklo_epi16 (ta, tb), f);
+    t2 = _mm256_madd_epi16 (_mm256_unpackhi_epi16 (ta, tb), f);
+
+    t1 = _mm256_add_epi32 (t1, _mm256_set1_epi32 (1 << (PRECISION_S16 - 1)));
+    t2 = _mm256_add_epi32 (t2, _mm256_set1_epi32 (1 << (PRECISION_S16 - 1)));
+
+    t1 = _mm256_srai_epi32 (t1, PRECISION_S16);
+    t2 = _mm256_srai_epi32 (t2, PRECISION_S16);
+
+    _mm256_storeu_si256 ((__m256i *) (o + i), _mm256_packs_epi32 (t1, t2));
+  }
+}
+
+void
+interpolate_gint16_cubic_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gint16 *o = op, *a = ap, *ic = icp;
+  __m256i ta, tb, tl1, tl2, th1, th2;
+  __m256i f[2];
+  const gint16 *c[4] = { (gint16 *) ((gint8 *) a + 0 * astride),
+    (gint16 *) ((gint8 *) a + 1 * astride),
+    (gint16 *) ((gint8 *) a + 2 * astride),
+    (gint16 *) ((gint8 *) a + 3 * astride)
+  };
+
+  f[0] = _mm256_set1_epi32 (*((gint32 *) (ic + 0)));
+  f[1] = _mm256_set1_epi32 (*((gint32 *) (ic + 2)));
+
+  for (i = 0; i < len; i += 16) {
+    ta = _mm256_loadu_si256 ((__m256i *) (c[0] + i));
+    tb = _mm256_loadu_si256 ((__m256i *) (c[1] + i));
+
+    tl1 = _mm256_madd_epi16 (_mm256_unpacklo_epi16 (ta, tb), f[0]);
+    th1 = _mm256_madd_epi16 (_mm256_unpackhi_epi16 (ta, tb), f[0]);
+
+    ta = _mm256_loadu_si256 ((__m256i *) (c[2] + i));
+    tb = _mm256_loadu_si256 ((__m256i *) (c[3] + i));
+
+    tl2 = _mm256_madd_epi16 (_mm256_unpacklo_epi16 (ta, tb), f[1]);
+    th2 = _mm256_madd_epi16 (_mm256_unpackhi_epi16 (ta, tb), f[1]);
+
+    tl1 = _mm256_add_epi32 (tl1, tl2);
+    th1 = _mm256_add_epi32 (th1, th2);
+
+    tl1 = _mm256_add_epi32 (tl1, _mm256_set1_epi32 (1 << (PRECISION_S16 - 1)));
+    th1 = _mm256_add_epi32 (th1, _mm256_set1_epi32 (1 << (PRECISION_S16 - 1)));
+
+    tl1 = _mm256_srai_epi32 (tl1, PRECISION_S16);
+    th1 = _mm256_srai_epi32 (th1, PRECISION_S16);
+
+    _mm256_storeu_si256 ((__m256i *) (o + i), _mm256_packs_epi32 (tl1, th1));
+  }
+}
+
+void
+interpolate_gfloat_linear_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gfloat *o = op, *a = ap, *ic = icp;
+  __m256 f[2];
+  const gfloat *c[2] = { (gfloat *) ((gint8 *) a + 0 * astride),
+    (gfloat *) ((gint8 *) a + 1 * astride)
+  };
+
+  f[0] = _mm256_broadcast_ss (ic + 0);
+  f[1] = _mm256_broadcast_ss (ic + 1);
+
+  for (i = 0; i < len; i += 8) {
+    _mm256_storeu_ps (o + i,
+        _mm256_fmadd_ps (_mm256_loadu_ps (c[0] + i), f[0],
+            _mm256_mul_ps (_mm256_loadu_ps (c[1] + i), f[1])));
+  }
+}
+
+void
+interpolate_gfloat_cubic_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gfloat *o = op, *a = ap, *ic = icp;
+  __m256 f[4], t[2];
+  const gfloat *c[4] = { (gfloat *) ((gint8 *) a + 0 * astride),
+    (gfloat *) ((gint8 *) a + 1 * astride),
+    (gfloat *) ((gint8 *) a + 2 * astride),
+    (gfloat *) ((gint8 *) a + 3 * astride)
+  };
+
+  f[0] = _mm256_broadcast_ss (ic + 0);
+  f[1] = _mm256_broadcast_ss (ic + 1);
+  f[2] = _mm256_broadcast_ss (ic + 2);
+  f[3] = _mm256_broadcast_ss (ic + 3);
+
+  for (i = 0; i < len; i += 8) {
+    t[0] = _mm256_mul_ps (_mm256_loadu_ps (c[0] + i), f[0]);
+    t[1] = _mm256_mul_ps (_mm256_loadu_ps (c[2] + i), f[2]);
+    t[0] = _mm256_fmadd_ps (_mm256_loadu_ps (c[1] + i), f[1], t[0]);
+    t[1] = _mm256_fmadd_ps (_mm256_loadu_ps (c[3] + i), f[3], t[1]);
+    _mm256_storeu_ps (o + i, _mm256_add_ps (t[0], t[1]));
+  }
+}
+
+void
+interpolate_gdouble_linear_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gdouble *o = op, *a = ap, *ic = icp;
+  __m256d f[2];
+  const gdouble *c[2] = { (gdouble *) ((gint8 *) a + 0 * astride),
+    (gdouble *) ((gint8 *) a + 1 * astride)
+  };
+
+  f[0] = _mm256_broadcast_sd (ic + 0);
+  f[1] = _mm256_broadcast_sd (ic + 1);
+
+  for (i = 0; i < len; i += 4) {
+    _mm256_storeu_pd (o + i,
+        _mm256_fmadd_pd (_mm256_loadu_pd (c[0] + i), f[0],
+            _mm256_mul_pd (_mm256_loadu_pd (c[1] + i), f[1])));
+  }
+}
+
+void
+interpolate_gdouble_cubic_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gdouble *o = op, *a = ap, *ic = icp;
+  __m256d f[4], t[2];
+  const gdouble *c[4] = { (gdouble *) ((gint8 *) a + 0 * astride),
+    (gdouble *) ((gint8 *) a + 1 * astride),
+    (gdouble *) ((gint8 *) a + 2 * astride),
+    (gdouble *) ((gint8 *) a + 3 * astride)
+  };
+
+  f[0] = _mm256_broadcast_sd (ic + 0);
+  f[1] = _mm256_broadcast_sd (ic + 1);
+  f[2] = _mm256_broadcast_sd (ic + 2);
+  f[3] = _mm256_broadcast_sd (ic + 3);
+
+  for (i = 0; i < len; i += 4) {
+    t[0] = _mm256_mul_pd (_mm256_loadu_pd (c[0] + i), f[0]);
+    t[1] = _mm256_mul_pd (_mm256_loadu_pd (c[2] + i), f[2]);
+    t[0] = _mm256_fmadd_pd (_mm256_loadu_pd (c[1] + i), f[1], t[0]);
+    t[1] = _mm256_fmadd_pd (_mm256_loadu_pd (c[3] + i), f[3], t[1]);
+    _mm256_storeu_pd (o + i, _mm256_add_pd (t[0], t[1]));
+  }
+}
+
+#endif
@@ -21,6 +21,7 @@
 #include "audio-resampler-x86-sse.h"
 #include "audio-resampler-x86-sse2.h"
 #include "audio-resampler-x86-sse41.h"
+#include "audio-resampler-x86-avx2.h"
 
 static void
 audio_resampler_check_x86 (const gchar *option)
@@ -66,6 +67,38 @@ audio_resampler_check_x86 (const gchar *option)
     resample_gint32_cubic_1 = resample_gint32_cubic_1_sse41;
 #else
     GST_DEBUG ("SSE41 optimisations not enabled");
+#endif
+  } else if (!strcmp (option, "avx2")) {
+#if defined (HAVE_IMMINTRIN_H) && HAVE_AVX2 && HAVE_FMA
+    GST_DEBUG ("enable AVX2 optimisations");
+    resample_gint16_full_1 = resample_gint16_full_1_avx2;
+    resample_gint16_linear_1 = resample_gint16_linear_1_avx2;
+    resample_gint16_cubic_1 = resample_gint16_cubic_1_avx2;
+
+    interpolate_gint16_linear = interpolate_gint16_linear_avx2;
+    interpolate_gint16_cubic = interpolate_gint16_cubic_avx2;
+
+#if defined (__x86_64__)
+    resample_gint32_full_1 = resample_gint32_full_1_avx2;
+    resample_gint32_linear_1 = resample_gint32_linear_1_avx2;
+    resample_gint32_cubic_1 = resample_gint32_cubic_1_avx2;
+#endif
+
+    resample_gfloat_full_1 = resample_gfloat_full_1_avx2;
+    resample_gfloat_linear_1 = resample_gfloat_linear_1_avx2;
+    resample_gfloat_cubic_1 = resample_gfloat_cubic_1_avx2;
+
+    interpolate_gfloat_linear = interpolate_gfloat_linear_avx2;
+    interpolate_gfloat_cubic = interpolate_gfloat_cubic_avx2;
+
+    resample_gdouble_full_1 = resample_gdouble_full_1_avx2;
+    resample_gdouble_linear_1 = resample_gdouble_linear_1_avx2;
+    resample_gdouble_cubic_1 = resample_gdouble_cubic_1_avx2;
+
+    interpolate_gdouble_linear = interpolate_gdouble_linear_avx2;
+    interpolate_gdouble_cubic = interpolate_gdouble_cubic_avx2;
+#else
+    GST_DEBUG ("AVX2 optimisations not enabled");
 #endif
   }
 }
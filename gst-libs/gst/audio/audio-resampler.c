@@ -105,6 +105,7 @@ static const BlackmanQualityMap blackman_qualities[] = {
 #define DEFAULT_OPT_FILTER_INTERPOLATION GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_CUBIC
 #define DEFAULT_OPT_FILTER_OVERSAMPLE 8
 #define DEFAULT_OPT_MAX_PHASE_ERROR 0.1
+#define DEFAULT_OPT_SIMD TRUE
 
 static gdouble
 get_opt_double (GstStructure * options, const gchar * name, gdouble def)
@@ -124,6 +125,15 @@ get_opt_int (GstStructure * options, const gchar * name, gint def)
   return res;
 }
 
+static gboolean
+get_opt_bool (GstStructure * options, const gchar * name, gboolean def)
+{
+  gboolean res;
+  if (!options || !gst_structure_get_boolean (options, name, &res))
+    res = def;
+  return res;
+}
+
 static gint
 get_opt_enum (GstStructure * options, const gchar * name, GType type, gint def)
 {
@@ -160,6 +170,8 @@ get_opt_enum (GstStructure * options, const gchar * name, GType type, gint def)
     GST_AUDIO_RESAMPLER_OPT_FILTER_OVERSAMPLE, DEFAULT_OPT_FILTER_OVERSAMPLE)
 #define GET_OPT_MAX_PHASE_ERROR(options) get_opt_double(options, \
     GST_AUDIO_RESAMPLER_OPT_MAX_PHASE_ERROR, DEFAULT_OPT_MAX_PHASE_ERROR)
+#define GET_OPT_SIMD(options) get_opt_bool(options, \
+    GST_AUDIO_RESAMPLER_OPT_SIMD, DEFAULT_OPT_SIMD)
 
 #include "dbesi0.c"
 #define bessel dbesi0
@@ -822,15 +834,19 @@ static ResampleFunc resample_funcs[] = {
 #define resample_gfloat_cubic_1 resample_funcs[14]
 #define resample_gdouble_cubic_1 resample_funcs[15]
 
+/* the C functions, used when the SIMD option is disabled */
+static ResampleFunc resample_funcs_c[G_N_ELEMENTS (resample_funcs)];
+static InterpolateFunc interpolate_funcs_c[G_N_ELEMENTS (interpolate_funcs)];
+
 #if defined HAVE_ORC && !defined DISABLE_ORC
 # if defined (HAVE_ARM_NEON)
 #  define CHECK_NEON
 #  include "audio-resampler-neon.h"
 # endif
-# if defined (__i386__) || defined (__x86_64__)
-#  define CHECK_X86
-#  include "audio-resampler-x86.h"
-# endif
+#endif
+#if defined (__i386__) || defined (__x86_64__)
+# define CHECK_X86
+# include "audio-resampler-x86.h"
 #endif
 
 static void
@@ -843,6 +859,9 @@ audio_resampler_init (void)
     GST_DEBUG_CATEGORY_INIT (audio_resampler_debug, "audio-resampler", 0,
         "audio-resampler object");
 
+    memcpy (resample_funcs_c, resample_funcs, sizeof (resample_funcs));
+    memcpy (interpolate_funcs_c, interpolate_funcs, sizeof (interpolate_funcs));
+
 #if defined HAVE_ORC && !defined DISABLE_ORC
     orc_init ();
     {
@@ -874,6 +893,12 @@ audio_resampler_init (void)
         }
       }
     }
+#endif
+#if defined (CHECK_X86) && defined (__GNUC__)
+    /* ORC has no flags for AVX2 and FMA, ask the CPU directly */
+    __builtin_cpu_init ();
+    if (__builtin_cpu_supports ("avx2") && __builtin_cpu_supports ("fma"))
+      audio_resampler_check_x86 ("avx2");
 #endif
     g_once_init_leave (&init_gonce, 1);
   }
@@ -999,12 +1024,20 @@ alloc_cache_mem (GstAudioResampler * resampler, gint bps, gint n_taps,
 static void
 setup_functions (GstAudioResampler * resampler)
 {
+  ResampleFunc *rfuncs = resample_funcs;
+  InterpolateFunc *ifuncs = interpolate_funcs;
   gint index, fidx;
 
+  if (!GET_OPT_SIMD (resampler->options)) {
+    GST_DEBUG ("using C functions");
+    rfuncs = resample_funcs_c;
+    ifuncs = interpolate_funcs_c;
+  }
+
   index = resampler->format_index;
 
   if (resampler->in_rate == resampler->out_rate)
-    resampler->resample = resample_funcs[index];
+    resampler->resample = rfuncs[index];
   else {
     switch (resampler->filter_interpolation) {
       default:
@@ -1021,7 +1054,7 @@ setup_functions (GstAudioResampler * resampler)
         break;
     }
     GST_DEBUG ("using filter interpolate function %d", index + fidx);
-    resampler->interpolate = interpolate_funcs[index + fidx];
+    resampler->interpolate = ifuncs[index + fidx];
 
     switch (resampler->method) {
       case GST_AUDIO_RESAMPLER_METHOD_NEAREST:
@@ -1042,7 +1075,7 @@ setup_functions (GstAudioResampler * resampler)
         break;
     }
     GST_DEBUG ("using resample function %d", index);
-    resampler->resample = resample_funcs[index];
+    resampler->resample = rfuncs[index];
   }
 }
 
@@ -153,6 +153,17 @@ typedef enum {
  */
 #define GST_AUDIO_RESAMPLER_OPT_MAX_PHASE_ERROR "GstAudioResampler.max-phase-error"
 
+/**
+ * GST_AUDIO_RESAMPLER_OPT_SIMD:
+ *
+ * G_TYPE_BOOLEAN: use the SSE, NEON or AVX2 functions when the CPU supports
+ * them. When %FALSE, the plain C functions are used.
+ * %TRUE is the default.
+ *
+ * Since: 1.14
+ */
+#define GST_AUDIO_RESAMPLER_OPT_SIMD "GstAudioResampler.simd"
+
 /**
  * GstAudioResamplerMethod:
  * @GST_AUDIO_RESAMPLER_METHOD_NEAREST: Duplicates the samples when
@@ -54,6 +54,9 @@
  *
  *     * Base class gathers input sample data (as directed by the context's
  *       frame_samples and frame_max) and provides this to subclass' @handle_frame.
+ *       Subclasses that can handle input spread over several memory blocks
+ *       can avoid having it merged into one with
+ *       gst_audio_encoder_set_scattered_input().
  *     * If codec processing results in encoded data, subclass should call
  *       gst_audio_encoder_finish_frame() to have encoded data pushed
  *       downstream. Alternatively, it might also call
@@ -156,6 +159,7 @@ enum
 #define DEFAULT_TOLERANCE    40000000
 #define DEFAULT_HARD_MIN     FALSE
 #define DEFAULT_DRAINABLE    TRUE
+#define DEFAULT_SCATTERED_INPUT FALSE
 
 typedef struct _GstAudioEncoderContext
 {
@@ -231,6 +235,7 @@ struct _GstAudioEncoderPrivate
   gboolean granule;
   gboolean hard_min;
   gboolean drainable;
+  gboolean scattered_input;
 
   /* upstream stream tags (global tags are passed through as-is) */
   GstTagList *upstream_tags;
@@ -435,6 +440,7 @@ gst_audio_encoder_init (GstAudioEncoder * enc, GstAudioEncoderClass * bclass)
   enc->priv->tolerance = DEFAULT_TOLERANCE;
   enc->priv->hard_min = DEFAULT_HARD_MIN;
   enc->priv->drainable = DEFAULT_DRAINABLE;
+  enc->priv->scattered_input = DEFAULT_SCATTERED_INPUT;
 
   /* init state */
   enc->priv->ctx.min_latency = 0;
@@ -1038,6 +1044,7 @@ gst_audio_encoder_push_buffers (GstAudioEncoder * enc, gboolean force)
   GstAudioEncoderContext *ctx;
   gint av, need;
   GstBuffer *buf;
+  gboolean mapped;
   GstFlowReturn ret = GST_FLOW_OK;
 
   klass = GST_AUDIO_ENCODER_GET_CLASS (enc);
@@ -1088,13 +1095,23 @@ gst_audio_encoder_push_buffers (GstAudioEncoder * enc, gboolean force)
     }
 
     priv->got_data = FALSE;
-    if (G_LIKELY (need)) {
+    mapped = FALSE;
+    if (G_LIKELY (need) && priv->scattered_input) {
+      GstBuffer *queued;
+
+      /* share the memory of the queued buffers rather than merging it */
+      queued = gst_adapter_get_buffer_fast (priv->adapter, priv->offset + need);
+      buf = gst_buffer_copy_region (queued, GST_BUFFER_COPY_MEMORY,
+          priv->offset, need);
+      gst_buffer_unref (queued);
+    } else if (G_LIKELY (need)) {
       const guint8 *data;
 
       data = gst_adapter_map (priv->adapter, priv->offset + need);
       buf =
           gst_buffer_new_wrapped_full (GST_MEMORY_FLAG_READONLY,
           (gpointer) data, priv->offset + need, priv->offset, need, NULL, NULL);
+      mapped = TRUE;
     } else if (!priv->drainable) {
       GST_DEBUG_OBJECT (enc, "non-drainable and no more data");
       goto finish;
@@ -1121,7 +1138,8 @@ gst_audio_encoder_push_buffers (GstAudioEncoder * enc, gboolean force)
 
     if (G_LIKELY (buf)) {
       gst_buffer_unref (buf);
-      gst_adapter_unmap (priv->adapter);
+      if (mapped)
+        gst_adapter_unmap (priv->adapter);
     }
 
   finish:
@@ -2625,6 +2643,59 @@ gst_audio_encoder_get_drainable (GstAudioEncoder * enc)
   return result;
 }
 
+/**
+ * gst_audio_encoder_set_scattered_input:
+ * @enc: a #GstAudioEncoder
+ * @enabled: new state
+ *
+ * Configures how input data is provided to the subclass. By default, the
+ * buffer passed to @handle_frame holds all samples in a single memory
+ * block, which requires copying them whenever they span several upstream
+ * buffers. If enabled, the buffer is instead made of the memory of the
+ * upstream buffers, without any copy. Subclasses should then access the
+ * samples per memory block (e.g. with gst_buffer_peek_memory()) or with
+ * gst_buffer_extract(), as mapping the whole buffer merges it anyway.
+ *
+ * MT safe.
+ *
+ * Since: 1.14
+ */
+void
+gst_audio_encoder_set_scattered_input (GstAudioEncoder * enc, gboolean enabled)
+{
+  g_return_if_fail (GST_IS_AUDIO_ENCODER (enc));
+
+  GST_OBJECT_LOCK (enc);
+  enc->priv->scattered_input = enabled;
+  GST_OBJECT_UNLOCK (enc);
+}
+
+/**
+ * gst_audio_encoder_get_scattered_input:
+ * @enc: a #GstAudioEncoder
+ *
+ * Queries whether input data may be provided in several memory blocks.
+ *
+ * Returns: TRUE if scattered input is enabled.
+ *
+ * MT safe.
+ *
+ * Since: 1.14
+ */
+gboolean
+gst_audio_encoder_get_scattered_input (GstAudioEncoder * enc)
+{
+  gboolean result;
+
+  g_return_val_if_fail (GST_IS_AUDIO_ENCODER (enc), 0);
+
+  GST_OBJECT_LOCK (enc);
+  result = enc->priv->scattered_input;
+  GST_OBJECT_UNLOCK (enc);
+
+  return result;
+}
+
 /**
  * gst_audio_encoder_merge_tags:
  * @enc: a #GstAudioEncoder
@@ -362,6 +362,13 @@ void            gst_audio_encoder_set_drainable (GstAudioEncoder * enc,
 GST_EXPORT
 gboolean        gst_audio_encoder_get_drainable (GstAudioEncoder * enc);
 
+GST_EXPORT
+void            gst_audio_encoder_set_scattered_input (GstAudioEncoder * enc,
+                                                       gboolean enabled);
+
+GST_EXPORT
+gboolean        gst_audio_encoder_get_scattered_input (GstAudioEncoder * enc);
+
 GST_EXPORT
 void            gst_audio_encoder_get_allocator (GstAudioEncoder * enc,
                                                  GstAllocator ** allocator,
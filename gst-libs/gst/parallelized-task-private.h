@@ -0,0 +1,197 @@
+/* GStreamer
+ * Copyright (C) 2010 David Schleef <ds@schleef.org>
+ * Copyright (C) 2010 Sebastian Dröge <sebastian.droege@collabora.co.uk>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Task runner used by the audio and video converters to split a conversion
+ * over several threads. Include this after GST_CAT_DEFAULT is defined. */
+
+#ifndef __GST_PARALLELIZED_TASK_PRIVATE_H__
+#define __GST_PARALLELIZED_TASK_PRIVATE_H__
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+typedef void (*GstParallelizedTaskFunc) (gpointer user_data);
+
+typedef struct _GstParallelizedTaskRunner GstParallelizedTaskRunner;
+typedef struct _GstParallelizedTaskJob GstParallelizedTaskJob;
+
+/* All converters of a library share a single pool of worker threads. Each
+ * runner only holds its concurrency cap (n_threads); a call to run() splits
+ * the work into n_threads tasks, pushes n_threads - 1 helper jobs to the
+ * shared pool and then works on the tasks itself. Tasks are claimed with an
+ * atomic counter, so the calling thread steals any tasks that the pool did
+ * not get to yet and a saturated pool never stalls a conversion. */
+struct _GstParallelizedTaskRunner
+{
+  guint n_threads;
+};
+
+/* One job per run(), refcounted because pool workers may only get scheduled
+ * after all tasks were already completed by others */
+struct _GstParallelizedTaskJob
+{
+  gint refcount;
+
+  GstParallelizedTaskFunc func;
+  gpointer *task_data;
+  gint n_tasks;
+
+  gint n_todo;
+
+  GMutex lock;
+  GCond cond_done;
+  gint n_done;
+};
+
+static void
+gst_parallelized_task_job_unref (GstParallelizedTaskJob * job)
+{
+  if (!g_atomic_int_dec_and_test (&job->refcount))
+    return;
+
+  g_mutex_clear (&job->lock);
+  g_cond_clear (&job->cond_done);
+  g_slice_free (GstParallelizedTaskJob, job);
+}
+
+static void
+gst_parallelized_task_job_work (GstParallelizedTaskJob * job)
+{
+  gint idx;
+
+  while ((idx = g_atomic_int_add (&job->n_todo, -1)) > 0) {
+    job->func (job->task_data[idx - 1]);
+
+    g_mutex_lock (&job->lock);
+    job->n_done++;
+    if (job->n_done == job->n_tasks)
+      g_cond_signal (&job->cond_done);
+    g_mutex_unlock (&job->lock);
+  }
+}
+
+static void
+gst_parallelized_task_pool_func (gpointer data, gpointer user_data)
+{
+  GstParallelizedTaskJob *job = data;
+
+  gst_parallelized_task_job_work (job);
+  gst_parallelized_task_job_unref (job);
+}
+
+static gpointer
+gst_parallelized_task_pool_create (gpointer data)
+{
+  GThreadPool *pool;
+  GError *err = NULL;
+
+  pool = g_thread_pool_new (gst_parallelized_task_pool_func, NULL,
+      g_get_num_processors (), FALSE, &err);
+  if (!pool) {
+    GST_ERROR ("Failed to create shared conversion thread pool: %s",
+        err->message);
+    g_clear_error (&err);
+  }
+
+  return pool;
+}
+
+static GThreadPool *
+gst_parallelized_task_get_pool (void)
+{
+  static GOnce pool_once = G_ONCE_INIT;
+
+  return g_once (&pool_once, gst_parallelized_task_pool_create, NULL);
+}
+
+static void
+gst_parallelized_task_runner_free (GstParallelizedTaskRunner * self)
+{
+  g_free (self);
+}
+
+static GstParallelizedTaskRunner *
+gst_parallelized_task_runner_new (guint n_threads)
+{
+  GstParallelizedTaskRunner *self;
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+
+  self = g_new0 (GstParallelizedTaskRunner, 1);
+  self->n_threads = n_threads;
+
+  return self;
+}
+
+static void
+gst_parallelized_task_runner_run (GstParallelizedTaskRunner * self,
+    GstParallelizedTaskFunc func, gpointer * task_data)
+{
+  GstParallelizedTaskJob *job;
+  GThreadPool *pool = NULL;
+  guint n_threads = self->n_threads;
+  guint i;
+
+  if (n_threads == 1) {
+    func (task_data[0]);
+    return;
+  }
+
+  job = g_slice_new0 (GstParallelizedTaskJob);
+  job->refcount = 1;
+  job->func = func;
+  job->task_data = task_data;
+  job->n_tasks = n_threads;
+  job->n_todo = n_threads;
+  job->n_done = 0;
+  g_mutex_init (&job->lock);
+  g_cond_init (&job->cond_done);
+
+  pool = gst_parallelized_task_get_pool ();
+  if (pool) {
+    for (i = 1; i < n_threads; i++) {
+      GError *err = NULL;
+
+      /* a failed push only means that no new thread could be spawned, the
+       * job is queued anyway and will be run and unreffed by an existing
+       * thread. The tasks are taken by whoever gets to them first. */
+      g_atomic_int_inc (&job->refcount);
+      if (!g_thread_pool_push (pool, job, &err)) {
+        GST_WARNING ("failed to spawn a thread for task: %s", err->message);
+        g_clear_error (&err);
+      }
+    }
+  }
+
+  gst_parallelized_task_job_work (job);
+
+  g_mutex_lock (&job->lock);
+  while (job->n_done < job->n_tasks)
+    g_cond_wait (&job->cond_done, &job->lock);
+  g_mutex_unlock (&job->lock);
+
+  gst_parallelized_task_job_unref (job);
+}
+
+G_END_DECLS
+
+#endif /* __GST_PARALLELIZED_TASK_PRIVATE_H__ */
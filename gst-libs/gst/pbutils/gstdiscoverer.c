@@ -50,6 +50,8 @@
 
 #include <string.h>
 
+#include <glib/gstdio.h>
+
 #include "pbutils.h"
 #include "pbutils-private.h"
 
@@ -95,8 +97,16 @@ struct _GstDiscovererPrivate
   /* TRUE if discoverer has been started */
   gboolean running;
 
+  /* load discovered information from and save it to the on-disk cache */
+  gboolean use_cache;
+
+  /* stop at parsed streams instead of decoding them */
+  gboolean parse_only;
+
   /* current items */
   GstDiscovererInfo *current_info;
+  /* TRUE if current_info was loaded from the cache */
+  gboolean current_from_cache;
   GError *current_error;
   GstStructure *current_topology;
 
@@ -133,7 +143,14 @@ struct _GstDiscovererPrivate
   gulong no_more_pads_id;
   gulong source_chg_id;
   gulong element_added_id;
+  gulong autoplug_select_id;
   gulong bus_cb_id;
+
+  /* worker discoverers for discovering several URIs in parallel */
+  guint n_workers;
+  guint running_workers;        /* n_workers as of the last start */
+  GPtrArray *workers;
+  GQueue idle_workers;
 };
 
 #define DISCO_LOCK(dc) g_mutex_lock (&dc->priv->lock);
@@ -167,11 +184,24 @@ enum
 };
 
 #define DEFAULT_PROP_TIMEOUT 15 * GST_SECOND
+#define DEFAULT_PROP_WORKERS 1
+#define DEFAULT_PROP_USE_CACHE FALSE
+#define DEFAULT_PROP_PARSE_ONLY FALSE
 
 enum
 {
   PROP_0,
-  PROP_TIMEOUT
+  PROP_TIMEOUT,
+  PROP_WORKERS,
+  PROP_USE_CACHE,
+  PROP_PARSE_ONLY
+};
+
+/* values of GstAutoplugSelectResult, which lives in the playback plugin */
+enum
+{
+  AUTOPLUG_SELECT_TRY,
+  AUTOPLUG_SELECT_EXPOSE
 };
 
 static guint gst_discoverer_signals[LAST_SIGNAL] = { 0 };
@@ -179,6 +209,7 @@ static guint gst_discoverer_signals[LAST_SIGNAL] = { 0 };
 static void gst_discoverer_set_timeout (GstDiscoverer * dc,
     GstClockTime timeout);
 static gboolean async_timeout_cb (GstDiscoverer * dc);
+static gboolean async_cached_cb (GstDiscoverer * dc);
 
 static void discoverer_bus_cb (GstBus * bus, GstMessage * msg,
     GstDiscoverer * dc);
@@ -226,6 +257,58 @@ gst_discoverer_class_init (GstDiscovererClass * klass)
           GST_SECOND, 3600 * GST_SECOND, DEFAULT_PROP_TIMEOUT,
           G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstDiscoverer:workers:
+   *
+   * The number of URIs that are discovered in parallel in asynchronous mode,
+   * each one with a pipeline of its own. The pending URIs are handed to the
+   * workers in the order they were added, but #GstDiscoverer::discovered is
+   * emitted as each of them completes, so not necessarily in that order.
+   *
+   * Changes only take effect the next time gst_discoverer_start() is called.
+   * Synchronous discovery always handles one URI at a time.
+   *
+   * Since: 1.14
+   */
+  g_object_class_install_property (gobject_class, PROP_WORKERS,
+      g_param_spec_uint ("workers", "Workers",
+          "Number of URIs to discover in parallel in asynchronous mode",
+          1, 64, DEFAULT_PROP_WORKERS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstDiscoverer:use-cache:
+   *
+   * Whether to cache the information discovered on local files on disk, in
+   * the user cache directory, and use it instead of discovering the file
+   * again as long as it has the same size and modification time.
+   *
+   * Only successful results are cached.
+   *
+   * Since: 1.14
+   */
+  g_object_class_install_property (gobject_class, PROP_USE_CACHE,
+      g_param_spec_boolean ("use-cache", "Use cache",
+          "Use the on-disk cache of discovered information for local files",
+          DEFAULT_PROP_USE_CACHE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstDiscoverer:parse-only:
+   *
+   * Whether to only demux and parse the streams, without plugging any
+   * decoders. This is a lot cheaper for most content, and the caps, tags and
+   * duration of the parsed streams are usually all that is needed, but the
+   * stream information will not contain anything that only a decoder can
+   * find out.
+   *
+   * Since: 1.14
+   */
+  g_object_class_install_property (gobject_class, PROP_PARSE_ONLY,
+      g_param_spec_boolean ("parse-only", "Parse only",
+          "Stop at the parsed streams instead of decoding them",
+          DEFAULT_PROP_PARSE_ONLY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /* signals */
   /**
    * GstDiscoverer::finished:
@@ -302,6 +385,23 @@ uridecodebin_element_added_cb (GstElement * uridecodebin,
   }
 }
 
+static gint
+uridecodebin_autoplug_select_cb (GstElement * uridecodebin, GstPad * pad,
+    GstCaps * caps, GstElementFactory * factory, GstDiscoverer * dc)
+{
+  /* In parse-only mode, expose the stream as soon as it would go into a
+   * decoder, demuxers and parsers are still plugged */
+  if (dc->priv->parse_only &&
+      gst_element_factory_list_is_type (factory,
+          GST_ELEMENT_FACTORY_TYPE_DECODER)) {
+    GST_DEBUG_OBJECT (dc, "Not plugging decoder %s for %" GST_PTR_FORMAT,
+        GST_OBJECT_NAME (factory), caps);
+    return AUTOPLUG_SELECT_EXPOSE;
+  }
+
+  return AUTOPLUG_SELECT_TRY;
+}
+
 static void
 gst_discoverer_init (GstDiscoverer * dc)
 {
@@ -313,6 +413,11 @@ gst_discoverer_init (GstDiscoverer * dc)
 
   dc->priv->timeout = DEFAULT_PROP_TIMEOUT;
   dc->priv->async = FALSE;
+  dc->priv->n_workers = DEFAULT_PROP_WORKERS;
+  dc->priv->running_workers = DEFAULT_PROP_WORKERS;
+  dc->priv->use_cache = DEFAULT_PROP_USE_CACHE;
+  dc->priv->parse_only = DEFAULT_PROP_PARSE_ONLY;
+  g_queue_init (&dc->priv->idle_workers);
 
   g_mutex_init (&dc->priv->lock);
 
@@ -362,6 +467,9 @@ gst_discoverer_init (GstDiscoverer * dc)
   dc->priv->element_added_id =
       g_signal_connect_object (dc->priv->uridecodebin, "element-added",
       G_CALLBACK (uridecodebin_element_added_cb), dc, 0);
+  dc->priv->autoplug_select_id =
+      g_signal_connect_object (dc->priv->uridecodebin, "autoplug-select",
+      G_CALLBACK (uridecodebin_autoplug_select_cb), dc, 0);
   tmp = gst_element_factory_make ("decodebin", NULL);
   dc->priv->decodebin_type = G_OBJECT_TYPE (tmp);
   gst_object_unref (tmp);
@@ -407,6 +515,7 @@ gst_discoverer_dispose (GObject * obj)
     DISCONNECT_SIGNAL (dc->priv->uridecodebin, dc->priv->no_more_pads_id);
     DISCONNECT_SIGNAL (dc->priv->uridecodebin, dc->priv->source_chg_id);
     DISCONNECT_SIGNAL (dc->priv->uridecodebin, dc->priv->element_added_id);
+    DISCONNECT_SIGNAL (dc->priv->uridecodebin, dc->priv->autoplug_select_id);
     DISCONNECT_SIGNAL (dc->priv->bus, dc->priv->bus_cb_id);
 
     /* pipeline was set to NULL in _reset */
@@ -421,6 +530,11 @@ gst_discoverer_dispose (GObject * obj)
 
   gst_discoverer_stop (dc);
 
+  if (dc->priv->workers) {
+    g_ptr_array_unref (dc->priv->workers);
+    dc->priv->workers = NULL;
+  }
+
   if (dc->priv->seeking_query) {
     gst_query_unref (dc->priv->seeking_query);
     dc->priv->seeking_query = NULL;
@@ -449,6 +563,21 @@ gst_discoverer_set_property (GObject * object, guint prop_id,
     case PROP_TIMEOUT:
       gst_discoverer_set_timeout (dc, g_value_get_uint64 (value));
       break;
+    case PROP_WORKERS:
+      DISCO_LOCK (dc);
+      dc->priv->n_workers = g_value_get_uint (value);
+      DISCO_UNLOCK (dc);
+      break;
+    case PROP_USE_CACHE:
+      DISCO_LOCK (dc);
+      dc->priv->use_cache = g_value_get_boolean (value);
+      DISCO_UNLOCK (dc);
+      break;
+    case PROP_PARSE_ONLY:
+      DISCO_LOCK (dc);
+      dc->priv->parse_only = g_value_get_boolean (value);
+      DISCO_UNLOCK (dc);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -467,6 +596,21 @@ gst_discoverer_get_property (GObject * object, guint prop_id,
       g_value_set_uint64 (value, dc->priv->timeout);
       DISCO_UNLOCK (dc);
       break;
+    case PROP_WORKERS:
+      DISCO_LOCK (dc);
+      g_value_set_uint (value, dc->priv->n_workers);
+      DISCO_UNLOCK (dc);
+      break;
+    case PROP_USE_CACHE:
+      DISCO_LOCK (dc);
+      g_value_set_boolean (value, dc->priv->use_cache);
+      DISCO_UNLOCK (dc);
+      break;
+    case PROP_PARSE_ONLY:
+      DISCO_LOCK (dc);
+      g_value_set_boolean (value, dc->priv->parse_only);
+      DISCO_UNLOCK (dc);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1271,6 +1415,116 @@ parse_stream_topology (GstDiscoverer * dc, const GstStructure * topology,
   return res;
 }
 
+/* On-disk cache */
+
+/* bump this whenever the serialized format changes */
+#define CACHE_VERSION 1
+
+/* Returns the cache file for @uri, or NULL if it is not a local file. The
+ * size and modification time of the file are part of the file name, so
+ * changing the file invalidates its cache entry. Parse-only results are
+ * cached separately */
+static gchar *
+discoverer_get_cache_filename (const gchar * uri, gboolean parse_only)
+{
+  GStatBuf file_status;
+  gchar *filename, *key, *checksum, *basename, *cache_filename;
+
+  if (!gst_uri_has_protocol (uri, "file"))
+    return NULL;
+
+  filename = g_filename_from_uri (uri, NULL, NULL);
+  if (filename == NULL)
+    return NULL;
+
+  if (g_stat (filename, &file_status) != 0) {
+    g_free (filename);
+    return NULL;
+  }
+  g_free (filename);
+
+  key = g_strdup_printf ("%d:%d:%s:%" G_GINT64_FORMAT ":%" G_GINT64_FORMAT,
+      CACHE_VERSION, parse_only, uri, (gint64) file_status.st_size,
+      (gint64) file_status.st_mtime);
+  checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA1, key, -1);
+  basename = g_strconcat (checksum, ".gstdiscoverer", NULL);
+  cache_filename = g_build_filename (g_get_user_cache_dir (),
+      "gstreamer-" GST_API_VERSION, "discoverer", basename, NULL);
+
+  g_free (basename);
+  g_free (checksum);
+  g_free (key);
+
+  return cache_filename;
+}
+
+static GstDiscovererInfo *
+discoverer_load_from_cache (GstDiscoverer * dc, const gchar * uri)
+{
+  GstDiscovererInfo *info = NULL;
+  GVariant *variant;
+  gchar *cache_filename, *data;
+  gsize length;
+
+  cache_filename = discoverer_get_cache_filename (uri, dc->priv->parse_only);
+  if (cache_filename == NULL)
+    return NULL;
+
+  if (!g_file_get_contents (cache_filename, &data, &length, NULL)) {
+    GST_LOG_OBJECT (dc, "no cache entry for %s", uri);
+    g_free (cache_filename);
+    return NULL;
+  }
+
+  variant = g_variant_new_from_data (G_VARIANT_TYPE_VARIANT, data, length,
+      FALSE, g_free, data);
+  g_variant_ref_sink (variant);
+
+  if (g_variant_is_normal_form (variant)) {
+    info = gst_discoverer_info_from_variant (variant);
+    GST_DEBUG_OBJECT (dc, "loaded %s from cache %s", uri, cache_filename);
+  } else {
+    GST_WARNING_OBJECT (dc, "ignoring corrupt cache entry %s", cache_filename);
+  }
+
+  g_variant_unref (variant);
+  g_free (cache_filename);
+
+  return info;
+}
+
+static void
+discoverer_save_to_cache (GstDiscoverer * dc, GstDiscovererInfo * info)
+{
+  GError *err = NULL;
+  GVariant *variant;
+  gchar *cache_filename, *cache_dir;
+
+  cache_filename =
+      discoverer_get_cache_filename (info->uri, dc->priv->parse_only);
+  if (cache_filename == NULL)
+    return;
+
+  cache_dir = g_path_get_dirname (cache_filename);
+  g_mkdir_with_parents (cache_dir, 0700);
+  g_free (cache_dir);
+
+  variant = gst_discoverer_info_to_variant (info, GST_DISCOVERER_SERIALIZE_ALL);
+  g_variant_ref_sink (variant);
+
+  if (!g_file_set_contents (cache_filename, g_variant_get_data (variant),
+          g_variant_get_size (variant), &err)) {
+    GST_WARNING_OBJECT (dc, "couldn't write cache entry %s: %s",
+        cache_filename, err->message);
+    g_clear_error (&err);
+  } else {
+    GST_DEBUG_OBJECT (dc, "saved %s to cache %s", info->uri, cache_filename);
+  }
+
+  g_variant_unref (variant);
+  g_free (cache_filename);
+}
+
 /* Called when pipeline is pre-rolled */
 static void
 discoverer_collect (GstDiscoverer * dc)
@@ -1364,6 +1618,10 @@ discoverer_collect (GstDiscoverer * dc)
     }
   }
 
+  if (dc->priv->use_cache && !dc->priv->current_from_cache &&
+      dc->priv->current_info->result == GST_DISCOVERER_OK)
+    discoverer_save_to_cache (dc, dc->priv->current_info);
+
   if (dc->priv->async) {
     GST_DEBUG ("Emitting 'discoverered'");
     g_signal_emit (dc, gst_discoverer_signals[SIGNAL_DISCOVERED], 0,
@@ -1399,6 +1657,16 @@ handle_current_async (GstDiscoverer * dc)
     get_async_cb,
   };
 
+  if (dc->priv->current_from_cache) {
+    /* nothing to wait for, just report it from the main context */
+    source = g_idle_source_new ();
+    g_source_set_callback (source, (GSourceFunc) async_cached_cb,
+        g_object_ref (dc), g_object_unref);
+    dc->priv->timeoutid = g_source_attach (source, dc->priv->ctx);
+    g_source_unref (source);
+    return;
+  }
+
   /* Attach a timeout to the main context */
   source = g_timeout_source_new (dc->priv->timeout / GST_MSECOND);
   g_source_set_callback_indirect (source, g_object_ref (dc), &cb_funcs);
@@ -1587,6 +1855,13 @@ handle_current_sync (GstDiscoverer * dc)
   GstMessage *msg;
   gboolean done = FALSE;
 
+  if (dc->priv->current_from_cache) {
+    DISCO_LOCK (dc);
+    dc->priv->processing = FALSE;
+    DISCO_UNLOCK (dc);
+    return;
+  }
+
   timer = g_timer_new ();
   g_timer_start (timer);
 
@@ -1630,6 +1905,20 @@ _setup_locked (GstDiscoverer * dc)
   dc->priv->pending_uris =
       g_list_delete_link (dc->priv->pending_uris, dc->priv->pending_uris);
 
+  if (dc->priv->use_cache) {
+    GstDiscovererInfo *cached;
+
+    cached = discoverer_load_from_cache (dc, dc->priv->current_info->uri);
+    if (cached != NULL) {
+      GST_DEBUG ("Using cached information for %s", cached->uri);
+      gst_discoverer_info_unref (dc->priv->current_info);
+      dc->priv->current_info = cached;
+      dc->priv->current_from_cache = TRUE;
+      dc->priv->processing = TRUE;
+      return;
+    }
+  }
+
   /* set uri on uridecodebin */
   g_object_set (dc->priv->uridecodebin, "uri", dc->priv->current_info->uri,
       NULL);
@@ -1688,6 +1977,7 @@ discoverer_cleanup (GstDiscoverer * dc)
   }
 
   dc->priv->current_info = NULL;
+  dc->priv->current_from_cache = FALSE;
 
   dc->priv->pending_subtitle_pads = 0;
 
@@ -1729,6 +2019,18 @@ discoverer_bus_cb (GstBus * bus, GstMessage * msg, GstDiscoverer * dc)
   }
 }
 
+static gboolean
+async_cached_cb (GstDiscoverer * dc)
+{
+  if (!g_source_is_destroyed (g_main_current_source ())) {
+    dc->priv->timeoutid = 0;
+    dc->priv->processing = FALSE;
+    discoverer_collect (dc);
+    discoverer_cleanup (dc);
+  }
+  return FALSE;
+}
+
 static gboolean
 async_timeout_cb (GstDiscoverer * dc)
 {
@@ -2097,6 +2399,143 @@ out:
   return sinfo;
 }
 
+/* Worker pool */
+
+static void
+worker_discovered_cb (GstDiscoverer * worker, GstDiscovererInfo * info,
+    const GError * err, GstDiscoverer * dc)
+{
+  g_signal_emit (dc, gst_discoverer_signals[SIGNAL_DISCOVERED], 0, info, err);
+}
+
+static void
+worker_source_setup_cb (GstDiscoverer * worker, GstElement * source,
+    GstDiscoverer * dc)
+{
+  g_signal_emit (dc, gst_discoverer_signals[SIGNAL_SOURCE_SETUP], 0, source);
+}
+
+/* Hands pending URIs to idle workers, and emits "finished" once all workers
+ * are idle and there is nothing left to hand out */
+static void
+discoverer_dispatch_to_workers (GstDiscoverer * dc)
+{
+  GstDiscoverer *worker;
+  gboolean finished;
+  gchar *uri;
+
+  DISCO_LOCK (dc);
+  while (dc->priv->running && dc->priv->pending_uris != NULL &&
+      !g_queue_is_empty (&dc->priv->idle_workers)) {
+    worker = g_queue_pop_head (&dc->priv->idle_workers);
+    uri = (gchar *) dc->priv->pending_uris->data;
+    dc->priv->pending_uris =
+        g_list_delete_link (dc->priv->pending_uris, dc->priv->pending_uris);
+    DISCO_UNLOCK (dc);
+
+    GST_DEBUG_OBJECT (dc, "handing %s to worker %p", uri, worker);
+    gst_discoverer_discover_uri_async (worker, uri);
+    g_free (uri);
+
+    DISCO_LOCK (dc);
+  }
+  finished = dc->priv->running && dc->priv->pending_uris == NULL &&
+      g_queue_get_length (&dc->priv->idle_workers) == dc->priv->workers->len;
+  DISCO_UNLOCK (dc);
+
+  if (finished) {
+    GST_DEBUG_OBJECT (dc, "all workers are idle, we're done");
+    g_signal_emit (dc, gst_discoverer_signals[SIGNAL_FINISHED], 0);
+  }
+}
+
+/* workers only ever get one URI at a time, so they are done with it when
+ * they emit "finished" */
+static void
+worker_finished_cb (GstDiscoverer * worker, GstDiscoverer * dc)
+{
+  DISCO_LOCK (dc);
+  g_queue_push_tail (&dc->priv->idle_workers, worker);
+  DISCO_UNLOCK (dc);
+
+  discoverer_dispatch_to_workers (dc);
+}
+
+static void
+discoverer_start_workers (GstDiscoverer * dc)
+{
+  GstDiscoverer *worker;
+  GPtrArray *workers, *old_workers = NULL;
+  gboolean have_pending;
+  guint i;
+
+  /* workers are kept around between start and stop, unless their number
+   * changed in the meantime. The array is only replaced with the lock held
+   * because gst_discoverer_discover_uri_async() checks it. */
+  workers = dc->priv->workers;
+  if (workers && workers->len != dc->priv->running_workers) {
+    old_workers = workers;
+    workers = NULL;
+  }
+
+  if (workers == NULL) {
+    workers = g_ptr_array_new_with_free_func (g_object_unref);
+
+    for (i = 0; i < dc->priv->running_workers; i++) {
+      worker = g_object_new (GST_TYPE_DISCOVERER, "timeout", dc->priv->timeout,
+          NULL);
+      g_signal_connect (worker, "discovered",
+          G_CALLBACK (worker_discovered_cb), dc);
+      g_signal_connect (worker, "source-setup",
+          G_CALLBACK (worker_source_setup_cb), dc);
+      g_signal_connect (worker, "finished", G_CALLBACK (worker_finished_cb),
+          dc);
+      g_ptr_array_add (workers, worker);
+    }
+  }
+
+  GST_DEBUG_OBJECT (dc, "starting %u workers", workers->len);
+
+  for (i = 0; i < workers->len; i++) {
+    worker = g_ptr_array_index (workers, i);
+    g_object_set (worker, "timeout", dc->priv->timeout, "use-cache",
+        dc->priv->use_cache, "parse-only", dc->priv->parse_only, NULL);
+    gst_discoverer_start (worker);
+  }
+
+  DISCO_LOCK (dc);
+  dc->priv->workers = workers;
+  for (i = 0; i < workers->len; i++)
+    g_queue_push_tail (&dc->priv->idle_workers, g_ptr_array_index (workers,
+            i));
+  have_pending = (dc->priv->pending_uris != NULL);
+  DISCO_UNLOCK (dc);
+
+  if (old_workers)
+    g_ptr_array_unref (old_workers);
+
+  if (have_pending) {
+    g_signal_emit (dc, gst_discoverer_signals[SIGNAL_STARTING], 0);
+    discoverer_dispatch_to_workers (dc);
+  }
+}
+
+static void
+discoverer_stop_workers (GstDiscoverer * dc)
+{
+  guint i;
+
+  DISCO_LOCK (dc);
+  g_queue_clear (&dc->priv->idle_workers);
+  DISCO_UNLOCK (dc);
+
+  if (dc->priv->workers == NULL)
+    return;
+
+  for (i = 0; i < dc->priv->workers->len; i++)
+    gst_discoverer_stop (g_ptr_array_index (dc->priv->workers, i));
+}
+
 /**
  * gst_discoverer_start:
  * @discoverer: A #GstDiscoverer
@@ -2110,6 +2549,7 @@ gst_discoverer_start (GstDiscoverer * discoverer)
 {
   GSource *source;
   GMainContext *ctx = NULL;
+  GPtrArray *workers;
 
   g_return_if_fail (GST_IS_DISCOVERER (discoverer));
 
@@ -2121,7 +2561,25 @@ gst_discoverer_start (GstDiscoverer * discoverer)
   }
 
   discoverer->priv->async = TRUE;
+  /* changes of the number of workers only apply to the next start */
+  DISCO_LOCK (discoverer);
   discoverer->priv->running = TRUE;
+  discoverer->priv->running_workers = discoverer->priv->n_workers;
+  DISCO_UNLOCK (discoverer);
+
+  if (discoverer->priv->running_workers > 1) {
+    discoverer_start_workers (discoverer);
+    GST_DEBUG_OBJECT (discoverer, "Started");
+    return;
+  }
+
+  /* not using the workers of a previous run this time */
+  DISCO_LOCK (discoverer);
+  workers = discoverer->priv->workers;
+  discoverer->priv->workers = NULL;
+  DISCO_UNLOCK (discoverer);
+  if (workers)
+    g_ptr_array_unref (workers);
 
   ctx = g_main_context_get_thread_default ();
 
@@ -2136,7 +2594,8 @@ gst_discoverer_start (GstDiscoverer * discoverer)
   g_source_unref (source);
   discoverer->priv->ctx = g_main_context_ref (ctx);
 
-  start_discovering (discoverer);
+  if (discoverer->priv->pending_uris != NULL)
+    start_discovering (discoverer);
   GST_DEBUG_OBJECT (discoverer, "Started");
 }
 
@@ -2174,6 +2633,8 @@ gst_discoverer_stop (GstDiscoverer * discoverer)
   discoverer->priv->running = FALSE;
   DISCO_UNLOCK (discoverer);
 
+  discoverer_stop_workers (discoverer);
+
   /* Remove timeout handler */
   if (discoverer->priv->timeoutid) {
     g_source_remove (discoverer->priv->timeoutid);
@@ -2215,7 +2676,8 @@ gboolean
 gst_discoverer_discover_uri_async (GstDiscoverer * discoverer,
     const gchar * uri)
 {
-  gboolean can_run;
+  gboolean can_run, use_workers;
+  guint n_workers;
 
   g_return_val_if_fail (GST_IS_DISCOVERER (discoverer), FALSE);
 
@@ -2225,10 +2687,19 @@ gst_discoverer_discover_uri_async (GstDiscoverer * discoverer,
   can_run = (discoverer->priv->pending_uris == NULL);
   discoverer->priv->pending_uris =
       g_list_append (discoverer->priv->pending_uris, g_strdup (uri));
+  use_workers = discoverer->priv->running && discoverer->priv->workers != NULL;
+  if (discoverer->priv->running)
+    n_workers = discoverer->priv->running_workers;
+  else
+    n_workers = discoverer->priv->n_workers;
   DISCO_UNLOCK (discoverer);
 
-  if (can_run)
+  if (use_workers) {
+    discoverer_dispatch_to_workers (discoverer);
+  } else if (can_run && n_workers == 1) {
+    /* with workers, this is handed out once we're started */
     start_discovering (discoverer);
+  }
 
   return TRUE;
 }
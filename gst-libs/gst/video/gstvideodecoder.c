@@ -336,7 +336,11 @@ struct _GstVideoDecoderPrivate
   /* relative offset of frame */
   guint64 frame_offset;
   /* tracking ts and offsets */
-  GList *timestamps;
+  GQueue timestamps;
+  /* Timestamp records kept for reuse */
+  GQueue free_timestamps;
+  guint64 timestamps_allocated;
+  guint64 timestamps_reused;
 
   /* last outgoing ts */
   GstClockTime last_timestamp_out;
@@ -369,7 +373,11 @@ struct _GstVideoDecoderPrivate
   guint32 system_frame_number;
   guint32 decode_frame_number;
 
-  GList *frames;                /* Protected with OBJECT_LOCK */
+  /* pending frames, oldest first, and an index of their links by
+   * system_frame_number for constant time lookup and removal */
+  GQueue frames;                /* Protected with OBJECT_LOCK */
+  GHashTable *frames_index;
+  GstVideoCodecFramePool *frame_pool;
   GstVideoCodecState *input_state;
   GstVideoCodecState *output_state;     /* OBJECT_LOCK and STREAM_LOCK */
   gboolean output_state_changed;
@@ -402,6 +410,18 @@ struct _GstVideoDecoderPrivate
   /* flags */
   gboolean use_default_pad_acceptcaps;
 
+  /* frame-parallel decoding, see gst_video_decoder_set_frame_threads() */
+  guint frame_threads;          /* Set with STREAM_LOCK and OBJECT_LOCK */
+  GThreadPool *frame_thread_pool;
+  GMutex parallel_lock;
+  GCond parallel_cond;
+  /* dispatched frames in decoding order that were not output yet */
+  GQueue parallel_jobs;         /* Protected with parallel_lock */
+  /* dispatched frames that a worker is still busy with */
+  guint parallel_pending;       /* Protected with parallel_lock */
+  /* first flow error returned by a worker */
+  GstFlowReturn parallel_ret;   /* Protected with parallel_lock */
+
 #ifndef GST_DISABLE_DEBUG
   /* Diagnostic time for reporting the time
    * from flush to first output */
@@ -409,12 +429,20 @@ struct _GstVideoDecoderPrivate
 #endif
 };
 
+enum
+{
+  PROP_0,
+  PROP_ALLOC_STATS
+};
+
 static GstElementClass *parent_class = NULL;
 static void gst_video_decoder_class_init (GstVideoDecoderClass * klass);
 static void gst_video_decoder_init (GstVideoDecoder * dec,
     GstVideoDecoderClass * klass);
 
 static void gst_video_decoder_finalize (GObject * object);
+static void gst_video_decoder_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
 
 static gboolean gst_video_decoder_setcaps (GstVideoDecoder * dec,
     GstCaps * caps);
@@ -448,6 +476,9 @@ static GstFlowReturn gst_video_decoder_flush_parse (GstVideoDecoder * dec,
     gboolean at_eos);
 
 static void gst_video_decoder_clear_queues (GstVideoDecoder * dec);
+static GstFlowReturn gst_video_decoder_parallel_wait (GstVideoDecoder *
+    decoder, guint max_pending);
+static void gst_video_decoder_trim_timestamps (GstVideoDecoder * decoder);
 
 static gboolean gst_video_decoder_sink_event_default (GstVideoDecoder * decoder,
     GstEvent * event);
@@ -514,6 +545,7 @@ gst_video_decoder_class_init (GstVideoDecoderClass * klass)
   g_type_class_add_private (klass, sizeof (GstVideoDecoderPrivate));
 
   gobject_class->finalize = gst_video_decoder_finalize;
+  gobject_class->get_property = gst_video_decoder_get_property;
 
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_video_decoder_change_state);
@@ -526,6 +558,27 @@ gst_video_decoder_class_init (GstVideoDecoderClass * klass)
   klass->sink_query = gst_video_decoder_sink_query_default;
   klass->src_query = gst_video_decoder_src_query_default;
   klass->transform_meta = gst_video_decoder_transform_meta_default;
+
+  /**
+   * GstVideoDecoder:alloc-stats:
+   *
+   * Statistics about the per-frame records allocated by the base class since
+   * the element was created. The structure contains the following fields:
+   *
+   *   * `frames-allocated`: #G_TYPE_UINT64, frames that had to be allocated
+   *   * `frames-reused`: #G_TYPE_UINT64, frames that were reused from the
+   *      element's pool of finished frames
+   *   * `timestamps-allocated`: #G_TYPE_UINT64, timestamp records that had
+   *      to be allocated
+   *   * `timestamps-reused`: #G_TYPE_UINT64, timestamp records that were
+   *      reused
+   *
+   * Since: 1.14
+   */
+  g_object_class_install_property (gobject_class, PROP_ALLOC_STATS,
+      g_param_spec_boxed ("alloc-stats", "Allocation statistics",
+          "Statistics about per-frame allocations", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -576,9 +629,58 @@ gst_video_decoder_init (GstVideoDecoder * decoder, GstVideoDecoderClass * klass)
   decoder->priv->min_latency = 0;
   decoder->priv->max_latency = 0;
 
+  g_queue_init (&decoder->priv->frames);
+  decoder->priv->frames_index = g_hash_table_new (NULL, NULL);
+  decoder->priv->frame_pool = __gst_video_codec_frame_pool_new ();
+  g_queue_init (&decoder->priv->timestamps);
+  g_queue_init (&decoder->priv->free_timestamps);
+
+  decoder->priv->frame_threads = 1;
+  g_mutex_init (&decoder->priv->parallel_lock);
+  g_cond_init (&decoder->priv->parallel_cond);
+  g_queue_init (&decoder->priv->parallel_jobs);
+
   gst_video_decoder_reset (decoder, TRUE, TRUE);
 }
 
+static GstStructure *
+gst_video_decoder_create_alloc_stats (GstVideoDecoder * decoder)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  guint64 frames_allocated, frames_reused;
+  GstStructure *s;
+
+  __gst_video_codec_frame_pool_get_stats (priv->frame_pool,
+      &frames_allocated, &frames_reused);
+
+  GST_VIDEO_DECODER_STREAM_LOCK (decoder);
+  s = gst_structure_new ("application/x-video-decoder-alloc-stats",
+      "frames-allocated", G_TYPE_UINT64, frames_allocated,
+      "frames-reused", G_TYPE_UINT64, frames_reused,
+      "timestamps-allocated", G_TYPE_UINT64, priv->timestamps_allocated,
+      "timestamps-reused", G_TYPE_UINT64, priv->timestamps_reused, NULL);
+  GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
+
+  return s;
+}
+
+static void
+gst_video_decoder_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstVideoDecoder *decoder = GST_VIDEO_DECODER (object);
+
+  switch (prop_id) {
+    case PROP_ALLOC_STATS:
+      g_value_take_boxed (value,
+          gst_video_decoder_create_alloc_stats (decoder));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
 static GstVideoCodecState *
 _new_input_state (GstCaps * caps)
 {
@@ -770,6 +872,17 @@ gst_video_decoder_finalize (GObject * object)
     decoder->priv->allocator = NULL;
   }
 
+  if (decoder->priv->frame_thread_pool) {
+    g_thread_pool_free (decoder->priv->frame_thread_pool, FALSE, TRUE);
+    decoder->priv->frame_thread_pool = NULL;
+  }
+  g_mutex_clear (&decoder->priv->parallel_lock);
+  g_cond_clear (&decoder->priv->parallel_cond);
+
+  g_hash_table_destroy (decoder->priv->frames_index);
+  __gst_video_codec_frame_pool_free (decoder->priv->frame_pool);
+  gst_video_decoder_trim_timestamps (decoder);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -1296,7 +1409,7 @@ gst_video_decoder_sink_event_default (GstVideoDecoder * decoder,
       GList *l;
 
       GST_VIDEO_DECODER_STREAM_LOCK (decoder);
-      for (l = priv->frames; l; l = l->next) {
+      for (l = priv->frames.head; l; l = l->next) {
         GstVideoCodecFrame *frame = l->data;
 
         frame->events = _flush_events (decoder->srcpad, frame->events);
@@ -1382,6 +1495,23 @@ gst_video_decoder_sink_event (GstPad * pad, GstObject * parent,
   GST_DEBUG_OBJECT (decoder, "received event %d, %s", GST_EVENT_TYPE (event),
       GST_EVENT_TYPE_NAME (event));
 
+  /* serialized events apply after all frames that are being decoded by
+   * the frame threads. Their errors are otherwise only returned from the next
+   * chain call, which never comes for the last frames before EOS */
+  if (GST_EVENT_IS_SERIALIZED (event)
+      && GST_EVENT_TYPE (event) != GST_EVENT_FLUSH_STOP) {
+    GstFlowReturn flow = gst_video_decoder_parallel_wait (decoder, 0);
+
+    if (G_UNLIKELY (flow < GST_FLOW_EOS)) {
+      GST_DEBUG_OBJECT (decoder, "frame threads returned %s, failing %s",
+          gst_flow_get_name (flow), GST_EVENT_TYPE_NAME (event));
+      if (GST_EVENT_TYPE (event) == GST_EVENT_EOS)
+        GST_ELEMENT_FLOW_ERROR (decoder, flow);
+      gst_event_unref (event);
+      return FALSE;
+    }
+  }
+
   if (decoder_class->sink_event)
     ret = decoder_class->sink_event (decoder, event);
 
@@ -1693,6 +1823,16 @@ gst_video_decoder_src_query_default (GstVideoDecoder * dec, GstQuery * query)
           max_latency = GST_CLOCK_TIME_NONE;
         else
           max_latency += dec->priv->max_latency;
+        /* with frame threads, a frame can take up to one frame duration
+         * per thread to come out */
+        if (dec->priv->frame_threads > 1) {
+          GstClockTime parallel_latency = (dec->priv->frame_threads - 1) *
+              dec->priv->qos_frame_duration;
+
+          min_latency += parallel_latency;
+          if (max_latency != GST_CLOCK_TIME_NONE)
+            max_latency += parallel_latency;
+        }
         GST_OBJECT_UNLOCK (dec);
 
         gst_query_set_latency (query, live, min_latency, max_latency);
@@ -1879,9 +2019,13 @@ gst_video_decoder_sink_query (GstPad * pad, GstObject * parent,
   return ret;
 }
 
+/* maximum number of Timestamp records kept for reuse */
+#define MAX_POOLED_TIMESTAMPS 64
+
 typedef struct _Timestamp Timestamp;
 struct _Timestamp
 {
+  GList link;                   /* in timestamps or free_timestamps */
   guint64 offset;
   GstClockTime pts;
   GstClockTime dts;
@@ -1895,6 +2039,47 @@ timestamp_free (Timestamp * ts)
   g_slice_free (Timestamp, ts);
 }
 
+static Timestamp *
+gst_video_decoder_acquire_timestamp (GstVideoDecoder * decoder)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  GList *link;
+  Timestamp *ts;
+
+  if ((link = g_queue_pop_head_link (&priv->free_timestamps))) {
+    ts = link->data;
+    priv->timestamps_reused++;
+  } else {
+    ts = g_slice_new (Timestamp);
+    ts->link.data = ts;
+    priv->timestamps_allocated++;
+  }
+  ts->link.prev = ts->link.next = NULL;
+
+  return ts;
+}
+
+static void
+gst_video_decoder_release_timestamp (GstVideoDecoder * decoder, Timestamp * ts)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+
+  if (priv->free_timestamps.length < MAX_POOLED_TIMESTAMPS)
+    g_queue_push_head_link (&priv->free_timestamps, &ts->link);
+  else
+    timestamp_free (ts);
+}
+
+static void
+gst_video_decoder_trim_timestamps (GstVideoDecoder * decoder)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  GList *link;
+
+  while ((link = g_queue_pop_head_link (&priv->free_timestamps)))
+    timestamp_free (link->data);
+}
+
 static void
 gst_video_decoder_add_buffer_info (GstVideoDecoder * decoder,
     GstBuffer * buffer)
@@ -1911,7 +2096,7 @@ gst_video_decoder_add_buffer_info (GstVideoDecoder * decoder,
     return;
   }
 
-  ts = g_slice_new (Timestamp);
+  ts = gst_video_decoder_acquire_timestamp (decoder);
 
   GST_LOG_OBJECT (decoder,
       "adding PTS %" GST_TIME_FORMAT " DTS %" GST_TIME_FORMAT
@@ -1925,7 +2110,7 @@ gst_video_decoder_add_buffer_info (GstVideoDecoder * decoder,
   ts->duration = GST_BUFFER_DURATION (buffer);
   ts->flags = GST_BUFFER_FLAGS (buffer);
 
-  priv->timestamps = g_list_append (priv->timestamps, ts);
+  g_queue_push_tail_link (&priv->timestamps, &ts->link);
 }
 
 static void
@@ -1937,30 +2122,25 @@ gst_video_decoder_get_buffer_info_at_offset (GstVideoDecoder *
   guint64 got_offset = 0;
 #endif
   Timestamp *ts;
-  GList *g;
 
   *pts = GST_CLOCK_TIME_NONE;
   *dts = GST_CLOCK_TIME_NONE;
   *duration = GST_CLOCK_TIME_NONE;
   *flags = 0;
 
-  g = decoder->priv->timestamps;
-  while (g) {
-    ts = g->data;
-    if (ts->offset <= offset) {
+  while ((ts = g_queue_peek_head (&decoder->priv->timestamps))) {
+    if (ts->offset > offset)
+      break;
+
 #ifndef GST_DISABLE_GST_DEBUG
-      got_offset = ts->offset;
+    got_offset = ts->offset;
 #endif
-      *pts = ts->pts;
-      *dts = ts->dts;
-      *duration = ts->duration;
-      *flags = ts->flags;
-      g = g->next;
-      decoder->priv->timestamps = g_list_remove (decoder->priv->timestamps, ts);
-      timestamp_free (ts);
-    } else {
-      break;
-    }
+    *pts = ts->pts;
+    *dts = ts->dts;
+    *duration = ts->duration;
+    *flags = ts->flags;
+    g_queue_pop_head_link (&decoder->priv->timestamps);
+    gst_video_decoder_release_timestamp (decoder, ts);
   }
 
   GST_LOG_OBJECT (decoder,
@@ -1987,8 +2167,9 @@ gst_video_decoder_clear_queues (GstVideoDecoder * dec)
   g_list_free_full (priv->parse_gather,
       (GDestroyNotify) gst_video_codec_frame_unref);
   priv->parse_gather = NULL;
-  g_list_free_full (priv->frames, (GDestroyNotify) gst_video_codec_frame_unref);
-  priv->frames = NULL;
+  g_queue_foreach (&priv->frames, (GFunc) gst_video_codec_frame_unref, NULL);
+  g_queue_clear (&priv->frames);
+  g_hash_table_remove_all (priv->frames_index);
 }
 
 static void
@@ -1996,6 +2177,7 @@ gst_video_decoder_reset (GstVideoDecoder * decoder, gboolean full,
     gboolean flush_hard)
 {
   GstVideoDecoderPrivate *priv = decoder->priv;
+  GList *link;
 
   GST_DEBUG_OBJECT (decoder, "reset full %d", full);
 
@@ -2023,6 +2205,10 @@ gst_video_decoder_reset (GstVideoDecoder * decoder, gboolean full,
     priv->had_output_data = FALSE;
     priv->had_input_data = FALSE;
 
+    g_mutex_lock (&priv->parallel_lock);
+    priv->parallel_ret = GST_FLOW_OK;
+    g_mutex_unlock (&priv->parallel_lock);
+
     GST_OBJECT_LOCK (decoder);
     priv->earliest_time = GST_CLOCK_TIME_NONE;
     priv->proportion = 0.5;
@@ -2082,8 +2268,14 @@ gst_video_decoder_reset (GstVideoDecoder * decoder, gboolean full,
   priv->frame_offset = 0;
   gst_adapter_clear (priv->input_adapter);
   gst_adapter_clear (priv->output_adapter);
-  g_list_free_full (priv->timestamps, (GDestroyNotify) timestamp_free);
-  priv->timestamps = NULL;
+  while ((link = g_queue_pop_head_link (&priv->timestamps)))
+    gst_video_decoder_release_timestamp (decoder, link->data);
+
+  /* don't keep cached frames and timestamps around over a hard flush */
+  if (full || flush_hard) {
+    __gst_video_codec_frame_pool_trim (priv->frame_pool);
+    gst_video_decoder_trim_timestamps (decoder);
+  }
 
   GST_OBJECT_LOCK (decoder);
   priv->bytes_out = 0;
@@ -2097,6 +2289,215 @@ gst_video_decoder_reset (GstVideoDecoder * decoder, gboolean full,
   GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
 }
 
+/* Frame-parallel decoding
+ *
+ * Sync point frames are handed to handle_frame() from a pool of worker
+ * threads. Whatever the subclass does with such a frame in handle_frame()
+ * (finish, drop or release it) is recorded in its job, and the jobs are
+ * replayed in decoding order from the head of the queue as soon as they are
+ * done. The streaming thread never waits for the workers while holding the
+ * stream lock, so the subclass can use the base class API from
+ * handle_frame() as usual. */
+typedef enum
+{
+  PARALLEL_JOB_NONE,
+  PARALLEL_JOB_FINISH,
+  PARALLEL_JOB_DROP,
+  PARALLEL_JOB_RELEASE
+} ParallelJobAction;
+
+typedef struct _ParallelJob ParallelJob;
+struct _ParallelJob
+{
+  GList link;                   /* in parallel_jobs */
+  GstVideoDecoder *decoder;
+  GstVideoCodecFrame *frame;
+  ParallelJobAction action;
+  gboolean done;                /* Protected with parallel_lock */
+};
+
+/* the job whose handle_frame() the current thread is running */
+static GPrivate parallel_current_job = G_PRIVATE_INIT (NULL);
+
+/* Waits until at most @max_pending dispatched frames are still being worked
+ * on and returns the first flow error of the workers. Must be called without
+ * the stream lock. */
+static GstFlowReturn
+gst_video_decoder_parallel_wait (GstVideoDecoder * decoder, guint max_pending)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  GstFlowReturn ret;
+
+  g_mutex_lock (&priv->parallel_lock);
+  while (priv->parallel_pending > max_pending)
+    g_cond_wait (&priv->parallel_cond, &priv->parallel_lock);
+  ret = priv->parallel_ret;
+  g_mutex_unlock (&priv->parallel_lock);
+
+  return ret;
+}
+
+/* Called from the chain function, without the stream lock, before @buf is
+ * handled. Buffers that will be dispatched wait for a free frame thread,
+ * all other buffers wait until all previous frames are done. */
+static GstFlowReturn
+gst_video_decoder_parallel_throttle (GstVideoDecoder * decoder,
+    GstBuffer * buf, guint frame_threads)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  guint max_pending = 0;
+
+  if (priv->packetized && decoder->input_segment.rate > 0.0
+      && !GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_DELTA_UNIT)
+      && !GST_BUFFER_IS_DISCONT (buf))
+    max_pending = frame_threads - 1;
+
+  return gst_video_decoder_parallel_wait (decoder, max_pending);
+}
+
+/* Called with the stream lock, which protects frame_threads from changes */
+static gboolean
+gst_video_decoder_parallel_can_dispatch (GstVideoDecoder * decoder,
+    GstVideoCodecFrame * frame)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+
+  return priv->frame_threads > 1 && priv->packetized
+      && decoder->input_segment.rate > 0.0
+      && GST_VIDEO_CODEC_FRAME_IS_SYNC_POINT (frame);
+}
+
+/* Records @action for @frame if it is the frame the current thread was
+ * dispatched for. Returns %FALSE if the call is to be handled right away. */
+static gboolean
+gst_video_decoder_parallel_defer (GstVideoDecoder * decoder,
+    GstVideoCodecFrame * frame, ParallelJobAction action)
+{
+  ParallelJob *job = g_private_get (&parallel_current_job);
+
+  if (job == NULL || job->decoder != decoder || job->frame != frame)
+    return FALSE;
+
+  GST_LOG_OBJECT (decoder, "deferring action %d for frame %u", action,
+      frame->system_frame_number);
+  job->action = action;
+
+  return TRUE;
+}
+
+/* Replays the done jobs at the head of the queue, must be called with the
+ * stream lock */
+static void
+gst_video_decoder_parallel_output (GstVideoDecoder * decoder)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  GstFlowReturn ret;
+  ParallelJob *job;
+
+  g_mutex_lock (&priv->parallel_lock);
+  while ((job = g_queue_peek_head (&priv->parallel_jobs)) && job->done) {
+    g_queue_pop_head_link (&priv->parallel_jobs);
+    g_mutex_unlock (&priv->parallel_lock);
+
+    switch (job->action) {
+      case PARALLEL_JOB_FINISH:
+        ret = gst_video_decoder_finish_frame (decoder, job->frame);
+        break;
+      case PARALLEL_JOB_DROP:
+        ret = gst_video_decoder_drop_frame (decoder, job->frame);
+        break;
+      case PARALLEL_JOB_RELEASE:
+        gst_video_decoder_release_frame (decoder, job->frame);
+        ret = GST_FLOW_OK;
+        break;
+      default:
+        /* the subclass kept the frame for later */
+        ret = GST_FLOW_OK;
+        break;
+    }
+    g_slice_free (ParallelJob, job);
+
+    g_mutex_lock (&priv->parallel_lock);
+    if (ret != GST_FLOW_OK && priv->parallel_ret == GST_FLOW_OK)
+      priv->parallel_ret = ret;
+  }
+  g_mutex_unlock (&priv->parallel_lock);
+}
+
+static void
+gst_video_decoder_parallel_func (gpointer data, gpointer user_data)
+{
+  ParallelJob *job = data;
+  GstVideoDecoder *decoder = user_data;
+  GstVideoDecoderClass *decoder_class = GST_VIDEO_DECODER_GET_CLASS (decoder);
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  GstFlowReturn ret;
+
+  GST_LOG_OBJECT (decoder, "handling frame %u",
+      job->frame->system_frame_number);
+
+  g_private_set (&parallel_current_job, job);
+  ret = decoder_class->handle_frame (decoder, job->frame);
+  g_private_set (&parallel_current_job, NULL);
+
+  g_mutex_lock (&priv->parallel_lock);
+  job->done = TRUE;
+  if (ret != GST_FLOW_OK) {
+    GST_DEBUG_OBJECT (decoder, "flow error %s", gst_flow_get_name (ret));
+    if (priv->parallel_ret == GST_FLOW_OK)
+      priv->parallel_ret = ret;
+  }
+  g_mutex_unlock (&priv->parallel_lock);
+
+  GST_VIDEO_DECODER_STREAM_LOCK (decoder);
+  gst_video_decoder_parallel_output (decoder);
+  GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
+
+  g_mutex_lock (&priv->parallel_lock);
+  priv->parallel_pending--;
+  g_cond_broadcast (&priv->parallel_cond);
+  g_mutex_unlock (&priv->parallel_lock);
+}
+
+/* Hands @frame to a frame thread, must be called with the stream lock */
+static GstFlowReturn
+gst_video_decoder_parallel_dispatch (GstVideoDecoder * decoder,
+    GstVideoCodecFrame * frame)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  ParallelJob *job;
+
+  if (priv->frame_thread_pool == NULL) {
+    GError *err = NULL;
+
+    priv->frame_thread_pool =
+        g_thread_pool_new (gst_video_decoder_parallel_func, decoder,
+        priv->frame_threads, FALSE, &err);
+    if (priv->frame_thread_pool == NULL) {
+      GST_ERROR_OBJECT (decoder, "failed to create frame threads: %s",
+          err->message);
+      g_error_free (err);
+      gst_video_decoder_release_frame (decoder, frame);
+      return GST_FLOW_ERROR;
+    }
+  }
+
+  job = g_slice_new0 (ParallelJob);
+  job->link.data = job;
+  job->decoder = decoder;
+  job->frame = frame;
+
+  g_mutex_lock (&priv->parallel_lock);
+  g_queue_push_tail_link (&priv->parallel_jobs, &job->link);
+  priv->parallel_pending++;
+  g_mutex_unlock (&priv->parallel_lock);
+
+  GST_LOG_OBJECT (decoder, "dispatching frame %u", frame->system_frame_number);
+  g_thread_pool_push (priv->frame_thread_pool, job, NULL);
+
+  return GST_FLOW_OK;
+}
+
 static GstFlowReturn
 gst_video_decoder_chain_forward (GstVideoDecoder * decoder,
     GstBuffer * buf, gboolean at_eos)
@@ -2147,9 +2548,12 @@ gst_video_decoder_chain_forward (GstVideoDecoder * decoder,
      * from drain_out() to here causing an infinite loop.
      * Also this function is only called for reverse playback to gather frames
      * GOP by GOP, and does not do any actual decoding. That would be done by
-     * flush_decode() */
+     * flush_decode().
+     * Keyframes handed to the frame threads are never held back by the
+     * subclass, and it must not be drained while they are being decoded */
     if (ret == GST_FLOW_OK && was_keyframe && decoder->input_segment.rate > 0.0
-        && (decoder->input_segment.flags & GST_SEEK_FLAG_TRICKMODE_KEY_UNITS))
+        && (decoder->input_segment.flags & GST_SEEK_FLAG_TRICKMODE_KEY_UNITS)
+        && priv->frame_threads <= 1)
       ret = gst_video_decoder_drain_out (decoder, FALSE);
   } else {
     gst_adapter_push (priv->input_adapter, buf);
@@ -2413,12 +2817,27 @@ gst_video_decoder_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
 {
   GstVideoDecoder *decoder;
   GstFlowReturn ret = GST_FLOW_OK;
+  guint frame_threads;
 
   decoder = GST_VIDEO_DECODER (parent);
 
   if (G_UNLIKELY (!decoder->priv->input_state && decoder->priv->needs_format))
     goto not_negotiated;
 
+  GST_OBJECT_LOCK (decoder);
+  frame_threads = decoder->priv->frame_threads;
+  GST_OBJECT_UNLOCK (decoder);
+
+  if (G_UNLIKELY (frame_threads > 1)) {
+    ret = gst_video_decoder_parallel_throttle (decoder, buf, frame_threads);
+    if (ret != GST_FLOW_OK) {
+      GST_DEBUG_OBJECT (decoder, "frame threads returned %s",
+          gst_flow_get_name (ret));
+      gst_buffer_unref (buf);
+      return ret;
+    }
+  }
+
   GST_LOG_OBJECT (decoder,
       "chain PTS %" GST_TIME_FORMAT ", DTS %" GST_TIME_FORMAT " duration %"
       GST_TIME_FORMAT " size %" G_GSIZE_FORMAT " flags %x",
@@ -2504,6 +2923,9 @@ gst_video_decoder_change_state (GstElement * element, GstStateChange transition)
     case GST_STATE_CHANGE_PAUSED_TO_READY:{
       gboolean stopped = TRUE;
 
+      /* the pads are flushing now, wait for the frame threads to be done */
+      gst_video_decoder_parallel_wait (decoder, 0);
+
       if (decoder_class->stop)
         stopped = decoder_class->stop (decoder);
 
@@ -2563,9 +2985,7 @@ gst_video_decoder_new_frame (GstVideoDecoder * decoder)
   GstVideoDecoderPrivate *priv = decoder->priv;
   GstVideoCodecFrame *frame;
 
-  frame = g_slice_new0 (GstVideoCodecFrame);
-
-  frame->ref_count = 1;
+  frame = __gst_video_codec_frame_pool_acquire (priv->frame_pool);
 
   GST_VIDEO_DECODER_STREAM_LOCK (decoder);
   frame->system_frame_number = priv->system_frame_number;
@@ -2610,7 +3030,7 @@ gst_video_decoder_prepare_finish_frame (GstVideoDecoder *
 
 #ifndef GST_DISABLE_GST_DEBUG
   GST_LOG_OBJECT (decoder, "n %d in %" G_GSIZE_FORMAT " out %" G_GSIZE_FORMAT,
-      g_list_length (priv->frames),
+      priv->frames.length,
       gst_adapter_available (priv->input_adapter),
       gst_adapter_available (priv->output_adapter));
 #endif
@@ -2624,7 +3044,7 @@ gst_video_decoder_prepare_finish_frame (GstVideoDecoder *
       sync, GST_TIME_ARGS (frame->pts), GST_TIME_ARGS (frame->dts));
 
   /* Push all pending events that arrived before this frame */
-  for (l = priv->frames; l; l = l->next) {
+  for (l = priv->frames.head; l; l = l->next) {
     GstVideoCodecFrame *tmp = l->data;
 
     if (tmp->events) {
@@ -2684,7 +3104,7 @@ gst_video_decoder_prepare_finish_frame (GstVideoDecoder *
     gboolean seen_none = FALSE;
 
     /* some maintenance regardless */
-    for (l = priv->frames; l; l = l->next) {
+    for (l = priv->frames.head; l; l = l->next) {
       GstVideoCodecFrame *tmp = l->data;
 
       if (!GST_CLOCK_TIME_IS_VALID (tmp->abidata.ABI.ts)) {
@@ -2718,7 +3138,7 @@ gst_video_decoder_prepare_finish_frame (GstVideoDecoder *
     /* some more maintenance, ts2 holds PTS */
     min_ts = GST_CLOCK_TIME_NONE;
     seen_none = FALSE;
-    for (l = priv->frames; l; l = l->next) {
+    for (l = priv->frames.head; l; l = l->next) {
       GstVideoCodecFrame *tmp = l->data;
 
       if (!GST_CLOCK_TIME_IS_VALID (tmp->abidata.ABI.ts2)) {
@@ -2795,6 +3215,40 @@ no_output_buffer:
   }
 }
 
+/* Appends @frame to the pending frames and indexes it by its
+ * system_frame_number. Takes over the reference of the caller. */
+static void
+gst_video_decoder_add_pending_frame (GstVideoDecoder * decoder,
+    GstVideoCodecFrame * frame)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+
+  g_queue_push_tail (&priv->frames, frame);
+  g_hash_table_insert (priv->frames_index,
+      GUINT_TO_POINTER (frame->system_frame_number), priv->frames.tail);
+}
+
+/* Removes @frame from the pending frames, returns %FALSE if it was not
+ * pending. The reference held by the list is not released. */
+static gboolean
+gst_video_decoder_remove_pending_frame (GstVideoDecoder * decoder,
+    GstVideoCodecFrame * frame)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  GList *link;
+
+  link = g_hash_table_lookup (priv->frames_index,
+      GUINT_TO_POINTER (frame->system_frame_number));
+  if (link == NULL || link->data != frame)
+    return FALSE;
+
+  g_hash_table_remove (priv->frames_index,
+      GUINT_TO_POINTER (frame->system_frame_number));
+  g_queue_delete_link (&priv->frames, link);
+
+  return TRUE;
+}
+
 /**
  * gst_video_decoder_release_frame:
  * @dec: a #GstVideoDecoder
@@ -2810,15 +3264,13 @@ void
 gst_video_decoder_release_frame (GstVideoDecoder * dec,
     GstVideoCodecFrame * frame)
 {
-  GList *link;
+  if (gst_video_decoder_parallel_defer (dec, frame, PARALLEL_JOB_RELEASE))
+    return;
 
   /* unref once from the list */
   GST_VIDEO_DECODER_STREAM_LOCK (dec);
-  link = g_list_find (dec->priv->frames, frame);
-  if (link) {
+  if (gst_video_decoder_remove_pending_frame (dec, frame))
     gst_video_codec_frame_unref (frame);
-    dec->priv->frames = g_list_delete_link (dec->priv->frames, link);
-  }
   if (frame->events) {
     dec->priv->pending_events =
         g_list_concat (dec->priv->pending_events, frame->events);
@@ -2851,6 +3303,9 @@ gst_video_decoder_drop_frame (GstVideoDecoder * dec, GstVideoCodecFrame * frame)
 
   GST_LOG_OBJECT (dec, "drop frame %p", frame);
 
+  if (gst_video_decoder_parallel_defer (dec, frame, PARALLEL_JOB_DROP))
+    return GST_FLOW_OK;
+
   GST_VIDEO_DECODER_STREAM_LOCK (dec);
 
   gst_video_decoder_prepare_finish_frame (dec, frame, TRUE);
@@ -2974,6 +3429,9 @@ gst_video_decoder_finish_frame (GstVideoDecoder * decoder,
 
   GST_LOG_OBJECT (decoder, "finish frame %p", frame);
 
+  if (gst_video_decoder_parallel_defer (decoder, frame, PARALLEL_JOB_FINISH))
+    return GST_FLOW_OK;
+
   GST_VIDEO_DECODER_STREAM_LOCK (decoder);
 
   needs_reconfigure = gst_pad_check_reconfigure (decoder->srcpad);
@@ -3400,11 +3858,11 @@ gst_video_decoder_decode_frame (GstVideoDecoder * decoder,
       frame->distance_from_sync);
 
   gst_video_codec_frame_ref (frame);
-  priv->frames = g_list_append (priv->frames, frame);
+  gst_video_decoder_add_pending_frame (decoder, frame);
 
-  if (g_list_length (priv->frames) > 10) {
+  if (priv->frames.length > 10) {
     GST_DEBUG_OBJECT (decoder, "decoder frame list getting long: %d frames,"
-        "possible internal leaking?", g_list_length (priv->frames));
+        "possible internal leaking?", priv->frames.length);
   }
 
   frame->deadline =
@@ -3412,7 +3870,10 @@ gst_video_decoder_decode_frame (GstVideoDecoder * decoder,
       frame->pts);
 
   /* do something with frame */
-  ret = decoder_class->handle_frame (decoder, frame);
+  if (gst_video_decoder_parallel_can_dispatch (decoder, frame))
+    ret = gst_video_decoder_parallel_dispatch (decoder, frame);
+  else
+    ret = decoder_class->handle_frame (decoder, frame);
   if (ret != GST_FLOW_OK)
     GST_DEBUG_OBJECT (decoder, "flow error %s", gst_flow_get_name (ret));
 
@@ -3522,8 +3983,8 @@ gst_video_decoder_get_oldest_frame (GstVideoDecoder * decoder)
   GstVideoCodecFrame *frame = NULL;
 
   GST_VIDEO_DECODER_STREAM_LOCK (decoder);
-  if (decoder->priv->frames)
-    frame = gst_video_codec_frame_ref (decoder->priv->frames->data);
+  if (decoder->priv->frames.head)
+    frame = gst_video_codec_frame_ref (decoder->priv->frames.head->data);
   GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
 
   return (GstVideoCodecFrame *) frame;
@@ -3541,20 +4002,16 @@ gst_video_decoder_get_oldest_frame (GstVideoDecoder * decoder)
 GstVideoCodecFrame *
 gst_video_decoder_get_frame (GstVideoDecoder * decoder, int frame_number)
 {
-  GList *g;
+  GList *link;
   GstVideoCodecFrame *frame = NULL;
 
   GST_DEBUG_OBJECT (decoder, "frame_number : %d", frame_number);
 
   GST_VIDEO_DECODER_STREAM_LOCK (decoder);
-  for (g = decoder->priv->frames; g; g = g->next) {
-    GstVideoCodecFrame *tmp = g->data;
-
-    if (tmp->system_frame_number == frame_number) {
-      frame = gst_video_codec_frame_ref (tmp);
-      break;
-    }
-  }
+  link = g_hash_table_lookup (decoder->priv->frames_index,
+      GUINT_TO_POINTER (frame_number));
+  if (link)
+    frame = gst_video_codec_frame_ref (link->data);
   GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
 
   return frame;
@@ -3574,7 +4031,7 @@ gst_video_decoder_get_frames (GstVideoDecoder * decoder)
   GList *frames;
 
   GST_VIDEO_DECODER_STREAM_LOCK (decoder);
-  frames = g_list_copy (decoder->priv->frames);
+  frames = g_list_copy (decoder->priv->frames.head);
   g_list_foreach (frames, (GFunc) gst_video_codec_frame_ref, NULL);
   GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
 
@@ -3814,7 +4271,7 @@ gst_video_decoder_negotiate_default (GstVideoDecoder * decoder)
 
   /* Push all pending pre-caps events of the oldest frame before
    * setting caps */
-  frame = decoder->priv->frames ? decoder->priv->frames->data : NULL;
+  frame = decoder->priv->frames.head ? decoder->priv->frames.head->data : NULL;
   if (frame || decoder->priv->current_frame_events) {
     GList **events, *l;
 
@@ -4246,6 +4703,87 @@ gst_video_decoder_get_packetized (GstVideoDecoder * decoder)
   return decoder->priv->packetized;
 }
 
+/**
+ * gst_video_decoder_set_frame_threads:
+ * @decoder: a #GstVideoDecoder
+ * @n_threads: the number of frames to decode in parallel, or 0 to use the
+ *    number of processors
+ *
+ * Lets the base class call @handle_frame for several frames at the same
+ * time from a pool of @n_threads threads. This is meant for codecs where
+ * frames can be decoded independently of each other, such as intra-only
+ * codecs, and only applies to packetized input in forward playback.
+ *
+ * Frames that are sync points are considered independent and are handed to
+ * the threads as they come in. All other frames are considered to depend on
+ * the previous frames, and are only passed to @handle_frame once all previous
+ * frames are done. Subclasses can thus declare the dependencies of a frame by
+ * marking it as a sync point, which is the default for input buffers without
+ * the %GST_BUFFER_FLAG_DELTA_UNIT flag.
+ *
+ * The subclass has to finish, drop or release each frame it is handed from
+ * within @handle_frame. Those calls are then applied in decoding order, so
+ * output is produced in the same order as without threads. @handle_frame
+ * must be safe to call from several threads at once, and may use the rest
+ * of the #GstVideoDecoder API as usual.
+ *
+ * The latency reported by the base class is increased by one frame duration
+ * per additional thread.
+ *
+ * This should be called before data flow starts, e.g. from @start, and
+ * defaults to 1, meaning that frames are decoded in the streaming thread.
+ *
+ * Since: 1.14
+ */
+void
+gst_video_decoder_set_frame_threads (GstVideoDecoder * decoder,
+    guint n_threads)
+{
+  g_return_if_fail (GST_IS_VIDEO_DECODER (decoder));
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+
+  GST_DEBUG_OBJECT (decoder, "using %u frame threads", n_threads);
+
+  GST_VIDEO_DECODER_STREAM_LOCK (decoder);
+  GST_OBJECT_LOCK (decoder);
+  decoder->priv->frame_threads = n_threads;
+  GST_OBJECT_UNLOCK (decoder);
+  if (decoder->priv->frame_thread_pool)
+    g_thread_pool_set_max_threads (decoder->priv->frame_thread_pool,
+        n_threads, NULL);
+  GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
+
+  gst_element_post_message (GST_ELEMENT_CAST (decoder),
+      gst_message_new_latency (GST_OBJECT_CAST (decoder)));
+}
+
+/**
+ * gst_video_decoder_get_frame_threads:
+ * @decoder: a #GstVideoDecoder
+ *
+ * Queries the number of frames that can be decoded in parallel, see
+ * gst_video_decoder_set_frame_threads().
+ *
+ * Returns: the number of frame threads
+ *
+ * Since: 1.14
+ */
+guint
+gst_video_decoder_get_frame_threads (GstVideoDecoder * decoder)
+{
+  guint n_threads;
+
+  g_return_val_if_fail (GST_IS_VIDEO_DECODER (decoder), 1);
+
+  GST_OBJECT_LOCK (decoder);
+  n_threads = decoder->priv->frame_threads;
+  GST_OBJECT_UNLOCK (decoder);
+
+  return n_threads;
+}
+
 /**
  * gst_video_decoder_set_estimate_rate:
  * @dec: a #GstVideoDecoder
@@ -353,6 +353,13 @@ void     gst_video_decoder_set_packetized (GstVideoDecoder * decoder,
 GST_EXPORT
 gboolean gst_video_decoder_get_packetized (GstVideoDecoder * decoder);
 
+GST_EXPORT
+void     gst_video_decoder_set_frame_threads (GstVideoDecoder * decoder,
+					      guint             n_threads);
+
+GST_EXPORT
+guint    gst_video_decoder_get_frame_threads (GstVideoDecoder * decoder);
+
 GST_EXPORT
 void     gst_video_decoder_set_estimate_rate (GstVideoDecoder * dec,
 					      gboolean          enabled);
@@ -128,7 +128,11 @@ struct _GstVideoEncoderPrivate
 
   guint32 system_frame_number;
 
-  GList *frames;                /* Protected with OBJECT_LOCK */
+  /* pending frames, oldest first, and an index of their links by
+   * system_frame_number for constant time lookup and removal */
+  GQueue frames;                /* Protected with OBJECT_LOCK */
+  GHashTable *frames_index;
+  GstVideoCodecFramePool *frame_pool;
   GstVideoCodecState *input_state;
   GstVideoCodecState *output_state;
   gboolean output_state_changed;
@@ -152,6 +156,10 @@ struct _GstVideoEncoderPrivate
   /* adjustment needed on pts, dts, segment start and stop to accomodate
    * min_pts */
   GstClockTime time_adjustment;
+
+  /* band-parallel encoding, see gst_video_encoder_encode_bands() */
+  guint band_threads;           /* OBJECT_LOCK */
+  GThreadPool *band_thread_pool;
 };
 
 typedef struct _ForcedKeyUnitEvent ForcedKeyUnitEvent;
@@ -183,12 +191,20 @@ forced_key_unit_event_new (GstClockTime running_time, gboolean all_headers,
   return evt;
 }
 
+enum
+{
+  PROP_0,
+  PROP_ALLOC_STATS
+};
+
 static GstElementClass *parent_class = NULL;
 static void gst_video_encoder_class_init (GstVideoEncoderClass * klass);
 static void gst_video_encoder_init (GstVideoEncoder * enc,
     GstVideoEncoderClass * klass);
 
 static void gst_video_encoder_finalize (GObject * object);
+static void gst_video_encoder_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
 
 static gboolean gst_video_encoder_setcaps (GstVideoEncoder * enc,
     GstCaps * caps);
@@ -282,6 +298,7 @@ gst_video_encoder_class_init (GstVideoEncoderClass * klass)
   g_type_class_add_private (klass, sizeof (GstVideoEncoderPrivate));
 
   gobject_class->finalize = gst_video_encoder_finalize;
+  gobject_class->get_property = gst_video_encoder_get_property;
 
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_video_encoder_change_state);
@@ -294,6 +311,23 @@ gst_video_encoder_class_init (GstVideoEncoderClass * klass)
   klass->sink_query = gst_video_encoder_sink_query_default;
   klass->src_query = gst_video_encoder_src_query_default;
   klass->transform_meta = gst_video_encoder_transform_meta_default;
+
+  /**
+   * GstVideoEncoder:alloc-stats:
+   *
+   * Statistics about the per-frame records allocated by the base class since
+   * the element was created. The structure contains the following fields:
+   *
+   *   * `frames-allocated`: #G_TYPE_UINT64, frames that had to be allocated
+   *   * `frames-reused`: #G_TYPE_UINT64, frames that were reused from the
+   *      element's pool of finished frames
+   *
+   * Since: 1.14
+   */
+  g_object_class_install_property (gobject_class, PROP_ALLOC_STATS,
+      g_param_spec_boxed ("alloc-stats", "Allocation statistics",
+          "Statistics about per-frame allocations", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 }
 
 static GList *
@@ -377,7 +411,7 @@ gst_video_encoder_reset (GstVideoEncoder * encoder, gboolean hard)
   } else {
     GList *l;
 
-    for (l = priv->frames; l; l = l->next) {
+    for (l = priv->frames.head; l; l = l->next) {
       GstVideoCodecFrame *frame = l->data;
 
       frame->events = _flush_events (encoder->srcpad, frame->events);
@@ -386,9 +420,12 @@ gst_video_encoder_reset (GstVideoEncoder * encoder, gboolean hard)
         encoder->priv->current_frame_events);
   }
 
-  g_list_foreach (priv->frames, (GFunc) gst_video_codec_frame_unref, NULL);
-  g_list_free (priv->frames);
-  priv->frames = NULL;
+  g_queue_foreach (&priv->frames, (GFunc) gst_video_codec_frame_unref, NULL);
+  g_queue_clear (&priv->frames);
+  g_hash_table_remove_all (priv->frames_index);
+
+  /* don't keep cached frames around over a flush */
+  __gst_video_codec_frame_pool_trim (priv->frame_pool);
 
   GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
 
@@ -459,9 +496,37 @@ gst_video_encoder_init (GstVideoEncoder * encoder, GstVideoEncoderClass * klass)
   priv->min_pts = GST_CLOCK_TIME_NONE;
   priv->time_adjustment = GST_CLOCK_TIME_NONE;
 
+  g_queue_init (&priv->frames);
+  priv->frames_index = g_hash_table_new (NULL, NULL);
+  priv->frame_pool = __gst_video_codec_frame_pool_new ();
+
+  priv->band_threads = 1;
+
   gst_video_encoder_reset (encoder, TRUE);
 }
 
+static void
+gst_video_encoder_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstVideoEncoder *encoder = GST_VIDEO_ENCODER (object);
+  guint64 allocated, reused;
+
+  switch (prop_id) {
+    case PROP_ALLOC_STATS:
+      __gst_video_codec_frame_pool_get_stats (encoder->priv->frame_pool,
+          &allocated, &reused);
+      g_value_take_boxed (value,
+          gst_structure_new ("application/x-video-encoder-alloc-stats",
+              "frames-allocated", G_TYPE_UINT64, allocated,
+              "frames-reused", G_TYPE_UINT64, reused, NULL));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
 /**
  * gst_video_encoder_set_headers:
  * @encoder: a #GstVideoEncoder
@@ -842,6 +907,14 @@ gst_video_encoder_finalize (GObject * object)
     encoder->priv->allocator = NULL;
   }
 
+  if (encoder->priv->band_thread_pool) {
+    g_thread_pool_free (encoder->priv->band_thread_pool, FALSE, TRUE);
+    encoder->priv->band_thread_pool = NULL;
+  }
+
+  g_hash_table_destroy (encoder->priv->frames_index);
+  __gst_video_codec_frame_pool_free (encoder->priv->frame_pool);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -1293,9 +1366,7 @@ gst_video_encoder_new_frame (GstVideoEncoder * encoder, GstBuffer * buf,
   GstVideoEncoderPrivate *priv = encoder->priv;
   GstVideoCodecFrame *frame;
 
-  frame = g_slice_new0 (GstVideoCodecFrame);
-
-  frame->ref_count = 1;
+  frame = __gst_video_codec_frame_pool_acquire (priv->frame_pool);
 
   GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
   frame->system_frame_number = priv->system_frame_number;
@@ -1427,7 +1498,9 @@ gst_video_encoder_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
   GST_OBJECT_UNLOCK (encoder);
 
   gst_video_codec_frame_ref (frame);
-  priv->frames = g_list_append (priv->frames, frame);
+  g_queue_push_tail (&priv->frames, frame);
+  g_hash_table_insert (priv->frames_index,
+      GUINT_TO_POINTER (frame->system_frame_number), priv->frames.tail);
 
   /* new data, more finish needed */
   priv->drained = FALSE;
@@ -1612,7 +1685,7 @@ gst_video_encoder_negotiate_default (GstVideoEncoder * encoder)
 
   /* Push all pending pre-caps events of the oldest frame before
    * setting caps */
-  frame = encoder->priv->frames ? encoder->priv->frames->data : NULL;
+  frame = encoder->priv->frames.head ? encoder->priv->frames.head->data : NULL;
   if (frame || encoder->priv->current_frame_events) {
     GList **events, *l;
 
@@ -1834,13 +1907,17 @@ static void
 gst_video_encoder_release_frame (GstVideoEncoder * enc,
     GstVideoCodecFrame * frame)
 {
+  GstVideoEncoderPrivate *priv = enc->priv;
   GList *link;
 
   /* unref once from the list */
-  link = g_list_find (enc->priv->frames, frame);
-  if (link) {
+  link = g_hash_table_lookup (priv->frames_index,
+      GUINT_TO_POINTER (frame->system_frame_number));
+  if (link && link->data == frame) {
     gst_video_codec_frame_unref (frame);
-    enc->priv->frames = g_list_delete_link (enc->priv->frames, link);
+    g_hash_table_remove (priv->frames_index,
+        GUINT_TO_POINTER (frame->system_frame_number));
+    g_queue_delete_link (&priv->frames, link);
   }
   /* unref because this function takes ownership */
   gst_video_codec_frame_unref (frame);
@@ -1960,7 +2037,7 @@ gst_video_encoder_finish_frame (GstVideoEncoder * encoder,
     goto no_output_state;
 
   /* Push all pending events that arrived before this frame */
-  for (l = priv->frames; l; l = l->next) {
+  for (l = priv->frames.head; l; l = l->next) {
     GstVideoCodecFrame *tmp = l->data;
 
     if (tmp->events) {
@@ -2068,7 +2145,7 @@ gst_video_encoder_finish_frame (GstVideoEncoder * encoder,
     gboolean seen_none = FALSE;
 
     /* some maintenance regardless */
-    for (l = priv->frames; l; l = l->next) {
+    for (l = priv->frames.head; l; l = l->next) {
       GstVideoCodecFrame *tmp = l->data;
 
       if (!GST_CLOCK_TIME_IS_VALID (tmp->abidata.ABI.ts)) {
@@ -2331,8 +2408,8 @@ gst_video_encoder_get_oldest_frame (GstVideoEncoder * encoder)
   GstVideoCodecFrame *frame = NULL;
 
   GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
-  if (encoder->priv->frames)
-    frame = gst_video_codec_frame_ref (encoder->priv->frames->data);
+  if (encoder->priv->frames.head)
+    frame = gst_video_codec_frame_ref (encoder->priv->frames.head->data);
   GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
 
   return (GstVideoCodecFrame *) frame;
@@ -2350,20 +2427,16 @@ gst_video_encoder_get_oldest_frame (GstVideoEncoder * encoder)
 GstVideoCodecFrame *
 gst_video_encoder_get_frame (GstVideoEncoder * encoder, int frame_number)
 {
-  GList *g;
+  GList *link;
   GstVideoCodecFrame *frame = NULL;
 
   GST_DEBUG_OBJECT (encoder, "frame_number : %d", frame_number);
 
   GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
-  for (g = encoder->priv->frames; g; g = g->next) {
-    GstVideoCodecFrame *tmp = g->data;
-
-    if (tmp->system_frame_number == frame_number) {
-      frame = gst_video_codec_frame_ref (tmp);
-      break;
-    }
-  }
+  link = g_hash_table_lookup (encoder->priv->frames_index,
+      GUINT_TO_POINTER (frame_number));
+  if (link)
+    frame = gst_video_codec_frame_ref (link->data);
   GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
 
   return frame;
@@ -2383,7 +2456,7 @@ gst_video_encoder_get_frames (GstVideoEncoder * encoder)
   GList *frames;
 
   GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
-  frames = g_list_copy (encoder->priv->frames);
+  frames = g_list_copy (encoder->priv->frames.head);
   g_list_foreach (frames, (GFunc) gst_video_codec_frame_ref, NULL);
   GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
 
@@ -2479,3 +2552,281 @@ gst_video_encoder_set_min_pts (GstVideoEncoder * encoder, GstClockTime min_pts)
   encoder->priv->min_pts = min_pts;
   encoder->priv->time_adjustment = GST_CLOCK_TIME_NONE;
 }
+
+typedef struct _BandSet BandSet;
+typedef struct _BandJob BandJob;
+
+/* the bands of one frame being encoded */
+struct _BandSet
+{
+  GstVideoCodecFrame *frame;
+  GstVideoFrame vframe;
+  GMutex lock;
+  GCond cond;
+  guint pending;                /* Protected with lock */
+};
+
+struct _BandJob
+{
+  BandSet *set;
+  guint y;
+  guint height;
+  GstBuffer *output;
+  GstFlowReturn ret;
+};
+
+static void
+gst_video_encoder_encode_band (GstVideoEncoder * encoder, BandJob * band)
+{
+  GstVideoEncoderClass *klass = GST_VIDEO_ENCODER_GET_CLASS (encoder);
+
+  GST_LOG_OBJECT (encoder, "encoding rows %u-%u", band->y,
+      band->y + band->height - 1);
+
+  band->ret = klass->encode_band (encoder, band->set->frame,
+      &band->set->vframe, band->y, band->height, &band->output);
+}
+
+static void
+gst_video_encoder_band_func (gpointer data, gpointer user_data)
+{
+  BandJob *band = data;
+  BandSet *set = band->set;
+
+  gst_video_encoder_encode_band (GST_VIDEO_ENCODER (user_data), band);
+
+  g_mutex_lock (&set->lock);
+  if (--set->pending == 0)
+    g_cond_signal (&set->cond);
+  g_mutex_unlock (&set->lock);
+}
+
+/**
+ * gst_video_encoder_set_band_threads:
+ * @encoder: a #GstVideoEncoder
+ * @n_threads: the number of bands to encode in parallel, or 0 to use the
+ *    number of processors
+ *
+ * Sets the number of threads gst_video_encoder_encode_bands() uses to call
+ * @encode_band, including the thread calling it. Defaults to 1, meaning that
+ * all bands are encoded one after the other in the streaming thread.
+ *
+ * Since: 1.14
+ */
+void
+gst_video_encoder_set_band_threads (GstVideoEncoder * encoder, guint n_threads)
+{
+  g_return_if_fail (GST_IS_VIDEO_ENCODER (encoder));
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+
+  GST_DEBUG_OBJECT (encoder, "using %u band threads", n_threads);
+
+  GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
+  GST_OBJECT_LOCK (encoder);
+  encoder->priv->band_threads = n_threads;
+  GST_OBJECT_UNLOCK (encoder);
+  if (encoder->priv->band_thread_pool && n_threads > 1)
+    g_thread_pool_set_max_threads (encoder->priv->band_thread_pool,
+        n_threads - 1, NULL);
+  GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
+}
+
+/**
+ * gst_video_encoder_get_band_threads:
+ * @encoder: a #GstVideoEncoder
+ *
+ * Queries the number of threads used by gst_video_encoder_encode_bands().
+ *
+ * Returns: the number of band threads
+ *
+ * Since: 1.14
+ */
+guint
+gst_video_encoder_get_band_threads (GstVideoEncoder * encoder)
+{
+  guint n_threads;
+
+  g_return_val_if_fail (GST_IS_VIDEO_ENCODER (encoder), 1);
+
+  GST_OBJECT_LOCK (encoder);
+  n_threads = encoder->priv->band_threads;
+  GST_OBJECT_UNLOCK (encoder);
+
+  return n_threads;
+}
+
+/**
+ * gst_video_encoder_encode_bands:
+ * @encoder: a #GstVideoEncoder
+ * @frame: a #GstVideoCodecFrame
+ * @n_bands: the number of bands to split the frame into, or 0 to use the
+ *    number of band threads
+ * @alignment: the number of rows the height of each band has to be a
+ *    multiple of, e.g. the macroblock height, or 0 for no constraint
+ *
+ * Helper for encoders whose frames can be encoded as independent horizontal
+ * bands, e.g. slices of intra-only codecs. To be called from @handle_frame.
+ *
+ * The input of @frame is split into at most @n_bands bands of equal height,
+ * except for the last one, and @encode_band is called for each band from the
+ * band threads configured with gst_video_encoder_set_band_threads(). Once
+ * all bands are done, their output is appended in top to bottom order to the
+ * output buffer of @frame, which is created if it is not set yet. The
+ * subclass can then finish @frame as usual.
+ *
+ * The band outputs are appended with gst_buffer_append(), so their memory is
+ * not copied as long as the output buffer has no more than
+ * gst_buffer_get_max_memory() memories. Beyond that, the memories are merged,
+ * which copies them.
+ *
+ * @encode_band is called while the thread calling this function holds the
+ * stream lock, so it must not call any #GstVideoEncoder API and should
+ * allocate its output with e.g. gst_buffer_new_allocate(). As all bands are
+ * done when this function returns, band-parallel encoding does not add to
+ * the latency of the encoder.
+ *
+ * Returns: %GST_FLOW_OK, or the first error returned by @encode_band
+ *
+ * Since: 1.14
+ */
+GstFlowReturn
+gst_video_encoder_encode_bands (GstVideoEncoder * encoder,
+    GstVideoCodecFrame * frame, guint n_bands, guint alignment)
+{
+  GstVideoEncoderClass *klass;
+  GstVideoEncoderPrivate *priv;
+  GstFlowReturn ret = GST_FLOW_OK;
+  BandSet set;
+  BandJob *bands;
+  guint n_threads, height, band_height, i;
+
+  g_return_val_if_fail (GST_IS_VIDEO_ENCODER (encoder), GST_FLOW_ERROR);
+  g_return_val_if_fail (frame != NULL, GST_FLOW_ERROR);
+
+  klass = GST_VIDEO_ENCODER_GET_CLASS (encoder);
+  priv = encoder->priv;
+
+  g_return_val_if_fail (klass->encode_band != NULL, GST_FLOW_ERROR);
+
+  GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
+
+  if (priv->input_state == NULL)
+    goto not_negotiated;
+
+  if (!gst_video_frame_map (&set.vframe, &priv->input_state->info,
+          frame->input_buffer, GST_MAP_READ))
+    goto map_failed;
+
+  GST_OBJECT_LOCK (encoder);
+  n_threads = priv->band_threads;
+  GST_OBJECT_UNLOCK (encoder);
+
+  if (n_bands == 0)
+    n_bands = n_threads;
+  if (alignment == 0)
+    alignment = 1;
+
+  /* round the band height up to the alignment, which can leave fewer
+   * bands than requested */
+  height = GST_VIDEO_FRAME_HEIGHT (&set.vframe);
+  if (height == 0) {
+    GST_DEBUG_OBJECT (encoder, "frame %u has no rows to encode",
+        frame->system_frame_number);
+    gst_video_frame_unmap (&set.vframe);
+    GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
+    return GST_FLOW_OK;
+  }
+  band_height = (height + n_bands - 1) / n_bands;
+  band_height = (band_height + alignment - 1) / alignment * alignment;
+  n_bands = (height + band_height - 1) / band_height;
+
+  GST_LOG_OBJECT (encoder, "encoding frame %u in %u bands of %u rows",
+      frame->system_frame_number, n_bands, band_height);
+
+  set.frame = frame;
+  g_mutex_init (&set.lock);
+  g_cond_init (&set.cond);
+
+  bands = g_new0 (BandJob, n_bands);
+  for (i = 0; i < n_bands; i++) {
+    bands[i].set = &set;
+    bands[i].y = i * band_height;
+    bands[i].height = MIN (band_height, height - bands[i].y);
+  }
+
+  if (n_threads > 1 && n_bands > 1 && priv->band_thread_pool == NULL) {
+    GError *err = NULL;
+
+    priv->band_thread_pool =
+        g_thread_pool_new (gst_video_encoder_band_func, encoder,
+        n_threads - 1, FALSE, &err);
+    if (priv->band_thread_pool == NULL) {
+      GST_WARNING_OBJECT (encoder, "failed to create band threads, encoding "
+          "bands one after the other: %s", err->message);
+      g_error_free (err);
+    }
+  }
+
+  if (n_threads > 1 && n_bands > 1 && priv->band_thread_pool != NULL) {
+    /* the current thread takes care of the first band */
+    set.pending = n_bands - 1;
+    for (i = 1; i < n_bands; i++)
+      g_thread_pool_push (priv->band_thread_pool, &bands[i], NULL);
+    gst_video_encoder_encode_band (encoder, &bands[0]);
+
+    g_mutex_lock (&set.lock);
+    while (set.pending > 0)
+      g_cond_wait (&set.cond, &set.lock);
+    g_mutex_unlock (&set.lock);
+  } else {
+    for (i = 0; i < n_bands; i++)
+      gst_video_encoder_encode_band (encoder, &bands[i]);
+  }
+
+  gst_video_frame_unmap (&set.vframe);
+
+  for (i = 0; i < n_bands; i++) {
+    if (bands[i].ret != GST_FLOW_OK && ret == GST_FLOW_OK) {
+      GST_DEBUG_OBJECT (encoder, "band %u returned %s", i,
+          gst_flow_get_name (bands[i].ret));
+      ret = bands[i].ret;
+    }
+  }
+
+  for (i = 0; i < n_bands; i++) {
+    if (bands[i].output == NULL)
+      continue;
+
+    if (ret != GST_FLOW_OK)
+      gst_buffer_unref (bands[i].output);
+    else if (frame->output_buffer == NULL)
+      frame->output_buffer = bands[i].output;
+    else
+      frame->output_buffer =
+          gst_buffer_append (frame->output_buffer, bands[i].output);
+  }
+
+  g_free (bands);
+  g_mutex_clear (&set.lock);
+  g_cond_clear (&set.cond);
+
+  GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
+
+  return ret;
+
+  /* ERRORS */
+not_negotiated:
+  {
+    GST_ERROR_OBJECT (encoder, "no input format set");
+    GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
+    return GST_FLOW_NOT_NEGOTIATED;
+  }
+map_failed:
+  {
+    GST_ERROR_OBJECT (encoder, "failed to map input frame");
+    GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
+    return GST_FLOW_ERROR;
+  }
+}
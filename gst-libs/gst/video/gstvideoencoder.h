@@ -234,6 +234,10 @@ struct _GstVideoEncoder
  *                  tags and meta with only the "video" tag. subclasses can
  *                  implement this method and return %TRUE if the metadata is to be
  *                  copied. Since 1.6
+ * @encode_band:    Optional. Encodes the @height rows starting at row @y of
+ *                  the mapped input frame into a new buffer stored in
+ *                  @output. Called from multiple threads at once by
+ *                  gst_video_encoder_encode_bands(). Since 1.14
  *
  * Subclasses can override any of the available virtual methods or not, as
  * needed. At minimum @handle_frame needs to be overridden, and @set_format
@@ -295,8 +299,15 @@ struct _GstVideoEncoderClass
                                    GstVideoCodecFrame *frame,
                                    GstMeta * meta);
 
+  GstFlowReturn (*encode_band)    (GstVideoEncoder *encoder,
+                                   GstVideoCodecFrame *frame,
+                                   GstVideoFrame *vframe,
+                                   guint y,
+                                   guint height,
+                                   GstBuffer **output);
+
   /*< private >*/
-  gpointer       _gst_reserved[GST_PADDING_LARGE-4];
+  gpointer       _gst_reserved[GST_PADDING_LARGE-5];
 };
 
 GST_EXPORT
@@ -368,6 +379,19 @@ void                 gst_video_encoder_get_allocator (GstVideoEncoder *encoder,
 GST_EXPORT
 void                 gst_video_encoder_set_min_pts(GstVideoEncoder *encoder, GstClockTime min_pts);
 
+GST_EXPORT
+void                 gst_video_encoder_set_band_threads (GstVideoEncoder *encoder,
+                                                         guint n_threads);
+
+GST_EXPORT
+guint                gst_video_encoder_get_band_threads (GstVideoEncoder *encoder);
+
+GST_EXPORT
+GstFlowReturn        gst_video_encoder_encode_bands (GstVideoEncoder *encoder,
+                                                     GstVideoCodecFrame *frame,
+                                                     guint n_bands,
+                                                     guint alignment);
+
 #ifdef G_DEFINE_AUTOPTR_CLEANUP_FUNC
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstVideoEncoder, gst_object_unref)
 #endif
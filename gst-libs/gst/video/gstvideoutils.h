@@ -258,6 +258,7 @@ struct _GstVideoCodecFrame
     struct {
       GstClockTime ts;
       GstClockTime ts2;
+      gpointer pool;
     } ABI;
     void         *padding[GST_PADDING_LARGE];
   } abidata;
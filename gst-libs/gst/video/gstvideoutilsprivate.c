@@ -26,6 +26,8 @@
 #include <gst/video/video.h>
 #include "gstvideoutilsprivate.h"
 
+#include <string.h>
+
 /*
  * Takes caps and copies its video fields to tmpl_caps
  */
@@ -255,3 +257,137 @@ __gst_video_encoded_video_convert (gint64 bytes, gint64 time,
 exit:
   return res;
 }
+
+/* GstVideoCodecFramePool:
+ *
+ * Keeps the GstVideoCodecFrame structures of finished frames around so the
+ * codec base classes don't need to allocate a new one for every frame.
+ * Free frames are chained through their user_data field. The pool is
+ * refcounted: the owning element holds one reference and every frame that
+ * was handed out holds another one, as frames can outlive the element. */
+#define MAX_POOLED_FRAMES 32
+
+struct _GstVideoCodecFramePool
+{
+  gint refcount;
+
+  GMutex lock;
+  GstVideoCodecFrame *free_frames;
+  guint n_free;
+
+  guint64 allocated;
+  guint64 reused;
+};
+
+GstVideoCodecFramePool *
+__gst_video_codec_frame_pool_new (void)
+{
+  GstVideoCodecFramePool *pool;
+
+  pool = g_slice_new0 (GstVideoCodecFramePool);
+  pool->refcount = 1;
+  g_mutex_init (&pool->lock);
+
+  return pool;
+}
+
+static void
+__gst_video_codec_frame_pool_unref (GstVideoCodecFramePool * pool)
+{
+  if (g_atomic_int_dec_and_test (&pool->refcount)) {
+    __gst_video_codec_frame_pool_trim (pool);
+    g_mutex_clear (&pool->lock);
+    g_slice_free (GstVideoCodecFramePool, pool);
+  }
+}
+
+/* Drops the reference of the owner, the pool itself goes away once all
+ * frames handed out have been released */
+void
+__gst_video_codec_frame_pool_free (GstVideoCodecFramePool * pool)
+{
+  __gst_video_codec_frame_pool_trim (pool);
+  __gst_video_codec_frame_pool_unref (pool);
+}
+
+/* Returns a cleared frame with a refcount of 1 */
+GstVideoCodecFrame *
+__gst_video_codec_frame_pool_acquire (GstVideoCodecFramePool * pool)
+{
+  GstVideoCodecFrame *frame;
+
+  g_mutex_lock (&pool->lock);
+  frame = pool->free_frames;
+  if (frame) {
+    pool->free_frames = frame->user_data;
+    pool->n_free--;
+    pool->reused++;
+  } else {
+    pool->allocated++;
+  }
+  g_mutex_unlock (&pool->lock);
+
+  if (frame)
+    memset (frame, 0, sizeof (GstVideoCodecFrame));
+  else
+    frame = g_slice_new0 (GstVideoCodecFrame);
+
+  frame->ref_count = 1;
+  frame->abidata.ABI.pool = pool;
+  g_atomic_int_inc (&pool->refcount);
+
+  return frame;
+}
+
+/* Called when the last reference to @frame is gone, after its contents
+ * have been released */
+void
+__gst_video_codec_frame_pool_release (GstVideoCodecFramePool * pool,
+    GstVideoCodecFrame * frame)
+{
+  gboolean pooled = FALSE;
+
+  g_mutex_lock (&pool->lock);
+  if (pool->n_free < MAX_POOLED_FRAMES) {
+    frame->user_data = pool->free_frames;
+    pool->free_frames = frame;
+    pool->n_free++;
+    pooled = TRUE;
+  }
+  g_mutex_unlock (&pool->lock);
+
+  if (!pooled)
+    g_slice_free (GstVideoCodecFrame, frame);
+
+  __gst_video_codec_frame_pool_unref (pool);
+}
+
+/* Frees all frames that are currently kept for reuse */
+void
+__gst_video_codec_frame_pool_trim (GstVideoCodecFramePool * pool)
+{
+  GstVideoCodecFrame *frames;
+
+  g_mutex_lock (&pool->lock);
+  frames = pool->free_frames;
+  pool->free_frames = NULL;
+  pool->n_free = 0;
+  g_mutex_unlock (&pool->lock);
+
+  while (frames) {
+    GstVideoCodecFrame *next = frames->user_data;
+
+    g_slice_free (GstVideoCodecFrame, frames);
+    frames = next;
+  }
+}
+
+void
+__gst_video_codec_frame_pool_get_stats (GstVideoCodecFramePool * pool,
+    guint64 * allocated, guint64 * reused)
+{
+  g_mutex_lock (&pool->lock);
+  *allocated = pool->allocated;
+  *reused = pool->reused;
+  g_mutex_unlock (&pool->lock);
+}
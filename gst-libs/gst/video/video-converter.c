@@ -22,13 +22,6 @@
 #include "config.h"
 #endif
 
-#if 0
-#ifdef HAVE_PTHREAD
-#define _GNU_SOURCE
-#include <pthread.h>
-#endif
-#endif
-
 #include "video-converter.h"
 
 #include <glib.h>
@@ -115,198 +108,7 @@ ensure_debug_category (void)
 #define ensure_debug_category() /* NOOP */
 #endif /* GST_DISABLE_GST_DEBUG */
 
-typedef void (*GstParallelizedTaskFunc) (gpointer user_data);
-
-typedef struct _GstParallelizedTaskRunner GstParallelizedTaskRunner;
-typedef struct _GstParallelizedTaskThread GstParallelizedTaskThread;
-
-struct _GstParallelizedTaskThread
-{
-  GstParallelizedTaskRunner *runner;
-  guint idx;
-  GThread *thread;
-};
-
-struct _GstParallelizedTaskRunner
-{
-  guint n_threads;
-
-  GstParallelizedTaskThread *threads;
-
-  GstParallelizedTaskFunc func;
-  gpointer *task_data;
-
-  GMutex lock;
-  GCond cond_todo, cond_done;
-  gint n_todo, n_done;
-  gboolean quit;
-};
-
-static gpointer
-gst_parallelized_task_thread_func (gpointer data)
-{
-  GstParallelizedTaskThread *self = data;
-
-#if 0
-#ifdef HAVE_PTHREAD
-  {
-    pthread_t thread = pthread_self ();
-    cpu_set_t cpuset;
-    int r;
-
-    CPU_ZERO (&cpuset);
-    CPU_SET (self->idx, &cpuset);
-    if ((r = pthread_setaffinity_np (thread, sizeof (cpuset), &cpuset)) != 0)
-      GST_ERROR ("Failed to set thread affinity for thread %d: %s", self->idx,
-          g_strerror (r));
-  }
-#endif
-#endif
-
-  g_mutex_lock (&self->runner->lock);
-  self->runner->n_done++;
-  if (self->runner->n_done == self->runner->n_threads - 1)
-    g_cond_signal (&self->runner->cond_done);
-
-  do {
-    gint idx;
-
-    while (self->runner->n_todo == -1 && !self->runner->quit)
-      g_cond_wait (&self->runner->cond_todo, &self->runner->lock);
-
-    if (self->runner->quit)
-      break;
-
-    idx = self->runner->n_todo--;
-    g_assert (self->runner->n_todo >= -1);
-    g_mutex_unlock (&self->runner->lock);
-
-    g_assert (self->runner->func != NULL);
-
-    self->runner->func (self->runner->task_data[idx]);
-
-    g_mutex_lock (&self->runner->lock);
-    self->runner->n_done++;
-    if (self->runner->n_done == self->runner->n_threads - 1)
-      g_cond_signal (&self->runner->cond_done);
-  } while (TRUE);
-
-  g_mutex_unlock (&self->runner->lock);
-
-  return NULL;
-}
-
-static void
-gst_parallelized_task_runner_free (GstParallelizedTaskRunner * self)
-{
-  guint i;
-
-  g_mutex_lock (&self->lock);
-  self->quit = TRUE;
-  g_cond_broadcast (&self->cond_todo);
-  g_mutex_unlock (&self->lock);
-
-  for (i = 1; i < self->n_threads; i++) {
-    if (!self->threads[i].thread)
-      continue;
-
-    g_thread_join (self->threads[i].thread);
-  }
-
-  g_mutex_clear (&self->lock);
-  g_cond_clear (&self->cond_todo);
-  g_cond_clear (&self->cond_done);
-  g_free (self->threads);
-  g_free (self);
-}
-
-static GstParallelizedTaskRunner *
-gst_parallelized_task_runner_new (guint n_threads)
-{
-  GstParallelizedTaskRunner *self;
-  guint i;
-  GError *err = NULL;
-
-  if (n_threads == 0)
-    n_threads = g_get_num_processors ();
-
-  self = g_new0 (GstParallelizedTaskRunner, 1);
-  self->n_threads = n_threads;
-  self->threads = g_new0 (GstParallelizedTaskThread, n_threads);
-
-  self->quit = FALSE;
-  self->n_todo = -1;
-  self->n_done = 0;
-  g_mutex_init (&self->lock);
-  g_cond_init (&self->cond_todo);
-  g_cond_init (&self->cond_done);
-
-  /* Set when scheduling a job */
-  self->func = NULL;
-  self->task_data = NULL;
-
-  for (i = 0; i < n_threads; i++) {
-    self->threads[i].runner = self;
-    self->threads[i].idx = i;
-
-    /* First thread is the one calling run() */
-    if (i > 0) {
-      self->threads[i].thread =
-          g_thread_try_new ("videoconvert", gst_parallelized_task_thread_func,
-          &self->threads[i], &err);
-      if (!self->threads[i].thread)
-        goto error;
-    }
-  }
-
-  g_mutex_lock (&self->lock);
-  while (self->n_done < self->n_threads - 1)
-    g_cond_wait (&self->cond_done, &self->lock);
-  self->n_done = 0;
-  g_mutex_unlock (&self->lock);
-
-  return self;
-
-error:
-  {
-    GST_ERROR ("Failed to start thread %u: %s", i, err->message);
-    g_clear_error (&err);
-
-    gst_parallelized_task_runner_free (self);
-    return NULL;
-  }
-}
-
-static void
-gst_parallelized_task_runner_run (GstParallelizedTaskRunner * self,
-    GstParallelizedTaskFunc func, gpointer * task_data)
-{
-  guint n_threads = self->n_threads;
-
-  self->func = func;
-  self->task_data = task_data;
-
-  if (n_threads > 1) {
-    g_mutex_lock (&self->lock);
-    self->n_todo = self->n_threads - 2;
-    self->n_done = 0;
-    g_cond_broadcast (&self->cond_todo);
-    g_mutex_unlock (&self->lock);
-  }
-
-  self->func (self->task_data[self->n_threads - 1]);
-
-  if (n_threads > 1) {
-    g_mutex_lock (&self->lock);
-    while (self->n_done < self->n_threads - 1)
-      g_cond_wait (&self->cond_done, &self->lock);
-    self->n_done = 0;
-    g_mutex_unlock (&self->lock);
-  }
-
-  self->func = NULL;
-  self->task_data = NULL;
-}
+#include "gst/parallelized-task-private.h"
 
 typedef struct _GstLineCache GstLineCache;
 
@@ -319,7 +121,6 @@ struct _MatrixData
 {
   gdouble dm[4][4];
   gint im[4][4];
-  gint width;
   guint64 orc_p1;
   guint64 orc_p2;
   guint64 orc_p3;
@@ -328,7 +129,7 @@ struct _MatrixData
   gint64 *t_g;
   gint64 *t_b;
   gint64 t_c;
-  void (*matrix_func) (MatrixData * data, gpointer pixels);
+  void (*matrix_func) (MatrixData * data, gpointer pixels, gint width);
 };
 
 typedef struct _GammaData GammaData;
@@ -336,8 +137,8 @@ typedef struct _GammaData GammaData;
 struct _GammaData
 {
   gpointer gamma_table;
-  gint width;
-  void (*gamma_func) (GammaData * data, gpointer dest, gpointer src);
+  void (*gamma_func) (GammaData * data, gpointer dest, gpointer src,
+      gint width);
 };
 
 typedef enum
@@ -358,6 +159,16 @@ typedef struct
   GDestroyNotify notify;
 } ConverterAlloc;
 
+/* A column of output pixels that is converted in one go. The ranges are
+ * relative to in_x/out_x and include margins for the horizontal filters,
+ * only pack_width pixels from pack_x are written to the destination. */
+typedef struct
+{
+  gint in_x, in_width;
+  gint out_x, out_width;
+  gint pack_x, pack_width;
+} ConvertTile;
+
 typedef void (*FastConvertFunc) (GstVideoConverter * convert,
     const GstVideoFrame * src, GstVideoFrame * dest, gint plane);
 
@@ -391,6 +202,12 @@ struct _GstVideoConverter
 
   GstParallelizedTaskRunner *conversion_runner;
 
+  /* tiles, a single tile covering the complete lines in line mode */
+  ConvertTile *tiles;
+  gint n_tiles;
+  /* the tile each thread is working on */
+  const ConvertTile **tile;
+
   guint16 **tmpline;
 
   gboolean fill_border;
@@ -433,7 +250,6 @@ struct _GstVideoConverter
   GstVideoScaler **v_scaler;
   GstVideoScaler **v_scaler_p;
   GstVideoScaler **v_scaler_i;
-  gint v_scale_width;
   gint v_scale_format;
 
   /* color space conversion */
@@ -523,6 +339,9 @@ struct _GstLineCache
 
   guint n_lines;
   guint stride;
+  /* bytes per pixel and if lines are after the horizontal scaler */
+  gint pstride;
+  gboolean out_range;
   GstLineCacheAllocLineFunc alloc_line;
   gpointer alloc_line_data;
   GDestroyNotify alloc_line_notify;
@@ -807,6 +626,7 @@ get_opt_enum (GstVideoConverter * convert, const gchar * opt, GType type,
 #define DEFAULT_OPT_RESAMPLER_TAPS 0
 #define DEFAULT_OPT_DITHER_METHOD GST_VIDEO_DITHER_BAYER
 #define DEFAULT_OPT_DITHER_QUANTIZATION 1
+#define DEFAULT_OPT_TILE_WIDTH 0
 
 #define GET_OPT_FILL_BORDER(c) get_opt_bool(c, \
     GST_VIDEO_CONVERTER_OPT_FILL_BORDER, DEFAULT_OPT_FILL_BORDER)
@@ -837,6 +657,8 @@ get_opt_enum (GstVideoConverter * convert, const gchar * opt, GType type,
     DEFAULT_OPT_DITHER_METHOD)
 #define GET_OPT_DITHER_QUANTIZATION(c) get_opt_uint(c, \
     GST_VIDEO_CONVERTER_OPT_DITHER_QUANTIZATION, DEFAULT_OPT_DITHER_QUANTIZATION)
+#define GET_OPT_TILE_WIDTH(c) get_opt_uint(c, \
+    GST_VIDEO_CONVERTER_OPT_TILE_WIDTH, DEFAULT_OPT_TILE_WIDTH)
 
 #define CHECK_ALPHA_COPY(c) (GET_OPT_ALPHA_MODE(c) == GST_VIDEO_ALPHA_MODE_COPY)
 #define CHECK_ALPHA_SET(c) (GET_OPT_ALPHA_MODE(c) == GST_VIDEO_ALPHA_MODE_SET)
@@ -883,6 +705,8 @@ chain_unpack_line (GstVideoConverter * convert, gint idx)
   prev->pass_alloc = FALSE;
   prev->n_lines = 1;
   prev->stride = convert->current_pstride * convert->current_width;
+  prev->pstride = convert->current_pstride;
+  prev->out_range = convert->h_scaler[idx] != NULL;
   gst_line_cache_set_need_line_func (prev, do_unpack_lines, idx, convert, NULL);
 
   return prev;
@@ -900,6 +724,8 @@ chain_upsample (GstVideoConverter * convert, GstLineCache * prev, gint idx)
     prev->pass_alloc = TRUE;
     prev->n_lines = 4;
     prev->stride = convert->current_pstride * convert->current_width;
+    prev->pstride = convert->current_pstride;
+    prev->out_range = convert->h_scaler[idx] != NULL;
     gst_line_cache_set_need_line_func (prev,
         do_upsample_lines, idx, convert, NULL);
   }
@@ -1190,21 +1016,23 @@ _custom_video_orc_matrix8 (guint8 * ORC_RESTRICT d1,
 }
 
 static void
-video_converter_matrix8 (MatrixData * data, gpointer pixels)
+video_converter_matrix8 (MatrixData * data, gpointer pixels, gint width)
 {
   video_orc_matrix8 (pixels, pixels, data->orc_p1, data->orc_p2,
-      data->orc_p3, data->orc_p4, data->width);
+      data->orc_p3, data->orc_p4, width);
 }
 
 static void
-video_converter_matrix8_table (MatrixData * data, gpointer pixels)
+video_converter_matrix8_table (MatrixData * data, gpointer pixels,
+    gint width)
 {
-  gint i, width = data->width * 4;
+  gint i;
   guint8 r, g, b;
   gint64 c = data->t_c;
   guint8 *p = pixels;
   gint64 x;
 
+  width *= 4;
   for (i = 0; i < width; i += 4) {
     r = p[i + 1];
     g = p[i + 2];
@@ -1219,11 +1047,12 @@ video_converter_matrix8_table (MatrixData * data, gpointer pixels)
 }
 
 static void
-video_converter_matrix8_AYUV_ARGB (MatrixData * data, gpointer pixels)
+video_converter_matrix8_AYUV_ARGB (MatrixData * data, gpointer pixels,
+    gint width)
 {
   video_orc_convert_AYUV_ARGB (pixels, 0, pixels, 0,
       data->im[0][0], data->im[0][2],
-      data->im[2][1], data->im[1][1], data->im[1][2], data->width, 1);
+      data->im[2][1], data->im[1][1], data->im[1][2], width, 1);
 }
 
 static gboolean
@@ -1304,13 +1133,12 @@ is_no_clip_matrix (MatrixData * data)
 }
 
 static void
-video_converter_matrix16 (MatrixData * data, gpointer pixels)
+video_converter_matrix16 (MatrixData * data, gpointer pixels, gint width)
 {
   int i;
   int r, g, b;
   int y, u, v;
   guint16 *p = pixels;
-  gint width = data->width;
 
   for (i = 0; i < width; i++) {
     r = p[i * 4 + 1];
@@ -1340,8 +1168,6 @@ prepare_matrix (GstVideoConverter * convert, MatrixData * data)
   color_matrix_scale_components (data, SCALE_F, SCALE_F, SCALE_F);
   color_matrix_convert (data);
 
-  data->width = convert->current_width;
-
   if (convert->current_bits == 8) {
     if (!convert->unpack_rgb && convert->pack_rgb
         && is_ayuv_to_rgb_matrix (data)) {
@@ -1454,14 +1280,15 @@ compute_matrix_to_YUV (GstVideoConverter * convert, MatrixData * data,
 
 
 static void
-gamma_convert_u8_u16 (GammaData * data, gpointer dest, gpointer src)
+gamma_convert_u8_u16 (GammaData * data, gpointer dest, gpointer src,
+    gint width)
 {
   gint i;
   guint8 *s = src;
   guint16 *d = dest;
   guint16 *table = data->gamma_table;
-  gint width = data->width * 4;
 
+  width *= 4;
   for (i = 0; i < width; i += 4) {
     d[i + 0] = (s[i] << 8) | s[i];
     d[i + 1] = table[s[i + 1]];
@@ -1471,14 +1298,15 @@ gamma_convert_u8_u16 (GammaData * data, gpointer dest, gpointer src)
 }
 
 static void
-gamma_convert_u16_u8 (GammaData * data, gpointer dest, gpointer src)
+gamma_convert_u16_u8 (GammaData * data, gpointer dest, gpointer src,
+    gint width)
 {
   gint i;
   guint16 *s = src;
   guint8 *d = dest;
   guint8 *table = data->gamma_table;
-  gint width = data->width * 4;
 
+  width *= 4;
   for (i = 0; i < width; i += 4) {
     d[i + 0] = s[i] >> 8;
     d[i + 1] = table[s[i + 1]];
@@ -1488,14 +1316,15 @@ gamma_convert_u16_u8 (GammaData * data, gpointer dest, gpointer src)
 }
 
 static void
-gamma_convert_u16_u16 (GammaData * data, gpointer dest, gpointer src)
+gamma_convert_u16_u16 (GammaData * data, gpointer dest, gpointer src,
+    gint width)
 {
   gint i;
   guint16 *s = src;
   guint16 *d = dest;
   guint16 *table = data->gamma_table;
-  gint width = data->width * 4;
 
+  width *= 4;
   for (i = 0; i < width; i += 4) {
     d[i + 0] = s[i];
     d[i + 1] = table[s[i + 1]];
@@ -1513,7 +1342,6 @@ setup_gamma_decode (GstVideoConverter * convert)
 
   func = convert->in_info.colorimetry.transfer;
 
-  convert->gamma_dec.width = convert->current_width;
   if (convert->current_bits == 8) {
     GST_DEBUG ("gamma decode 8->16: %d", func);
     convert->gamma_dec.gamma_func = gamma_convert_u8_u16;
@@ -1543,7 +1371,6 @@ setup_gamma_encode (GstVideoConverter * convert, gint target_bits)
 
   func = convert->out_info.colorimetry.transfer;
 
-  convert->gamma_enc.width = convert->current_width;
   if (target_bits == 8) {
     guint8 *t;
 
@@ -1600,11 +1427,15 @@ chain_convert_to_RGB (GstVideoConverter * convert, GstLineCache * prev,
     prev->pass_alloc = FALSE;
     prev->n_lines = 1;
     prev->stride = convert->current_pstride * convert->current_width;
+    prev->pstride = convert->current_pstride;
+    prev->out_range = convert->h_scaler[idx] != NULL;
     gst_line_cache_set_need_line_func (prev,
         do_convert_to_RGB_lines, idx, convert, NULL);
 
     GST_DEBUG ("chain gamma decode");
     setup_gamma_decode (convert);
+    /* gamma decoding produces 16 bits lines */
+    prev->pstride = convert->current_pstride;
   }
   return prev;
 }
@@ -1635,6 +1466,8 @@ chain_hscale (GstVideoConverter * convert, GstLineCache * prev, gint idx)
   prev->pass_alloc = FALSE;
   prev->n_lines = 1;
   prev->stride = convert->current_pstride * convert->current_width;
+  prev->pstride = convert->current_pstride;
+  prev->out_range = convert->h_scaler[idx] != NULL;
   gst_line_cache_set_need_line_func (prev, do_hscale_lines, idx, convert, NULL);
 
   return prev;
@@ -1661,7 +1494,6 @@ chain_vscale (GstVideoConverter * convert, GstLineCache * prev, gint idx)
   convert->v_scaler_p[idx] =
       gst_video_scaler_new (method, 0, taps, convert->in_height,
       convert->out_height, convert->config);
-  convert->v_scale_width = convert->current_width;
   convert->v_scale_format = convert->current_format;
   convert->current_height = convert->out_height;
 
@@ -1676,6 +1508,8 @@ chain_vscale (GstVideoConverter * convert, GstLineCache * prev, gint idx)
   prev->write_input = FALSE;
   prev->n_lines = MAX (taps_i, taps);
   prev->stride = convert->current_pstride * convert->current_width;
+  prev->pstride = convert->current_pstride;
+  prev->out_range = convert->h_scaler[idx] != NULL;
   gst_line_cache_set_need_line_func (prev, do_vscale_lines, idx, convert, NULL);
 
   return prev;
@@ -1835,6 +1669,8 @@ chain_convert (GstVideoConverter * convert, GstLineCache * prev, gint idx)
     prev->pass_alloc = pass_alloc;
     prev->n_lines = 1;
     prev->stride = convert->current_pstride * convert->current_width;
+    prev->pstride = convert->current_pstride;
+    prev->out_range = convert->h_scaler[idx] != NULL;
     gst_line_cache_set_need_line_func (prev,
         do_convert_lines, idx, convert, NULL);
   }
@@ -1921,6 +1757,8 @@ chain_alpha (GstVideoConverter * convert, GstLineCache * prev, gint idx)
   prev->pass_alloc = TRUE;
   prev->n_lines = 1;
   prev->stride = convert->current_pstride * convert->current_width;
+  prev->pstride = convert->current_pstride;
+  prev->out_range = convert->h_scaler[idx] != NULL;
   gst_line_cache_set_need_line_func (prev, do_alpha_lines, idx, convert, NULL);
 
   return prev;
@@ -1961,6 +1799,8 @@ chain_convert_to_YUV (GstVideoConverter * convert, GstLineCache * prev,
     prev->pass_alloc = FALSE;
     prev->n_lines = 1;
     prev->stride = convert->current_pstride * convert->current_width;
+    prev->pstride = convert->current_pstride;
+    prev->out_range = convert->h_scaler[idx] != NULL;
     gst_line_cache_set_need_line_func (prev,
         do_convert_to_YUV_lines, idx, convert, NULL);
   }
@@ -1978,6 +1818,8 @@ chain_downsample (GstVideoConverter * convert, GstLineCache * prev, gint idx)
     prev->pass_alloc = TRUE;
     prev->n_lines = 4;
     prev->stride = convert->current_pstride * convert->current_width;
+    prev->pstride = convert->current_pstride;
+    prev->out_range = convert->h_scaler[idx] != NULL;
     gst_line_cache_set_need_line_func (prev,
         do_downsample_lines, idx, convert, NULL);
   }
@@ -2042,6 +1884,8 @@ chain_dither (GstVideoConverter * convert, GstLineCache * prev, gint idx)
     prev->pass_alloc = TRUE;
     prev->n_lines = 1;
     prev->stride = convert->current_pstride * convert->current_width;
+    prev->pstride = convert->current_pstride;
+    prev->out_range = convert->h_scaler[idx] != NULL;
     gst_line_cache_set_need_line_func (prev, do_dither_lines, idx, convert,
         NULL);
   }
@@ -2205,6 +2049,141 @@ setup_borderline (GstVideoConverter * convert)
   }
 }
 
+/* alignment and margin in pixels of the tiles, enough to keep the chroma
+ * subsampling phase and to cover the reach of the chroma resamplers */
+#define TILE_ALIGN  16
+#define TILE_MARGIN 16
+
+static gboolean
+tile_format_supported (const GstVideoFormatInfo * finfo)
+{
+  gint i;
+
+  /* we need to be able to offset the planes to any aligned pixel */
+  if (GST_VIDEO_FORMAT_INFO_IS_TILED (finfo) ||
+      GST_VIDEO_FORMAT_INFO_HAS_PALETTE (finfo))
+    return FALSE;
+
+  for (i = 0; i < finfo->n_components; i++) {
+    if (finfo->pixel_stride[i] == 0)
+      return FALSE;
+  }
+  return TRUE;
+}
+
+/* the number of pixels that the start of a packed range has to be a
+ * multiple of, so that it doesn't split subsampled chroma or a macropixel */
+static gint
+tile_pack_align (const GstVideoFormatInfo * finfo)
+{
+  gint i, w_sub = 0;
+
+  for (i = 0; i < finfo->n_components; i++)
+    w_sub = MAX (w_sub, GST_VIDEO_FORMAT_INFO_W_SUB (finfo, i));
+
+  return 1 << w_sub;
+}
+
+static void
+setup_tiles (GstVideoConverter * convert)
+{
+  GstVideoDitherMethod method;
+  gint tile_width, n_tiles, align, i;
+
+  tile_width = GST_ROUND_UP_N (GET_OPT_TILE_WIDTH (convert), TILE_ALIGN);
+
+  if (tile_width > 0 && tile_width < convert->out_width) {
+    method = GET_OPT_DITHER_METHOD (convert);
+
+    if (!tile_format_supported (convert->in_info.finfo) ||
+        !tile_format_supported (convert->out_info.finfo)) {
+      GST_DEBUG ("formats can't be tiled, using lines");
+      tile_width = 0;
+    } else if (convert->dither[0] &&
+        (method == GST_VIDEO_DITHER_FLOYD_STEINBERG ||
+            method == GST_VIDEO_DITHER_SIERRA_LITE)) {
+      /* errors diffuse horizontally over the complete line */
+      GST_DEBUG ("error diffusion dither can't be tiled, using lines");
+      tile_width = 0;
+    }
+  } else {
+    tile_width = 0;
+  }
+
+  if (tile_width == 0) {
+    n_tiles = 1;
+    tile_width = convert->out_width;
+  } else {
+    n_tiles = (convert->out_width + tile_width - 1) / tile_width;
+    /* we pack the tiles ourselves */
+    convert->identity_pack = FALSE;
+  }
+
+  GST_DEBUG ("%d tiles of width %d", n_tiles, tile_width);
+
+  convert->n_tiles = n_tiles;
+  convert->tiles = g_new0 (ConvertTile, n_tiles);
+
+  /* the tiles are packed at out_x in the destination, move the boundaries
+   * between them back so that they are aligned in the destination. This
+   * stays well within the margins */
+  align = tile_pack_align (convert->out_info.finfo);
+
+  for (i = 0; i < n_tiles; i++) {
+    ConvertTile *tile = &convert->tiles[i];
+    gint x0, x1;
+
+    if (i == 0)
+      x0 = 0;
+    else
+      x0 = GST_ROUND_DOWN_N (convert->out_x + i * tile_width, align) -
+          convert->out_x;
+    if (i == n_tiles - 1)
+      x1 = convert->out_width;
+    else
+      x1 = GST_ROUND_DOWN_N (convert->out_x + (i + 1) * tile_width, align) -
+          convert->out_x;
+    tile->pack_x = x0;
+    tile->pack_width = x1 - x0;
+
+    if (n_tiles == 1) {
+      tile->in_x = 0;
+      tile->in_width = convert->in_width;
+      tile->out_x = 0;
+      tile->out_width = convert->out_width;
+      continue;
+    }
+
+    /* output pixels with margin for chroma downsampling */
+    x0 = MAX (tile->pack_x - TILE_MARGIN, 0);
+    x1 = MIN (tile->pack_x + tile->pack_width + TILE_MARGIN,
+        convert->out_width);
+    tile->out_x = x0;
+    tile->out_width = x1 - x0;
+
+    /* input pixels needed by the horizontal scaler */
+    if (convert->h_scaler[0]) {
+      guint offset, n_taps;
+
+      gst_video_scaler_get_coeff (convert->h_scaler[0], x0, &offset, NULL);
+      x0 = offset;
+      gst_video_scaler_get_coeff (convert->h_scaler[0], x1 - 1, &offset,
+          &n_taps);
+      x1 = offset + n_taps;
+    }
+    /* with margin for chroma upsampling */
+    x0 = MAX (GST_ROUND_DOWN_N (x0, TILE_ALIGN) - TILE_MARGIN, 0);
+    x1 = MIN (x1 + TILE_MARGIN, convert->in_width);
+    tile->in_x = x0;
+    tile->in_width = x1 - x0;
+  }
+
+  convert->tile = g_new0 (const ConvertTile *,
+      convert->conversion_runner->n_threads);
+  for (i = 0; i < convert->conversion_runner->n_threads; i++)
+    convert->tile[i] = &convert->tiles[0];
+}
+
 static AlphaMode
 convert_get_alpha_mode (GstVideoConverter * convert)
 {
@@ -2424,6 +2403,8 @@ gst_video_converter_new (GstVideoInfo * in_info, GstVideoInfo * out_info,
   }
 
   setup_borderline (convert);
+  /* split the lines in tiles if asked */
+  setup_tiles (convert);
   /* now figure out allocators */
   setup_allocators (convert);
 
@@ -2527,6 +2508,8 @@ gst_video_converter_free (GstVideoConverter * convert)
   g_free (convert->downsample_lines);
   g_free (convert->dither_lines);
   g_free (convert->dither);
+  g_free (convert->tiles);
+  g_free (convert->tile);
 
   g_free (convert->gamma_dec.gamma_table);
   g_free (convert->gamma_enc.gamma_table);
@@ -2769,6 +2752,37 @@ get_dest_line (GstLineCache * cache, gint idx, gpointer user_data)
   return line;
 }
 
+/* get the range of pixels of the tile thread @idx is working on in the
+ * lines of @cache */
+static inline void
+get_tile_range (GstVideoConverter * convert, GstLineCache * cache, gint idx,
+    gint * x, gint * width)
+{
+  const ConvertTile *tile = convert->tile[idx];
+
+  if (cache->out_range) {
+    *x = tile->out_x;
+    *width = tile->out_width;
+  } else {
+    *x = tile->in_x;
+    *width = tile->in_width;
+  }
+}
+
+static gpointer *
+offset_lines (gpointer * lines, gint n_lines, gint offset, gpointer * tlines)
+{
+  gint i;
+
+  if (offset == 0)
+    return lines;
+
+  for (i = 0; i < n_lines; i++)
+    tlines[i] = (guint8 *) lines[i] + offset;
+
+  return tlines;
+}
+
 static gboolean
 do_unpack_lines (GstLineCache * cache, gint idx, gint out_line, gint in_line,
     gpointer user_data)
@@ -2776,14 +2790,17 @@ do_unpack_lines (GstLineCache * cache, gint idx, gint out_line, gint in_line,
   GstVideoConverter *convert = user_data;
   gpointer tmpline;
   guint cline;
+  gint x, width;
 
   cline = CLAMP (in_line + convert->in_y, 0, convert->in_maxheight - 1);
 
   if (cache->alloc_writable || !convert->identity_unpack) {
+    get_tile_range (convert, cache, idx, &x, &width);
+
     tmpline = gst_line_cache_alloc_line (cache, out_line);
     GST_DEBUG ("unpack line %d (%u) %p", in_line, cline, tmpline);
-    UNPACK_FRAME (convert->src, tmpline, cline, convert->in_x,
-        convert->in_width);
+    UNPACK_FRAME (convert->src, (guint8 *) tmpline + x * cache->pstride,
+        cline, convert->in_x + x, width);
   } else {
     tmpline = ((guint8 *) FRAME_GET_LINE (convert->src, cline)) +
         convert->in_x * convert->unpack_pstride;
@@ -2800,7 +2817,7 @@ do_upsample_lines (GstLineCache * cache, gint idx, gint out_line, gint in_line,
 {
   GstVideoConverter *convert = user_data;
   gpointer *lines;
-  gint i, start_line, n_lines;
+  gint i, start_line, n_lines, x, width;
 
   n_lines = convert->up_n_lines;
   start_line = in_line;
@@ -2815,10 +2832,13 @@ do_upsample_lines (GstLineCache * cache, gint idx, gint out_line, gint in_line,
       n_lines);
 
   if (convert->upsample) {
+    get_tile_range (convert, cache, idx, &x, &width);
+
     GST_DEBUG ("doing upsample %d-%d %p", start_line, start_line + n_lines - 1,
         lines[0]);
-    gst_video_chroma_resample (convert->upsample[idx], lines,
-        convert->in_width);
+    gst_video_chroma_resample (convert->upsample[idx],
+        offset_lines (lines, n_lines, x * cache->pstride,
+            g_newa (gpointer, n_lines)), width);
   }
 
   for (i = 0; i < n_lines; i++)
@@ -2834,19 +2854,25 @@ do_convert_to_RGB_lines (GstLineCache * cache, gint idx, gint out_line,
   GstVideoConverter *convert = user_data;
   MatrixData *data = &convert->to_RGB_matrix;
   gpointer *lines, destline;
+  gint x, width;
 
   lines = gst_line_cache_get_lines (cache->prev, idx, out_line, in_line, 1);
   destline = lines[0];
 
+  get_tile_range (convert, cache, idx, &x, &width);
+
   if (data->matrix_func) {
     GST_DEBUG ("to RGB line %d %p", in_line, destline);
-    data->matrix_func (data, destline);
+    data->matrix_func (data, (guint8 *) destline + x * cache->prev->pstride,
+        width);
   }
   if (convert->gamma_dec.gamma_func) {
     destline = gst_line_cache_alloc_line (cache, out_line);
 
     GST_DEBUG ("gamma decode line %d %p->%p", in_line, lines[0], destline);
-    convert->gamma_dec.gamma_func (&convert->gamma_dec, destline, lines[0]);
+    convert->gamma_dec.gamma_func (&convert->gamma_dec,
+        (guint8 *) destline + x * cache->pstride,
+        (guint8 *) lines[0] + x * cache->prev->pstride, width);
   }
   gst_line_cache_add_line (cache, in_line, destline);
 
@@ -2866,7 +2892,8 @@ do_hscale_lines (GstLineCache * cache, gint idx, gint out_line, gint in_line,
 
   GST_DEBUG ("hresample line %d %p->%p", in_line, lines[0], destline);
   gst_video_scaler_horizontal (convert->h_scaler[idx], convert->h_scale_format,
-      lines[0], destline, 0, convert->out_width);
+      lines[0], destline, convert->tile[idx]->out_x,
+      convert->tile[idx]->out_width);
 
   gst_line_cache_add_line (cache, in_line, destline);
 
@@ -2881,6 +2908,7 @@ do_vscale_lines (GstLineCache * cache, gint idx, gint out_line, gint in_line,
   gpointer *lines, destline;
   guint sline, n_lines;
   guint cline;
+  gint x, width;
 
   cline = CLAMP (in_line, 0, convert->out_height - 1);
 
@@ -2889,10 +2917,14 @@ do_vscale_lines (GstLineCache * cache, gint idx, gint out_line, gint in_line,
 
   destline = gst_line_cache_alloc_line (cache, out_line);
 
+  get_tile_range (convert, cache, idx, &x, &width);
+
   GST_DEBUG ("vresample line %d %d-%d %p->%p", in_line, sline,
       sline + n_lines - 1, lines[0], destline);
   gst_video_scaler_vertical (convert->v_scaler[idx], convert->v_scale_format,
-      lines, destline, cline, convert->v_scale_width);
+      offset_lines (lines, n_lines, x * cache->pstride,
+          g_newa (gpointer, n_lines)),
+      (guint8 *) destline + x * cache->pstride, cline, width);
 
   gst_line_cache_add_line (cache, in_line, destline);
 
@@ -2907,7 +2939,7 @@ do_convert_lines (GstLineCache * cache, gint idx, gint out_line, gint in_line,
   MatrixData *data = &convert->convert_matrix;
   gpointer *lines, destline;
   guint in_bits, out_bits;
-  gint width;
+  gint x, width;
 
   lines = gst_line_cache_get_lines (cache->prev, idx, out_line, in_line, 1);
 
@@ -2916,35 +2948,38 @@ do_convert_lines (GstLineCache * cache, gint idx, gint out_line, gint in_line,
   in_bits = convert->in_bits;
   out_bits = convert->out_bits;
 
-  width = MIN (convert->in_width, convert->out_width);
+  get_tile_range (convert, cache, idx, &x, &width);
 
   if (out_bits == 16 || in_bits == 16) {
-    gpointer srcline = lines[0];
+    gpointer srcline = (guint8 *) lines[0] + x * cache->prev->pstride;
+    gpointer dstline;
 
     if (out_bits != in_bits)
       destline = gst_line_cache_alloc_line (cache, out_line);
+    dstline = (guint8 *) destline + x * cache->pstride;
 
     /* FIXME, we can scale in the conversion matrix */
     if (in_bits == 8) {
       GST_DEBUG ("8->16 line %d %p->%p", in_line, srcline, destline);
-      video_orc_convert_u8_to_u16 (destline, srcline, width * 4);
-      srcline = destline;
+      video_orc_convert_u8_to_u16 (dstline, srcline, width * 4);
+      srcline = dstline;
     }
 
     if (data->matrix_func) {
       GST_DEBUG ("matrix line %d %p", in_line, srcline);
-      data->matrix_func (data, srcline);
+      data->matrix_func (data, srcline, width);
     }
 
     /* FIXME, dither here */
     if (out_bits == 8) {
       GST_DEBUG ("16->8 line %d %p->%p", in_line, srcline, destline);
-      video_orc_convert_u16_to_u8 (destline, srcline, width * 4);
+      video_orc_convert_u16_to_u8 (dstline, srcline, width * 4);
     }
   } else {
     if (data->matrix_func) {
       GST_DEBUG ("matrix line %d %p", in_line, destline);
-      data->matrix_func (data, destline);
+      data->matrix_func (data, (guint8 *) destline + x * cache->pstride,
+          width);
     }
   }
   gst_line_cache_add_line (cache, in_line, destline);
@@ -2958,13 +2993,16 @@ do_alpha_lines (GstLineCache * cache, gint idx, gint out_line, gint in_line,
 {
   gpointer *lines, destline;
   GstVideoConverter *convert = user_data;
-  gint width = MIN (convert->in_width, convert->out_width);
+  gint x, width;
 
   lines = gst_line_cache_get_lines (cache->prev, idx, out_line, in_line, 1);
   destline = lines[0];
 
+  get_tile_range (convert, cache, idx, &x, &width);
+
   GST_DEBUG ("alpha line %d %p", in_line, destline);
-  convert->alpha_func (convert, destline, width);
+  convert->alpha_func (convert, (guint8 *) destline + x * cache->pstride,
+      width);
 
   gst_line_cache_add_line (cache, in_line, destline);
 
@@ -2978,19 +3016,24 @@ do_convert_to_YUV_lines (GstLineCache * cache, gint idx, gint out_line,
   GstVideoConverter *convert = user_data;
   MatrixData *data = &convert->to_YUV_matrix;
   gpointer *lines, destline;
+  gint x, width;
 
   lines = gst_line_cache_get_lines (cache->prev, idx, out_line, in_line, 1);
   destline = lines[0];
 
+  get_tile_range (convert, cache, idx, &x, &width);
+
   if (convert->gamma_enc.gamma_func) {
     destline = gst_line_cache_alloc_line (cache, out_line);
 
     GST_DEBUG ("gamma encode line %d %p->%p", in_line, lines[0], destline);
-    convert->gamma_enc.gamma_func (&convert->gamma_enc, destline, lines[0]);
+    convert->gamma_enc.gamma_func (&convert->gamma_enc,
+        (guint8 *) destline + x * cache->pstride,
+        (guint8 *) lines[0] + x * cache->prev->pstride, width);
   }
   if (data->matrix_func) {
     GST_DEBUG ("to YUV line %d %p", in_line, destline);
-    data->matrix_func (data, destline);
+    data->matrix_func (data, (guint8 *) destline + x * cache->pstride, width);
   }
   gst_line_cache_add_line (cache, in_line, destline);
 
@@ -3003,7 +3046,7 @@ do_downsample_lines (GstLineCache * cache, gint idx, gint out_line,
 {
   GstVideoConverter *convert = user_data;
   gpointer *lines;
-  gint i, start_line, n_lines;
+  gint i, start_line, n_lines, x, width;
 
   n_lines = convert->down_n_lines;
   start_line = in_line;
@@ -3016,10 +3059,13 @@ do_downsample_lines (GstLineCache * cache, gint idx, gint out_line,
       n_lines);
 
   if (convert->downsample) {
+    get_tile_range (convert, cache, idx, &x, &width);
+
     GST_DEBUG ("downsample line %d %d-%d %p", in_line, start_line,
         start_line + n_lines - 1, lines[0]);
-    gst_video_chroma_resample (convert->downsample[idx], lines,
-        convert->out_width);
+    gst_video_chroma_resample (convert->downsample[idx],
+        offset_lines (lines, n_lines, x * cache->pstride,
+            g_newa (gpointer, n_lines)), width);
   }
 
   for (i = 0; i < n_lines; i++)
@@ -3034,51 +3080,115 @@ do_dither_lines (GstLineCache * cache, gint idx, gint out_line, gint in_line,
 {
   GstVideoConverter *convert = user_data;
   gpointer *lines, destline;
+  gint x, width;
 
   lines = gst_line_cache_get_lines (cache->prev, idx, out_line, in_line, 1);
   destline = lines[0];
 
   if (convert->dither) {
+    get_tile_range (convert, cache, idx, &x, &width);
+
     GST_DEBUG ("Dither line %d %p", in_line, destline);
-    gst_video_dither_line (convert->dither[idx], destline, 0, out_line,
-        convert->out_width);
+    gst_video_dither_line (convert->dither[idx], destline, x, out_line, width);
   }
   gst_line_cache_add_line (cache, in_line, destline);
 
   return TRUE;
 }
 
+/* pack @width pixels of @src starting from pixel @x into @frame */
+static void
+pack_frame_range (GstVideoFrame * frame, gpointer src, gint pstride,
+    gint line, gint x, gint width)
+{
+  const GstVideoFormatInfo *finfo = frame->info.finfo;
+  gpointer data[GST_VIDEO_MAX_PLANES];
+  gint i;
+
+  if (x == 0) {
+    PACK_FRAME (frame, src, line, width);
+    return;
+  }
+
+  /* only formats with a fixed pixel stride are tiled, offset the planes
+   * to the first pixel */
+  for (i = 0; i < GST_VIDEO_MAX_PLANES; i++)
+    data[i] = frame->data[i];
+  for (i = 0; i < finfo->n_components; i++) {
+    gint plane = finfo->plane[i];
+
+    data[plane] = (guint8 *) frame->data[plane] +
+        GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (finfo, i, x) *
+        finfo->pixel_stride[i];
+  }
+  finfo->pack_func (finfo,
+      (GST_VIDEO_FRAME_IS_INTERLACED (frame) ?
+          GST_VIDEO_PACK_FLAG_INTERLACED :
+          GST_VIDEO_PACK_FLAG_NONE),
+      (guint8 *) src + x * pstride, 0, data, frame->info.stride,
+      frame->info.chroma_site, line, width);
+}
+
 typedef struct
 {
   GstLineCache *pack_lines;
   gint idx;
   gint h_0, h_1;
   gint pack_lines_count;
-  gint out_y;
+  gint out_x, out_y;
   gboolean identity_pack;
   gint lb_width, out_maxwidth;
+  gint pstride;
   GstVideoFrame *dest;
+  const ConvertTile *tiles;
+  gint n_tiles;
+  const ConvertTile **tile;
 } ConvertTask;
 
 static void
 convert_generic_task (ConvertTask * task)
 {
-  gint i;
+  gint i, t;
 
-  for (i = task->h_0; i < task->h_1; i += task->pack_lines_count) {
-    gpointer *lines;
+  for (t = 0; t < task->n_tiles; t++) {
+    const ConvertTile *tile = &task->tiles[t];
+    gint x, width;
 
-    /* load the lines needed to pack */
-    lines =
-        gst_line_cache_get_lines (task->pack_lines, task->idx, i + task->out_y,
-        i, task->pack_lines_count);
+    if (task->n_tiles > 1) {
+      GstLineCache *cache;
 
-    if (!task->identity_pack) {
-      /* take away the border */
-      guint8 *l = ((guint8 *) lines[0]) - task->lb_width;
-      /* and pack into destination */
-      GST_DEBUG ("pack line %d %p (%p)", i + task->out_y, lines[0], l);
-      PACK_FRAME (task->dest, l, i + task->out_y, task->out_maxwidth);
+      /* all lines need to be made again for the next tile */
+      for (cache = task->pack_lines; cache; cache = cache->prev)
+        gst_line_cache_clear (cache);
+    }
+    *task->tile = tile;
+
+    /* the first and last tile also pack the borders */
+    if (t == 0)
+      x = 0;
+    else
+      x = task->out_x + tile->pack_x;
+    if (t == task->n_tiles - 1)
+      width = task->out_maxwidth - x;
+    else
+      width = task->out_x + tile->pack_x + tile->pack_width - x;
+
+    for (i = task->h_0; i < task->h_1; i += task->pack_lines_count) {
+      gpointer *lines;
+
+      /* load the lines needed to pack */
+      lines =
+          gst_line_cache_get_lines (task->pack_lines, task->idx,
+          i + task->out_y, i, task->pack_lines_count);
+
+      if (!task->identity_pack) {
+        /* take away the border */
+        guint8 *l = ((guint8 *) lines[0]) - task->lb_width;
+        /* and pack into destination */
+        GST_DEBUG ("pack line %d %p (%p)", i + task->out_y, lines[0], l);
+        pack_frame_range (task->dest, l, task->pstride, i + task->out_y, x,
+            width);
+      }
     }
   }
 }
@@ -3156,10 +3266,15 @@ video_converter_generic (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks[i].pack_lines = convert->pack_lines[i];
     tasks[i].idx = i;
     tasks[i].pack_lines_count = pack_lines;
+    tasks[i].out_x = out_x;
     tasks[i].out_y = out_y;
     tasks[i].identity_pack = convert->identity_pack;
     tasks[i].lb_width = lb_width;
     tasks[i].out_maxwidth = out_maxwidth;
+    tasks[i].pstride = pstride;
+    tasks[i].tiles = convert->tiles;
+    tasks[i].n_tiles = convert->n_tiles;
+    tasks[i].tile = &convert->tile[i];
 
     tasks[i].h_0 = i * lines_per_thread;
     tasks[i].h_1 = MIN ((i + 1) * lines_per_thread, out_height);
@@ -6191,6 +6306,564 @@ setup_scale (GstVideoConverter * convert)
   return TRUE;
 }
 
+/* Fused scale and convert: each thread scales the source lines it needs
+ * for a pair of output lines into temporary lines of the output width and
+ * converts those straight into the destination, so that the data goes only
+ * once through the caches. */
+#define FUSED_N_LINES 4
+#define FUSED_N_CACHES 3
+#define FUSED_LINE_STRIDE(w) GST_ROUND_UP_16 (((w) + 8) * 4)
+
+/* the number of horizontally scaled lines kept for each plane */
+static guint
+fused_cache_lines (GstVideoConverter * convert)
+{
+  guint j, n_lines = 0;
+
+  for (j = 0; j < 2; j++) {
+    if (convert->fh_scaler[j].scaler && convert->fv_scaler[j].scaler)
+      n_lines = MAX (n_lines,
+          gst_video_scaler_get_max_taps (convert->fv_scaler[j].scaler[0]));
+  }
+  return n_lines;
+}
+
+/* the fused paths scale the chroma planes on their own grid and average
+ * chroma over line pairs, so they can't move chroma between sitings */
+static gboolean
+fused_chroma_site_supported (GstVideoConverter * convert)
+{
+  GstVideoChromaSite in_site, out_site;
+
+  in_site = convert->in_info.chroma_site;
+  out_site = convert->out_info.chroma_site;
+
+  if (out_site & (GST_VIDEO_CHROMA_SITE_V_COSITED |
+          GST_VIDEO_CHROMA_SITE_ALT_LINE))
+    return FALSE;
+
+  if (GST_VIDEO_INFO_IS_YUV (&convert->in_info))
+    return in_site == out_site;
+
+  return TRUE;
+}
+
+static gboolean
+setup_scale_fused (GstVideoConverter * convert)
+{
+  GstVideoInfo *in_info, *out_info;
+  const GstVideoFormatInfo *in_finfo, *out_finfo;
+  GstVideoFormat in_format;
+  gint method, cr_method, in_width, in_height, out_width, out_height;
+  guint taps, n_threads, n_lines, j;
+
+  in_info = &convert->in_info;
+  out_info = &convert->out_info;
+  in_finfo = in_info->finfo;
+  out_finfo = out_info->finfo;
+  in_format = GST_VIDEO_INFO_FORMAT (in_info);
+
+  in_width = convert->in_width;
+  in_height = convert->in_height;
+  out_width = convert->out_width;
+  out_height = convert->out_height;
+
+  if (in_width == 0 || in_height == 0 || out_width == 0 || out_height == 0)
+    return FALSE;
+
+  method = GET_OPT_RESAMPLER_METHOD (convert);
+  if (method == GST_VIDEO_RESAMPLER_METHOD_NEAREST)
+    cr_method = method;
+  else
+    cr_method = GET_OPT_CHROMA_RESAMPLER_METHOD (convert);
+  taps = GET_OPT_RESAMPLER_TAPS (convert);
+
+  n_threads = convert->conversion_runner->n_threads;
+
+  convert->fformat[0] = get_scale_format (in_format, 0);
+
+  if (in_width != out_width) {
+    convert->fh_scaler[0].scaler = g_new (GstVideoScaler *, n_threads);
+    for (j = 0; j < n_threads; j++) {
+      if (is_merge_yuv (in_info)) {
+        GstVideoScaler *y_scaler, *uv_scaler;
+
+        y_scaler =
+            gst_video_scaler_new (method, GST_VIDEO_SCALER_FLAG_NONE, taps,
+            GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (in_finfo, GST_VIDEO_COMP_Y,
+                in_width), GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (in_finfo,
+                GST_VIDEO_COMP_Y, out_width), convert->config);
+        uv_scaler =
+            gst_video_scaler_new (method, GST_VIDEO_SCALER_FLAG_NONE,
+            gst_video_scaler_get_max_taps (y_scaler),
+            GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (in_finfo, GST_VIDEO_COMP_U,
+                in_width), GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (in_finfo,
+                GST_VIDEO_COMP_U, out_width), convert->config);
+
+        /* we scale into lines with the packing of the input */
+        convert->fh_scaler[0].scaler[j] =
+            gst_video_scaler_combine_packed_YUV (y_scaler, uv_scaler,
+            in_format, in_format);
+
+        gst_video_scaler_free (y_scaler);
+        gst_video_scaler_free (uv_scaler);
+      } else {
+        convert->fh_scaler[0].scaler[j] =
+            gst_video_scaler_new (method, GST_VIDEO_SCALER_FLAG_NONE, taps,
+            in_width, out_width, convert->config);
+      }
+    }
+  }
+  if (in_height != out_height) {
+    convert->fv_scaler[0].scaler = g_new (GstVideoScaler *, n_threads);
+    for (j = 0; j < n_threads; j++)
+      convert->fv_scaler[0].scaler[j] =
+          gst_video_scaler_new (method, GST_VIDEO_SCALER_FLAG_NONE, taps,
+          in_height, out_height, convert->config);
+  }
+
+  if (GST_VIDEO_INFO_N_PLANES (in_info) > 1) {
+    gint iw, ih, ow, oh;
+
+    iw = GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (in_finfo, GST_VIDEO_COMP_U,
+        in_width);
+    ih = GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (in_finfo, GST_VIDEO_COMP_U,
+        in_height);
+    ow = GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (out_finfo, GST_VIDEO_COMP_U,
+        out_width);
+    oh = GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (out_finfo, GST_VIDEO_COMP_U,
+        out_height);
+
+    convert->fformat[1] = get_scale_format (in_format, 1);
+
+    if (iw != ow) {
+      convert->fh_scaler[1].scaler = g_new (GstVideoScaler *, n_threads);
+      for (j = 0; j < n_threads; j++)
+        convert->fh_scaler[1].scaler[j] =
+            gst_video_scaler_new (cr_method, GST_VIDEO_SCALER_FLAG_NONE,
+            taps, iw, ow, convert->config);
+    }
+    if (ih != oh) {
+      convert->fv_scaler[1].scaler = g_new (GstVideoScaler *, n_threads);
+      for (j = 0; j < n_threads; j++)
+        convert->fv_scaler[1].scaler[j] =
+            gst_video_scaler_new (cr_method, GST_VIDEO_SCALER_FLAG_NONE,
+            taps, ih, oh, convert->config);
+    }
+  }
+
+  /* make room for the temporary lines of the output width and the
+   * horizontally scaled source lines of each plane */
+  n_lines = FUSED_N_LINES + FUSED_N_CACHES * fused_cache_lines (convert);
+  for (j = 0; j < n_threads; j++)
+    convert->tmpline[j] = g_realloc (convert->tmpline[j],
+        n_lines * FUSED_LINE_STRIDE (MAX (in_width, out_width)));
+
+  return TRUE;
+}
+
+typedef struct
+{
+  const GstVideoFrame *src;
+  GstVideoFrame *dest;
+  gint height_0, height_1;
+
+  /* parameters */
+  GstVideoScaler *h_scaler[2], *v_scaler[2];
+  GstVideoFormat format[2];
+  MatrixData *data;
+  gint in_x, in_y;
+  gint out_x, out_y;
+  gint out_width, out_height;
+  guint8 *lines;
+  gint lstride;
+  guint n_cache_lines;
+} FFusedScaleTask;
+
+#define FUSED_LINE(task,i) ((task)->lines + (i) * (task)->lstride)
+
+/* keeps the last horizontally scaled lines of a source plane so that
+ * consecutive output lines don't scale the lines they share again */
+typedef struct
+{
+  GstVideoScaler *h_scaler, *v_scaler;
+  GstVideoFormat format;
+  guint8 *src;
+  gint sstride;
+  gint width;
+
+  guint n_lines;
+  guint8 *lines;
+  gint lstride;
+  gint *line_in;
+  gpointer *src_lines;
+} FFusedLineCache;
+
+static void
+fused_cache_init (FFusedLineCache * cache, FFusedScaleTask * task, gint idx,
+    gint cache_idx, gpointer src, gint sstride, gint width, gint * line_in,
+    gpointer * src_lines)
+{
+  guint i;
+
+  cache->h_scaler = task->h_scaler[idx];
+  cache->v_scaler = task->v_scaler[idx];
+  cache->format = task->format[idx];
+  cache->src = src;
+  cache->sstride = sstride;
+  cache->width = width;
+
+  cache->n_lines = task->n_cache_lines;
+  cache->lines = FUSED_LINE (task, FUSED_N_LINES +
+      cache_idx * task->n_cache_lines);
+  cache->lstride = task->lstride;
+  cache->line_in = line_in;
+  cache->src_lines = src_lines;
+  for (i = 0; i < cache->n_lines; i++)
+    cache->line_in[i] = -1;
+}
+
+/* get source line @in scaled to the output width */
+static inline gpointer
+fused_cache_get_line (FFusedLineCache * cache, gint in)
+{
+  guint8 *line;
+  guint slot;
+
+  if (cache->h_scaler == NULL)
+    return cache->src + in * cache->sstride;
+
+  slot = in % cache->n_lines;
+  line = cache->lines + slot * cache->lstride;
+  if (cache->line_in[slot] != in) {
+    gst_video_scaler_horizontal (cache->h_scaler, cache->format,
+        cache->src + in * cache->sstride, line, 0, cache->width);
+    cache->line_in[slot] = in;
+  }
+  return line;
+}
+
+/* scale output line @y of the plane of @cache into @dest */
+static inline void
+fused_scale_line (FFusedLineCache * cache, gint y, gpointer dest)
+{
+  guint in, n_taps, i;
+
+  if (cache->v_scaler == NULL) {
+    /* with a dest stride of 0 line @y ends up at @dest */
+    gst_video_scaler_2d (cache->h_scaler, NULL, cache->format, cache->src,
+        cache->sstride, dest, 0, 0, y, cache->width, y + 1);
+    return;
+  }
+
+  gst_video_scaler_get_coeff (cache->v_scaler, y, &in, &n_taps);
+  for (i = 0; i < n_taps; i++)
+    cache->src_lines[i] = fused_cache_get_line (cache, in + i);
+
+  gst_video_scaler_vertical (cache->v_scaler, cache->format,
+      cache->src_lines, dest, y, cache->width);
+}
+
+static void
+convert_scale_420_task (FFusedScaleTask * task)
+{
+  const GstVideoFormatInfo *sfinfo = task->src->info.finfo;
+  const GstVideoFormatInfo *dfinfo = task->dest->info.finfo;
+  FFusedLineCache cy, cu, cv;
+  guint8 *sy, *suv, *sv, *dy, *du, *dv, *tu, *tv;
+  gint sy_stride, suv_stride, sv_stride;
+  gint sps, dps, cw, y, l, i;
+  gint *line_in;
+  gpointer *src_lines;
+
+  sps = GST_VIDEO_FORMAT_INFO_PSTRIDE (sfinfo, GST_VIDEO_COMP_U);
+  dps = GST_VIDEO_FORMAT_INFO_PSTRIDE (dfinfo, GST_VIDEO_COMP_U);
+  cw = GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (dfinfo, GST_VIDEO_COMP_U,
+      task->out_width);
+
+  line_in = g_newa (gint, FUSED_N_CACHES * task->n_cache_lines + 1);
+  src_lines = g_newa (gpointer, FUSED_N_CACHES * task->n_cache_lines + 1);
+
+  sy = FRAME_GET_Y_LINE (task->src, task->in_y);
+  sy += task->in_x;
+  sy_stride = FRAME_GET_Y_STRIDE (task->src);
+  fused_cache_init (&cy, task, 0, 0, sy, sy_stride, task->out_width,
+      line_in, src_lines);
+
+  if (sps == 2) {
+    /* semi-planar, scale the complete chroma line at once */
+    suv = FRAME_GET_PLANE_LINE (task->src, 1, task->in_y >> 1);
+    suv += (task->in_x >> 1) * 2;
+    suv_stride = FRAME_GET_PLANE_STRIDE (task->src, 1);
+    sv = NULL;
+    sv_stride = 0;
+    tu = FUSED_LINE (task, 0) +
+        GST_VIDEO_FORMAT_INFO_POFFSET (sfinfo, GST_VIDEO_COMP_U);
+    tv = FUSED_LINE (task, 0) +
+        GST_VIDEO_FORMAT_INFO_POFFSET (sfinfo, GST_VIDEO_COMP_V);
+  } else {
+    suv = FRAME_GET_U_LINE (task->src, task->in_y >> 1);
+    suv += task->in_x >> 1;
+    suv_stride = FRAME_GET_U_STRIDE (task->src);
+    sv = FRAME_GET_V_LINE (task->src, task->in_y >> 1);
+    sv += task->in_x >> 1;
+    sv_stride = FRAME_GET_V_STRIDE (task->src);
+    tu = FUSED_LINE (task, 0);
+    tv = FUSED_LINE (task, 1);
+    fused_cache_init (&cv, task, 1, 2, sv, sv_stride, cw,
+        line_in + 2 * task->n_cache_lines,
+        src_lines + 2 * task->n_cache_lines);
+  }
+  fused_cache_init (&cu, task, 1, 1, suv, suv_stride, cw,
+      line_in + task->n_cache_lines, src_lines + task->n_cache_lines);
+
+  for (y = task->height_0; y < task->height_1; y += 2) {
+    /* luma goes straight into the destination */
+    for (l = y; l < MIN (y + 2, task->out_height); l++) {
+      dy = FRAME_GET_Y_LINE (task->dest, l + task->out_y);
+      dy += task->out_x;
+      fused_scale_line (&cy, l, dy);
+    }
+
+    /* scale the chroma of the line pair and weave it into the
+     * destination */
+    if (sps == 2) {
+      fused_scale_line (&cu, y >> 1, FUSED_LINE (task, 0));
+    } else {
+      fused_scale_line (&cu, y >> 1, tu);
+      fused_scale_line (&cv, y >> 1, tv);
+    }
+
+    du = FRAME_GET_U_LINE (task->dest, (task->out_y >> 1) + (y >> 1));
+    du += (task->out_x >> 1) * dps;
+    dv = FRAME_GET_V_LINE (task->dest, (task->out_y >> 1) + (y >> 1));
+    dv += (task->out_x >> 1) * dps;
+
+    for (i = 0; i < cw; i++) {
+      du[i * dps] = tu[i * sps];
+      dv[i * dps] = tv[i * sps];
+    }
+  }
+}
+
+static void
+convert_scale_YUY2_I420_task (FFusedScaleTask * task)
+{
+  GstVideoFormat format = GST_VIDEO_FRAME_FORMAT (task->src);
+  FFusedLineCache cache;
+  guint8 *s, *dy1, *dy2, *du, *dv;
+  gint sstride, y, l2;
+  gint *line_in;
+  gpointer *src_lines;
+
+  s = FRAME_GET_LINE (task->src, task->in_y);
+  s += GST_ROUND_UP_2 (task->in_x) * 2;
+  sstride = FRAME_GET_STRIDE (task->src);
+
+  line_in = g_newa (gint, task->n_cache_lines + 1);
+  src_lines = g_newa (gpointer, task->n_cache_lines + 1);
+  fused_cache_init (&cache, task, 0, 0, s, sstride, task->out_width,
+      line_in, src_lines);
+
+  for (y = task->height_0; y < task->height_1; y += 2) {
+    l2 = MIN (y + 1, task->out_height - 1);
+
+    fused_scale_line (&cache, y, FUSED_LINE (task, 0));
+    fused_scale_line (&cache, l2, FUSED_LINE (task, 1));
+
+    dy1 = FRAME_GET_Y_LINE (task->dest, y + task->out_y);
+    dy1 += task->out_x;
+    /* write the second luma line of an odd height into a scratch line */
+    if (l2 == y)
+      dy2 = FUSED_LINE (task, 2);
+    else
+      dy2 = (guint8 *) FRAME_GET_Y_LINE (task->dest,
+          l2 + task->out_y) + task->out_x;
+    du = FRAME_GET_U_LINE (task->dest, (task->out_y >> 1) + (y >> 1));
+    du += task->out_x >> 1;
+    dv = FRAME_GET_V_LINE (task->dest, (task->out_y >> 1) + (y >> 1));
+    dv += task->out_x >> 1;
+
+    if (format == GST_VIDEO_FORMAT_UYVY)
+      video_orc_convert_UYVY_I420 (dy1, dy2, du, dv, FUSED_LINE (task, 0),
+          FUSED_LINE (task, 1), (task->out_width + 1) / 2);
+    else
+      video_orc_convert_YUY2_I420 (dy1, dy2, du, dv, FUSED_LINE (task, 0),
+          FUSED_LINE (task, 1), (task->out_width + 1) / 2);
+  }
+}
+
+static void
+convert_scale_RGBA_NV12_task (FFusedScaleTask * task)
+{
+  const GstVideoFormatInfo *sfinfo = task->src->info.finfo;
+  const GstVideoFormatInfo *dfinfo = task->dest->info.finfo;
+  MatrixData *data = task->data;
+  FFusedLineCache cache;
+  guint8 *s, *dy1, *dy2, *du, *dv, *a1, *a2;
+  gint sstride, dps, width, cw, y, l2, i, i0, i1, i2;
+  gint stride[GST_VIDEO_MAX_PLANES] = { 0, };
+  gpointer lines[GST_VIDEO_MAX_PLANES];
+  gboolean h_cosited;
+  gint *line_in;
+  gpointer *src_lines;
+
+  width = task->out_width;
+  dps = GST_VIDEO_FORMAT_INFO_PSTRIDE (dfinfo, GST_VIDEO_COMP_U);
+  cw = GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (dfinfo, GST_VIDEO_COMP_U, width);
+  h_cosited = (task->dest->info.chroma_site &
+      GST_VIDEO_CHROMA_SITE_H_COSITED) != 0;
+
+  s = FRAME_GET_LINE (task->src, task->in_y);
+  s += task->in_x * 4;
+  sstride = FRAME_GET_STRIDE (task->src);
+
+  line_in = g_newa (gint, task->n_cache_lines + 1);
+  src_lines = g_newa (gpointer, task->n_cache_lines + 1);
+  fused_cache_init (&cache, task, 0, 0, s, sstride, width, line_in,
+      src_lines);
+
+  a1 = FUSED_LINE (task, 2);
+  a2 = FUSED_LINE (task, 3);
+
+  for (y = task->height_0; y < task->height_1; y += 2) {
+    l2 = MIN (y + 1, task->out_height - 1);
+
+    fused_scale_line (&cache, y, FUSED_LINE (task, 0));
+    fused_scale_line (&cache, l2, FUSED_LINE (task, 1));
+
+    /* unpack to ARGB and convert to AYUV */
+    lines[0] = FUSED_LINE (task, 0);
+    sfinfo->unpack_func (sfinfo, GST_VIDEO_PACK_FLAG_NONE, a1, lines, stride,
+        0, 0, width);
+    lines[0] = FUSED_LINE (task, 1);
+    sfinfo->unpack_func (sfinfo, GST_VIDEO_PACK_FLAG_NONE, a2, lines, stride,
+        0, 0, width);
+    if (data->matrix_func) {
+      data->matrix_func (data, a1, width);
+      data->matrix_func (data, a2, width);
+    }
+
+    dy1 = FRAME_GET_Y_LINE (task->dest, y + task->out_y);
+    dy1 += task->out_x;
+    for (i = 0; i < width; i++)
+      dy1[i] = a1[i * 4 + 1];
+    if (l2 != y) {
+      dy2 = FRAME_GET_Y_LINE (task->dest, l2 + task->out_y);
+      dy2 += task->out_x;
+      for (i = 0; i < width; i++)
+        dy2[i] = a2[i * 4 + 1];
+    }
+
+    du = FRAME_GET_U_LINE (task->dest, (task->out_y >> 1) + (y >> 1));
+    du += (task->out_x >> 1) * dps;
+    dv = FRAME_GET_V_LINE (task->dest, (task->out_y >> 1) + (y >> 1));
+    dv += (task->out_x >> 1) * dps;
+    if (h_cosited) {
+      /* chroma sits on the even luma columns, filter [1 2 1] horizontally
+       * and average the line pair */
+      for (i = 0; i < cw; i++) {
+        i0 = MAX (i * 2 - 1, 0) * 4;
+        i1 = (i * 2) * 4;
+        i2 = MIN (i * 2 + 1, width - 1) * 4;
+        du[i * dps] = (a1[i0 + 2] + 2 * a1[i1 + 2] + a1[i2 + 2] +
+            a2[i0 + 2] + 2 * a2[i1 + 2] + a2[i2 + 2] + 4) >> 3;
+        dv[i * dps] = (a1[i0 + 3] + 2 * a1[i1 + 3] + a1[i2 + 3] +
+            a2[i0 + 3] + 2 * a2[i1 + 3] + a2[i2 + 3] + 4) >> 3;
+      }
+    } else {
+      /* average the chroma of each 2x2 block */
+      for (i = 0; i < cw; i++) {
+        i0 = (i * 2) * 4;
+        i1 = MIN (i * 2 + 1, width - 1) * 4;
+        du[i * dps] = (a1[i0 + 2] + a1[i1 + 2] + a2[i0 + 2] + a2[i1 + 2] + 2)
+            >> 2;
+        dv[i * dps] = (a1[i0 + 3] + a1[i1 + 3] + a2[i0 + 3] + a2[i1 + 3] + 2)
+            >> 2;
+      }
+    }
+  }
+}
+
+static void
+convert_scale_fused (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest, GstParallelizedTaskFunc func)
+{
+  FFusedScaleTask *tasks;
+  FFusedScaleTask **tasks_p;
+  gint i, j, n_threads, lines_per_thread;
+  guint n_cache_lines;
+
+  n_threads = convert->conversion_runner->n_threads;
+  tasks = g_newa (FFusedScaleTask, n_threads);
+  tasks_p = g_newa (FFusedScaleTask *, n_threads);
+
+  lines_per_thread =
+      GST_ROUND_UP_2 ((convert->out_height + n_threads - 1) / n_threads);
+  n_cache_lines = fused_cache_lines (convert);
+
+  for (i = 0; i < n_threads; i++) {
+    tasks[i].src = src;
+    tasks[i].dest = dest;
+
+    for (j = 0; j < 2; j++) {
+      tasks[i].h_scaler[j] =
+          convert->fh_scaler[j].scaler ? convert->
+          fh_scaler[j].scaler[i] : NULL;
+      tasks[i].v_scaler[j] =
+          convert->fv_scaler[j].scaler ? convert->
+          fv_scaler[j].scaler[i] : NULL;
+      tasks[i].format[j] = convert->fformat[j];
+    }
+    tasks[i].data = &convert->convert_matrix;
+    tasks[i].in_x = convert->in_x;
+    tasks[i].in_y = convert->in_y;
+    tasks[i].out_x = convert->out_x;
+    tasks[i].out_y = convert->out_y;
+    tasks[i].out_width = convert->out_width;
+    tasks[i].out_height = convert->out_height;
+    tasks[i].lines = (guint8 *) convert->tmpline[i];
+    tasks[i].lstride =
+        FUSED_LINE_STRIDE (MAX (convert->in_width, convert->out_width));
+    tasks[i].n_cache_lines = n_cache_lines;
+
+    tasks[i].height_0 = i * lines_per_thread;
+    tasks[i].height_1 = tasks[i].height_0 + lines_per_thread;
+    tasks[i].height_1 = MIN (convert->out_height, tasks[i].height_1);
+
+    tasks_p[i] = &tasks[i];
+  }
+
+  gst_parallelized_task_runner_run (convert->conversion_runner, func,
+      (gpointer) tasks_p);
+
+  convert_fill_border (convert, dest);
+}
+
+static void
+convert_scale_420 (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_scale_fused (convert, src, dest,
+      (GstParallelizedTaskFunc) convert_scale_420_task);
+}
+
+static void
+convert_scale_YUY2_I420 (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest)
+{
+  convert_scale_fused (convert, src, dest,
+      (GstParallelizedTaskFunc) convert_scale_YUY2_I420_task);
+}
+
+static void
+convert_scale_RGBA_NV12 (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest)
+{
+  convert_scale_fused (convert, src, dest,
+      (GstParallelizedTaskFunc) convert_scale_RGBA_NV12_task);
+}
+
 /* Fast paths */
 
 typedef struct
@@ -6208,6 +6881,10 @@ typedef struct
   gint width_align, height_align;
   void (*convert) (GstVideoConverter * convert, const GstVideoFrame * src,
       GstVideoFrame * dest);
+  /* custom setup of the scalers, setup_scale() when NULL */
+  gboolean (*setup) (GstVideoConverter * convert);
+  /* fused scale and convert, only used when the size changes */
+  gboolean fused;
 } VideoTransform;
 
 static const VideoTransform transforms[] = {
@@ -6622,6 +7299,95 @@ static const VideoTransform transforms[] = {
       TRUE, TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_planes},
   {GST_VIDEO_FORMAT_GRAY16_BE, GST_VIDEO_FORMAT_GRAY16_BE, TRUE, FALSE, FALSE,
       TRUE, TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_planes},
+
+  /* scale and convert in one pass */
+  {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_NV12, FALSE, FALSE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_420, setup_scale_fused,
+      TRUE},
+  {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_NV21, FALSE, FALSE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_420, setup_scale_fused,
+      TRUE},
+  {GST_VIDEO_FORMAT_YV12, GST_VIDEO_FORMAT_NV12, FALSE, FALSE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_420, setup_scale_fused,
+      TRUE},
+  {GST_VIDEO_FORMAT_YV12, GST_VIDEO_FORMAT_NV21, FALSE, FALSE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_420, setup_scale_fused,
+      TRUE},
+
+  {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_I420, FALSE, FALSE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_420, setup_scale_fused,
+      TRUE},
+  {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_YV12, FALSE, FALSE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_420, setup_scale_fused,
+      TRUE},
+  {GST_VIDEO_FORMAT_NV21, GST_VIDEO_FORMAT_I420, FALSE, FALSE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_420, setup_scale_fused,
+      TRUE},
+  {GST_VIDEO_FORMAT_NV21, GST_VIDEO_FORMAT_YV12, FALSE, FALSE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_420, setup_scale_fused,
+      TRUE},
+
+  {GST_VIDEO_FORMAT_YUY2, GST_VIDEO_FORMAT_I420, FALSE, FALSE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_YUY2_I420,
+      setup_scale_fused, TRUE},
+  {GST_VIDEO_FORMAT_YUY2, GST_VIDEO_FORMAT_YV12, FALSE, FALSE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_YUY2_I420,
+      setup_scale_fused, TRUE},
+  {GST_VIDEO_FORMAT_UYVY, GST_VIDEO_FORMAT_I420, FALSE, FALSE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_YUY2_I420,
+      setup_scale_fused, TRUE},
+  {GST_VIDEO_FORMAT_UYVY, GST_VIDEO_FORMAT_YV12, FALSE, FALSE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_YUY2_I420,
+      setup_scale_fused, TRUE},
+
+  {GST_VIDEO_FORMAT_RGBA, GST_VIDEO_FORMAT_NV12, FALSE, TRUE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_RGBA_NV12,
+      setup_scale_fused, TRUE},
+  {GST_VIDEO_FORMAT_RGBA, GST_VIDEO_FORMAT_NV21, FALSE, TRUE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_RGBA_NV12,
+      setup_scale_fused, TRUE},
+  {GST_VIDEO_FORMAT_BGRA, GST_VIDEO_FORMAT_NV12, FALSE, TRUE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_RGBA_NV12,
+      setup_scale_fused, TRUE},
+  {GST_VIDEO_FORMAT_BGRA, GST_VIDEO_FORMAT_NV21, FALSE, TRUE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_RGBA_NV12,
+      setup_scale_fused, TRUE},
+  {GST_VIDEO_FORMAT_ARGB, GST_VIDEO_FORMAT_NV12, FALSE, TRUE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_RGBA_NV12,
+      setup_scale_fused, TRUE},
+  {GST_VIDEO_FORMAT_ARGB, GST_VIDEO_FORMAT_NV21, FALSE, TRUE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_RGBA_NV12,
+      setup_scale_fused, TRUE},
+  {GST_VIDEO_FORMAT_ABGR, GST_VIDEO_FORMAT_NV12, FALSE, TRUE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_RGBA_NV12,
+      setup_scale_fused, TRUE},
+  {GST_VIDEO_FORMAT_ABGR, GST_VIDEO_FORMAT_NV21, FALSE, TRUE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_RGBA_NV12,
+      setup_scale_fused, TRUE},
+  {GST_VIDEO_FORMAT_RGBx, GST_VIDEO_FORMAT_NV12, FALSE, TRUE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_RGBA_NV12,
+      setup_scale_fused, TRUE},
+  {GST_VIDEO_FORMAT_RGBx, GST_VIDEO_FORMAT_NV21, FALSE, TRUE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_RGBA_NV12,
+      setup_scale_fused, TRUE},
+  {GST_VIDEO_FORMAT_BGRx, GST_VIDEO_FORMAT_NV12, FALSE, TRUE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_RGBA_NV12,
+      setup_scale_fused, TRUE},
+  {GST_VIDEO_FORMAT_BGRx, GST_VIDEO_FORMAT_NV21, FALSE, TRUE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_RGBA_NV12,
+      setup_scale_fused, TRUE},
+  {GST_VIDEO_FORMAT_xRGB, GST_VIDEO_FORMAT_NV12, FALSE, TRUE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_RGBA_NV12,
+      setup_scale_fused, TRUE},
+  {GST_VIDEO_FORMAT_xRGB, GST_VIDEO_FORMAT_NV21, FALSE, TRUE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_RGBA_NV12,
+      setup_scale_fused, TRUE},
+  {GST_VIDEO_FORMAT_xBGR, GST_VIDEO_FORMAT_NV12, FALSE, TRUE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_RGBA_NV12,
+      setup_scale_fused, TRUE},
+  {GST_VIDEO_FORMAT_xBGR, GST_VIDEO_FORMAT_NV21, FALSE, TRUE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_RGBA_NV12,
+      setup_scale_fused, TRUE},
 };
 
 static gboolean
@@ -6631,6 +7397,7 @@ video_converter_lookup_fastpath (GstVideoConverter * convert)
   GstVideoFormat in_format, out_format;
   GstVideoTransferFunction in_transf, out_transf;
   gboolean interlaced, same_matrix, same_primaries, same_size, crop, border;
+  gboolean scaling;
   gboolean need_copy, need_set, need_mult;
   gint width, height;
 
@@ -6645,6 +7412,8 @@ video_converter_lookup_fastpath (GstVideoConverter * convert)
   out_transf = convert->out_info.colorimetry.transfer;
 
   same_size = (width == convert->out_width && height == convert->out_height);
+  scaling = convert->in_width != convert->out_width
+      || convert->in_height != convert->out_height;
 
   /* fastpaths don't do gamma */
   if (CHECK_GAMMA_REMAP (convert) && (!same_size || in_transf != out_transf))
@@ -6694,6 +7463,8 @@ video_converter_lookup_fastpath (GstVideoConverter * convert)
         (transforms[i].keeps_interlaced || !interlaced) &&
         (transforms[i].needs_color_matrix || (same_matrix && same_primaries))
         && (!transforms[i].keeps_size || same_size)
+        && (!transforms[i].fused || (scaling
+                && fused_chroma_site_supported (convert)))
         && (transforms[i].width_align & width) == 0
         && (transforms[i].height_align & height) == 0
         && (transforms[i].do_crop || !crop)
@@ -6713,9 +7484,13 @@ video_converter_lookup_fastpath (GstVideoConverter * convert)
       for (j = 0; j < convert->conversion_runner->n_threads; j++)
         convert->tmpline[j] = g_malloc0 (sizeof (guint16) * (width + 8) * 4);
 
-      if (!transforms[i].keeps_size)
+      if (transforms[i].setup) {
+        if (!transforms[i].setup (convert))
+          return FALSE;
+      } else if (!transforms[i].keeps_size) {
         if (!setup_scale (convert))
           return FALSE;
+      }
       if (border)
         setup_borderline (convert);
       return TRUE;
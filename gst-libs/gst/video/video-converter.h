@@ -269,10 +269,26 @@ typedef enum {
  * GST_VIDEO_CONVERTER_OPT_THREADS:
  *
  * #G_TYPE_UINT, maximum number of threads to use. Default 1, 0 for the number
- * of cores.
+ * of cores. The threads are taken from a process-wide pool that is shared
+ * by all converters, this value only limits how many of them a single
+ * conversion uses concurrently.
  */
 #define GST_VIDEO_CONVERTER_OPT_THREADS   "GstVideoConverter.threads"
 
+/**
+ * GST_VIDEO_CONVERTER_OPT_TILE_WIDTH:
+ *
+ * #G_TYPE_UINT, when not 0, run the generic conversion over blocks of this
+ * many output pixels wide instead of over complete lines. Each thread then
+ * processes its lines one block column at a time, which keeps the
+ * intermediate lines in the CPU caches for large frames. The width is rounded
+ * up to a multiple of 16. Formats without a fixed pixel stride and error
+ * diffusion dithering fall back to line based conversion. Default 0.
+ *
+ * Since: 1.14
+ */
+#define GST_VIDEO_CONVERTER_OPT_TILE_WIDTH   "GstVideoConverter.tile-width"
+
 typedef struct _GstVideoConverter GstVideoConverter;
 
 GST_EXPORT
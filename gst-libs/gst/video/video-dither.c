@@ -252,9 +252,10 @@ dither_ordered_u8 (GstVideoDither * dither, gpointer pixels, guint x, guint y,
     guint width)
 {
   guint8 *p = pixels;
-  guint8 *c = (guint8 *) dither->errors + ((y & 15) * width + (x & 15)) * 4;
+  guint8 *c = (guint8 *) dither->errors +
+      ((y & 15) * dither->width + (x & 15)) * 4;
 
-  video_orc_dither_ordered_u8 (p, c, width * 4);
+  video_orc_dither_ordered_u8 (p + (x * 4), c, width * 4);
 }
 
 static void
@@ -262,9 +263,10 @@ dither_ordered_u8_mask (GstVideoDither * dither, gpointer pixels, guint x,
     guint y, guint width)
 {
   guint8 *p = pixels;
-  guint16 *c = (guint16 *) dither->errors + ((y & 15) * width + (x & 15)) * 4;
+  guint16 *c = (guint16 *) dither->errors +
+      ((y & 15) * dither->width + (x & 15)) * 4;
 
-  video_orc_dither_ordered_4u8_mask (p, c, dither->orc_mask64, width);
+  video_orc_dither_ordered_4u8_mask (p + (x * 4), c, dither->orc_mask64, width);
 }
 
 static void
@@ -272,9 +274,10 @@ dither_ordered_u16_mask (GstVideoDither * dither, gpointer pixels, guint x,
     guint y, guint width)
 {
   guint16 *p = pixels;
-  guint16 *c = (guint16 *) dither->errors + ((y & 15) * width + (x & 15)) * 4;
+  guint16 *c = (guint16 *) dither->errors +
+      ((y & 15) * dither->width + (x & 15)) * 4;
 
-  video_orc_dither_ordered_4u16_mask (p, c, dither->orc_mask64, width);
+  video_orc_dither_ordered_4u16_mask (p + (x * 4), c, dither->orc_mask64, width);
 }
 
 static void
@@ -0,0 +1,122 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_VIDEO_SCALER_MACROS_H__
+#define __GST_VIDEO_SCALER_MACROS_H__
+
+#include <glib.h>
+
+/* The SIMD kernels must produce exactly the same output as the ORC
+ * functions they replace. The u8 kernels accumulate in 16 bits with
+ * wrap-around, the u16 kernels in 32 bits, so that the order in which the
+ * taps are summed does not matter. */
+#define SCALE_SIMD_U8_SHIFT     6
+#define SCALE_SIMD_U8_ROUND     32
+#define SCALE_SIMD_U16_SHIFT    12
+#define SCALE_SIMD_U16_ROUND    4095
+
+#define DECL_SCALE_H_FUNC(type,arch)                                    \
+void                                                                    \
+video_scale_h_ntap_ ##type## _ ##arch (type * d, const type * pixels,   \
+    const gint16 * taps, gint tstride, gint count, gint n_taps)
+
+#define DECL_SCALE_V_FUNC(type,arch)                                    \
+void                                                                    \
+video_scale_v_ntap_ ##type## _ ##arch (type * d, gpointer srcs[],       \
+    gint src_inc, const gint16 * taps, gint count, gint n_taps)
+
+static inline guint8
+scale_simd_clamp_u8 (guint16 acc)
+{
+  gint16 v = (gint16) (guint16) (acc + SCALE_SIMD_U8_ROUND);
+
+  v >>= SCALE_SIMD_U8_SHIFT;
+  return CLAMP (v, 0, 255);
+}
+
+static inline guint16
+scale_simd_clamp_u16 (guint32 acc)
+{
+  gint32 v = (gint32) (guint32) (acc + SCALE_SIMD_U16_ROUND);
+
+  v >>= SCALE_SIMD_U16_SHIFT;
+  return CLAMP (v, 0, 65535);
+}
+
+/* scalar versions for the pixels that don't fill a complete vector */
+static inline void
+scale_simd_h_tail_u8 (guint8 * d, const guint8 * pixels,
+    const gint16 * taps, gint tstride, gint count, gint n_taps, gint i)
+{
+  gint j;
+
+  for (; i < count; i++) {
+    guint16 acc = 0;
+
+    for (j = 0; j < n_taps; j++)
+      acc += (guint16) (pixels[j * count + i] * taps[j * tstride + i]);
+    d[i] = scale_simd_clamp_u8 (acc);
+  }
+}
+
+static inline void
+scale_simd_h_tail_u16 (guint16 * d, const guint16 * pixels,
+    const gint16 * taps, gint tstride, gint count, gint n_taps, gint i)
+{
+  gint j;
+
+  for (; i < count; i++) {
+    guint32 acc = 0;
+
+    for (j = 0; j < n_taps; j++)
+      acc += (guint32) pixels[j * count + i] * (guint32) taps[j * tstride + i];
+    d[i] = scale_simd_clamp_u16 (acc);
+  }
+}
+
+static inline void
+scale_simd_v_tail_u8 (guint8 * d, gpointer srcs[], gint src_inc,
+    const gint16 * taps, gint count, gint n_taps, gint i)
+{
+  gint j;
+
+  for (; i < count; i++) {
+    guint16 acc = 0;
+
+    for (j = 0; j < n_taps; j++)
+      acc += (guint16) (((guint8 *) srcs[j * src_inc])[i] * taps[j]);
+    d[i] = scale_simd_clamp_u8 (acc);
+  }
+}
+
+static inline void
+scale_simd_v_tail_u16 (guint16 * d, gpointer srcs[], gint src_inc,
+    const gint16 * taps, gint count, gint n_taps, gint i)
+{
+  gint j;
+
+  for (; i < count; i++) {
+    guint32 acc = 0;
+
+    for (j = 0; j < n_taps; j++)
+      acc += (guint32) ((guint16 *) srcs[j * src_inc])[i] * (guint32) taps[j];
+    d[i] = scale_simd_clamp_u16 (acc);
+  }
+}
+
+#endif /* __GST_VIDEO_SCALER_MACROS_H__ */
@@ -0,0 +1,153 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "video-scaler-x86-avx2.h"
+
+#if defined (HAVE_IMMINTRIN_H) && defined (__AVX2__)
+
+#include <immintrin.h>
+
+/* packus works per 128 bits lane, put the 64 bits halves back in order */
+#define PACK_U8(a,b)  _mm256_permute4x64_epi64 (_mm256_packus_epi16 (a, b), 0xd8)
+#define PACK_U16(a,b) _mm256_permute4x64_epi64 (_mm256_packus_epi32 (a, b), 0xd8)
+
+static inline __m256i
+scale_u8 (__m256i acc)
+{
+  acc = _mm256_add_epi16 (acc, _mm256_set1_epi16 (SCALE_SIMD_U8_ROUND));
+  return _mm256_srai_epi16 (acc, SCALE_SIMD_U8_SHIFT);
+}
+
+static inline __m256i
+scale_u16 (__m256i acc)
+{
+  acc = _mm256_add_epi32 (acc, _mm256_set1_epi32 (SCALE_SIMD_U16_ROUND));
+  return _mm256_srai_epi32 (acc, SCALE_SIMD_U16_SHIFT);
+}
+
+static inline __m256i
+load_u8 (const guint8 * p)
+{
+  return _mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i *) p));
+}
+
+static inline __m256i
+load_u16 (const guint16 * p)
+{
+  return _mm256_cvtepu16_epi32 (_mm_loadu_si128 ((const __m128i *) p));
+}
+
+static inline __m256i
+load_taps_u16 (const gint16 * t)
+{
+  return _mm256_cvtepi16_epi32 (_mm_loadu_si128 ((const __m128i *) t));
+}
+
+DECL_SCALE_H_FUNC (guint8, avx2)
+{
+  gint i, j;
+
+  for (i = 0; i + 32 <= count; i += 32) {
+    __m256i acc0 = _mm256_setzero_si256 ();
+    __m256i acc1 = _mm256_setzero_si256 ();
+
+    for (j = 0; j < n_taps; j++) {
+      const guint8 *p = pixels + j * count + i;
+      const gint16 *t = taps + j * tstride + i;
+
+      acc0 = _mm256_add_epi16 (acc0, _mm256_mullo_epi16 (load_u8 (p),
+              _mm256_loadu_si256 ((const __m256i *) t)));
+      acc1 = _mm256_add_epi16 (acc1, _mm256_mullo_epi16 (load_u8 (p + 16),
+              _mm256_loadu_si256 ((const __m256i *) (t + 16))));
+    }
+    _mm256_storeu_si256 ((__m256i *) (d + i),
+        PACK_U8 (scale_u8 (acc0), scale_u8 (acc1)));
+  }
+  scale_simd_h_tail_u8 (d, pixels, taps, tstride, count, n_taps, i);
+}
+
+DECL_SCALE_H_FUNC (guint16, avx2)
+{
+  gint i, j;
+
+  for (i = 0; i + 16 <= count; i += 16) {
+    __m256i acc0 = _mm256_setzero_si256 ();
+    __m256i acc1 = _mm256_setzero_si256 ();
+
+    for (j = 0; j < n_taps; j++) {
+      const guint16 *p = pixels + j * count + i;
+      const gint16 *t = taps + j * tstride + i;
+
+      acc0 = _mm256_add_epi32 (acc0, _mm256_mullo_epi32 (load_u16 (p),
+              load_taps_u16 (t)));
+      acc1 = _mm256_add_epi32 (acc1, _mm256_mullo_epi32 (load_u16 (p + 8),
+              load_taps_u16 (t + 8)));
+    }
+    _mm256_storeu_si256 ((__m256i *) (d + i),
+        PACK_U16 (scale_u16 (acc0), scale_u16 (acc1)));
+  }
+  scale_simd_h_tail_u16 (d, pixels, taps, tstride, count, n_taps, i);
+}
+
+DECL_SCALE_V_FUNC (guint8, avx2)
+{
+  gint i, j;
+
+  for (i = 0; i + 32 <= count; i += 32) {
+    __m256i acc0 = _mm256_setzero_si256 ();
+    __m256i acc1 = _mm256_setzero_si256 ();
+
+    for (j = 0; j < n_taps; j++) {
+      const guint8 *p = (const guint8 *) srcs[j * src_inc] + i;
+      __m256i t = _mm256_set1_epi16 (taps[j]);
+
+      acc0 = _mm256_add_epi16 (acc0, _mm256_mullo_epi16 (load_u8 (p), t));
+      acc1 = _mm256_add_epi16 (acc1, _mm256_mullo_epi16 (load_u8 (p + 16), t));
+    }
+    _mm256_storeu_si256 ((__m256i *) (d + i),
+        PACK_U8 (scale_u8 (acc0), scale_u8 (acc1)));
+  }
+  scale_simd_v_tail_u8 (d, srcs, src_inc, taps, count, n_taps, i);
+}
+
+DECL_SCALE_V_FUNC (guint16, avx2)
+{
+  gint i, j;
+
+  for (i = 0; i + 16 <= count; i += 16) {
+    __m256i acc0 = _mm256_setzero_si256 ();
+    __m256i acc1 = _mm256_setzero_si256 ();
+
+    for (j = 0; j < n_taps; j++) {
+      const guint16 *p = (const guint16 *) srcs[j * src_inc] + i;
+      __m256i t = _mm256_set1_epi32 (taps[j]);
+
+      acc0 = _mm256_add_epi32 (acc0, _mm256_mullo_epi32 (load_u16 (p), t));
+      acc1 = _mm256_add_epi32 (acc1, _mm256_mullo_epi32 (load_u16 (p + 8), t));
+    }
+    _mm256_storeu_si256 ((__m256i *) (d + i),
+        PACK_U16 (scale_u16 (acc0), scale_u16 (acc1)));
+  }
+  scale_simd_v_tail_u16 (d, srcs, src_inc, taps, count, n_taps, i);
+}
+
+#endif
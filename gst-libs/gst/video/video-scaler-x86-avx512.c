@@ -0,0 +1,142 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "video-scaler-x86-avx512.h"
+
+#if defined (HAVE_IMMINTRIN_H) && defined (__AVX512F__) && \
+    defined (__AVX512BW__)
+
+#include <immintrin.h>
+
+/* the unsigned saturating narrowing needs the negative values clipped
+ * first to behave like the signed to unsigned saturation of ORC */
+static inline __m256i
+scale_u8 (__m512i acc)
+{
+  acc = _mm512_add_epi16 (acc, _mm512_set1_epi16 (SCALE_SIMD_U8_ROUND));
+  acc = _mm512_srai_epi16 (acc, SCALE_SIMD_U8_SHIFT);
+  acc = _mm512_max_epi16 (acc, _mm512_setzero_si512 ());
+  return _mm512_cvtusepi16_epi8 (acc);
+}
+
+static inline __m256i
+scale_u16 (__m512i acc)
+{
+  acc = _mm512_add_epi32 (acc, _mm512_set1_epi32 (SCALE_SIMD_U16_ROUND));
+  acc = _mm512_srai_epi32 (acc, SCALE_SIMD_U16_SHIFT);
+  acc = _mm512_max_epi32 (acc, _mm512_setzero_si512 ());
+  return _mm512_cvtusepi32_epi16 (acc);
+}
+
+static inline __m512i
+load_u8 (const guint8 * p)
+{
+  return _mm512_cvtepu8_epi16 (_mm256_loadu_si256 ((const __m256i *) p));
+}
+
+static inline __m512i
+load_u16 (const guint16 * p)
+{
+  return _mm512_cvtepu16_epi32 (_mm256_loadu_si256 ((const __m256i *) p));
+}
+
+static inline __m512i
+load_taps_u16 (const gint16 * t)
+{
+  return _mm512_cvtepi16_epi32 (_mm256_loadu_si256 ((const __m256i *) t));
+}
+
+DECL_SCALE_H_FUNC (guint8, avx512)
+{
+  gint i, j;
+
+  for (i = 0; i + 32 <= count; i += 32) {
+    __m512i acc = _mm512_setzero_si512 ();
+
+    for (j = 0; j < n_taps; j++) {
+      const guint8 *p = pixels + j * count + i;
+      const gint16 *t = taps + j * tstride + i;
+
+      acc = _mm512_add_epi16 (acc, _mm512_mullo_epi16 (load_u8 (p),
+              _mm512_loadu_si512 (t)));
+    }
+    _mm256_storeu_si256 ((__m256i *) (d + i), scale_u8 (acc));
+  }
+  scale_simd_h_tail_u8 (d, pixels, taps, tstride, count, n_taps, i);
+}
+
+DECL_SCALE_H_FUNC (guint16, avx512)
+{
+  gint i, j;
+
+  for (i = 0; i + 16 <= count; i += 16) {
+    __m512i acc = _mm512_setzero_si512 ();
+
+    for (j = 0; j < n_taps; j++) {
+      const guint16 *p = pixels + j * count + i;
+      const gint16 *t = taps + j * tstride + i;
+
+      acc = _mm512_add_epi32 (acc, _mm512_mullo_epi32 (load_u16 (p),
+              load_taps_u16 (t)));
+    }
+    _mm256_storeu_si256 ((__m256i *) (d + i), scale_u16 (acc));
+  }
+  scale_simd_h_tail_u16 (d, pixels, taps, tstride, count, n_taps, i);
+}
+
+DECL_SCALE_V_FUNC (guint8, avx512)
+{
+  gint i, j;
+
+  for (i = 0; i + 32 <= count; i += 32) {
+    __m512i acc = _mm512_setzero_si512 ();
+
+    for (j = 0; j < n_taps; j++) {
+      const guint8 *p = (const guint8 *) srcs[j * src_inc] + i;
+
+      acc = _mm512_add_epi16 (acc, _mm512_mullo_epi16 (load_u8 (p),
+              _mm512_set1_epi16 (taps[j])));
+    }
+    _mm256_storeu_si256 ((__m256i *) (d + i), scale_u8 (acc));
+  }
+  scale_simd_v_tail_u8 (d, srcs, src_inc, taps, count, n_taps, i);
+}
+
+DECL_SCALE_V_FUNC (guint16, avx512)
+{
+  gint i, j;
+
+  for (i = 0; i + 16 <= count; i += 16) {
+    __m512i acc = _mm512_setzero_si512 ();
+
+    for (j = 0; j < n_taps; j++) {
+      const guint16 *p = (const guint16 *) srcs[j * src_inc] + i;
+
+      acc = _mm512_add_epi32 (acc, _mm512_mullo_epi32 (load_u16 (p),
+              _mm512_set1_epi32 (taps[j])));
+    }
+    _mm256_storeu_si256 ((__m256i *) (d + i), scale_u16 (acc));
+  }
+  scale_simd_v_tail_u16 (d, srcs, src_inc, taps, count, n_taps, i);
+}
+
+#endif
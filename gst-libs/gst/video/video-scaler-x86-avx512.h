@@ -0,0 +1,29 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef VIDEO_SCALER_X86_AVX512_H
+#define VIDEO_SCALER_X86_AVX512_H
+
+#include "video-scaler-macros.h"
+
+G_GNUC_INTERNAL DECL_SCALE_H_FUNC (guint8, avx512);
+G_GNUC_INTERNAL DECL_SCALE_H_FUNC (guint16, avx512);
+G_GNUC_INTERNAL DECL_SCALE_V_FUNC (guint8, avx512);
+G_GNUC_INTERNAL DECL_SCALE_V_FUNC (guint16, avx512);
+
+#endif /* VIDEO_SCALER_X86_AVX512_H */
@@ -0,0 +1,52 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "video-scaler-x86-avx2.h"
+#include "video-scaler-x86-avx512.h"
+
+static void
+video_scaler_check_x86 (void)
+{
+#if defined (__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 8))
+  __builtin_cpu_init ();
+
+#if defined (HAVE_IMMINTRIN_H) && HAVE_AVX2
+  if (__builtin_cpu_supports ("avx2")) {
+    GST_DEBUG ("enable AVX2 optimisations");
+    video_scale_h_ntap_u8_simd = video_scale_h_ntap_guint8_avx2;
+    video_scale_h_ntap_u16_simd = video_scale_h_ntap_guint16_avx2;
+    video_scale_v_ntap_u8_simd = video_scale_v_ntap_guint8_avx2;
+    video_scale_v_ntap_u16_simd = video_scale_v_ntap_guint16_avx2;
+  }
+#else
+  GST_DEBUG ("AVX2 optimisations not enabled");
+#endif
+
+#if defined (HAVE_IMMINTRIN_H) && HAVE_AVX512
+  if (__builtin_cpu_supports ("avx512f") && __builtin_cpu_supports ("avx512bw")) {
+    GST_DEBUG ("enable AVX-512 optimisations");
+    video_scale_h_ntap_u8_simd = video_scale_h_ntap_guint8_avx512;
+    video_scale_h_ntap_u16_simd = video_scale_h_ntap_guint16_avx512;
+    video_scale_v_ntap_u8_simd = video_scale_v_ntap_guint8_avx512;
+    video_scale_v_ntap_u16_simd = video_scale_v_ntap_guint16_avx512;
+  }
+#else
+  GST_DEBUG ("AVX-512 optimisations not enabled");
+#endif
+#endif
+}
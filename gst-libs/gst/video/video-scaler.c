@@ -82,6 +82,23 @@ typedef void (*GstVideoScalerVFunc) (GstVideoScaler * scale,
     gpointer srcs[], gpointer dest, guint dest_offset, guint width,
     guint n_elems);
 
+/* SIMD kernels that compute all taps of a line in one pass, NULL when the
+ * CPU does not support any of them */
+static void (*video_scale_h_ntap_u8_simd) (guint8 * d, const guint8 * pixels,
+    const gint16 * taps, gint tstride, gint count, gint n_taps);
+static void (*video_scale_h_ntap_u16_simd) (guint16 * d,
+    const guint16 * pixels, const gint16 * taps, gint tstride, gint count,
+    gint n_taps);
+static void (*video_scale_v_ntap_u8_simd) (guint8 * d, gpointer srcs[],
+    gint src_inc, const gint16 * taps, gint count, gint n_taps);
+static void (*video_scale_v_ntap_u16_simd) (guint16 * d, gpointer srcs[],
+    gint src_inc, const gint16 * taps, gint count, gint n_taps);
+
+#if defined (__i386__) || defined (__x86_64__)
+#  define CHECK_X86
+#  include "video-scaler-x86.h"
+#endif
+
 struct _GstVideoScaler
 {
   GstVideoResamplerMethod method;
@@ -99,12 +116,42 @@ struct _GstVideoScaler
   guint32 *offset_n;
   /* for ORC */
   gint inc;
+  /* use the SIMD kernels */
+  gboolean simd;
 
   gint tmpwidth;
   gpointer tmpline1;
   gpointer tmpline2;
 };
 
+#define DEFAULT_OPT_SIMD TRUE
+
+static gboolean
+get_opt_bool (GstStructure * options, const gchar * opt, gboolean def)
+{
+  gboolean res;
+
+  if (!options || !gst_structure_get_boolean (options, opt, &res))
+    res = def;
+  return res;
+}
+
+#define GET_OPT_SIMD(o) get_opt_bool (o, GST_VIDEO_SCALER_OPT_SIMD, \
+    DEFAULT_OPT_SIMD)
+
+static void
+video_scaler_init (void)
+{
+  static gsize init_gonce = 0;
+
+  if (g_once_init_enter (&init_gonce)) {
+#ifdef CHECK_X86
+    video_scaler_check_x86 ();
+#endif
+    g_once_init_leave (&init_gonce, 1);
+  }
+}
+
 static void
 resampler_zip (GstVideoResampler * resampler, const GstVideoResampler * r1,
     const GstVideoResampler * r2)
@@ -215,12 +262,15 @@ gst_video_scaler_new (GstVideoResamplerMethod method, GstVideoScalerFlags flags,
   g_return_val_if_fail (in_size != 0, NULL);
   g_return_val_if_fail (out_size != 0, NULL);
 
+  video_scaler_init ();
+
   scale = g_slice_new0 (GstVideoScaler);
 
   GST_DEBUG ("%d %u  %u->%u", method, n_taps, in_size, out_size);
 
   scale->method = method;
   scale->flags = flags;
+  scale->simd = GET_OPT_SIMD (options);
 
   if (flags & GST_VIDEO_SCALER_FLAG_INTERLACED) {
     GstVideoResampler tresamp, bresamp;
@@ -598,7 +648,8 @@ video_scale_h_2tap_1u8 (GstVideoScaler * scale,
   d = (guint8 *) dest + dest_offset;
   s = (guint8 *) src;
 
-  video_orc_resample_h_2tap_1u8_lq (d, s, 0, scale->inc, width);
+  video_orc_resample_h_2tap_1u8_lq (d, s, dest_offset * scale->inc,
+      scale->inc, width);
 }
 
 static void
@@ -610,15 +661,31 @@ video_scale_h_2tap_4u8 (GstVideoScaler * scale,
   d = (guint32 *) dest + dest_offset;
   s = (guint32 *) src;
 
-  video_orc_resample_h_2tap_4u8_lq (d, s, 0, scale->inc, width);
+  video_orc_resample_h_2tap_4u8_lq (d, s, dest_offset * scale->inc,
+      scale->inc, width);
 }
 
+/* collect the input pixels for each of the taps of the @width output pixels
+ * starting from @dest_offset, the pixels of tap j end up at @width * j */
+#define GATHER_TAPS(type,pixels,src,offset_n,out_size,width,max_taps) \
+G_STMT_START {                                                        \
+  type *_p = (type *) (pixels);                                       \
+  type *_s = (type *) (src);                                          \
+  gint _i, _j;                                                        \
+                                                                      \
+  for (_j = 0; _j < (max_taps); _j++) {                               \
+    guint32 *_o = (offset_n) + _j * (out_size);                       \
+    for (_i = 0; _i < (width); _i++)                                  \
+      *_p++ = _s[_o[_i]];                                             \
+  }                                                                   \
+} G_STMT_END
+
 static void
 video_scale_h_ntap_u8 (GstVideoScaler * scale,
     gpointer src, gpointer dest, guint dest_offset, guint width, guint n_elems)
 {
   gint16 *taps;
-  gint i, max_taps, count;
+  gint i, j, max_taps, count, out_size, tstride;
   gpointer d;
   guint32 *offset_n;
   guint8 *pixels;
@@ -632,113 +699,102 @@ video_scale_h_ntap_u8 (GstVideoScaler * scale,
 #endif
 
   max_taps = scale->resampler.max_taps;
-  offset_n = scale->offset_n;
+  out_size = scale->resampler.out_size;
+  offset_n = scale->offset_n + dest_offset;
 
   pixels = (guint8 *) scale->tmpline1;
 
   /* prepare the arrays */
-  count = width * max_taps;
   switch (n_elems) {
     case 1:
-    {
-      guint8 *s = (guint8 *) src;
-
-      for (i = 0; i < count; i++)
-        pixels[i] = s[offset_n[i]];
-
+      GATHER_TAPS (guint8, pixels, src, offset_n, out_size, width, max_taps);
       d = (guint8 *) dest + dest_offset;
       break;
-    }
     case 2:
-    {
-      guint16 *p16 = (guint16 *) pixels;
-      guint16 *s = (guint16 *) src;
-
-      for (i = 0; i < count; i++)
-        p16[i] = s[offset_n[i]];
-
+      GATHER_TAPS (guint16, pixels, src, offset_n, out_size, width, max_taps);
       d = (guint16 *) dest + dest_offset;
       break;
-    }
     case 3:
     {
       guint8 *s = (guint8 *) src;
+      guint8 *p = pixels;
+
+      for (j = 0; j < max_taps; j++) {
+        guint32 *o = offset_n + j * out_size;
 
-      for (i = 0; i < count; i++) {
-        gint j = offset_n[i] * 3;
-        pixels[i * 3 + 0] = s[j + 0];
-        pixels[i * 3 + 1] = s[j + 1];
-        pixels[i * 3 + 2] = s[j + 2];
+        for (i = 0; i < width; i++) {
+          gint k = o[i] * 3;
+          p[0] = s[k + 0];
+          p[1] = s[k + 1];
+          p[2] = s[k + 2];
+          p += 3;
+        }
       }
       d = (guint8 *) dest + dest_offset * 3;
       break;
     }
     case 4:
-    {
-      guint32 *p32 = (guint32 *) pixels;
-      guint32 *s = (guint32 *) src;
-#if 0
-      video_orc_resample_h_near_u32 (p32, s, offset_n, count);
-#else
-      for (i = 0; i < count; i++)
-        p32[i] = s[offset_n[i]];
-#endif
+      GATHER_TAPS (guint32, pixels, src, offset_n, out_size, width, max_taps);
       d = (guint32 *) dest + dest_offset;
       break;
-    }
     default:
       return;
   }
   temp = (gint16 *) scale->tmpline2;
-  taps = scale->taps_s16_4;
+  /* the taps are stored per tap for all out_size pixels */
+  taps = scale->taps_s16_4 + dest_offset * n_elems;
+  tstride = out_size * n_elems;
   count = width * n_elems;
 
 #ifdef LQ
-  if (max_taps == 2) {
+  if (scale->simd && video_scale_h_ntap_u8_simd) {
+    video_scale_h_ntap_u8_simd (d, pixels, taps, tstride, count, max_taps);
+  } else if (max_taps == 2) {
     video_orc_resample_h_2tap_u8_lq (d, pixels, pixels + count, taps,
-        taps + count, count);
+        taps + tstride, count);
   } else {
     /* first pixels with first tap to temp */
     if (max_taps >= 3) {
       video_orc_resample_h_multaps3_u8_lq (temp, pixels, pixels + count,
-          pixels + count * 2, taps, taps + count, taps + count * 2, count);
+          pixels + count * 2, taps, taps + tstride, taps + tstride * 2, count);
       max_taps -= 3;
       pixels += count * 3;
-      taps += count * 3;
+      taps += tstride * 3;
     } else {
       gint first = max_taps % 3;
 
       video_orc_resample_h_multaps_u8_lq (temp, pixels, taps, count);
       video_orc_resample_h_muladdtaps_u8_lq (temp, 0, pixels + count, count,
-          taps + count, count * 2, count, first - 1);
+          taps + tstride, tstride * 2, count, first - 1);
       max_taps -= first;
       pixels += count * first;
-      taps += count * first;
+      taps += tstride * first;
     }
     while (max_taps > 3) {
       if (max_taps >= 6) {
         video_orc_resample_h_muladdtaps3_u8_lq (temp, pixels, pixels + count,
-            pixels + count * 2, taps, taps + count, taps + count * 2, count);
+            pixels + count * 2, taps, taps + tstride, taps + tstride * 2,
+            count);
         max_taps -= 3;
         pixels += count * 3;
-        taps += count * 3;
+        taps += tstride * 3;
       } else {
         video_orc_resample_h_muladdtaps_u8_lq (temp, 0, pixels, count,
-            taps, count * 2, count, max_taps - 3);
+            taps, tstride * 2, count, max_taps - 3);
         pixels += count * (max_taps - 3);
-        taps += count * (max_taps - 3);
+        taps += tstride * (max_taps - 3);
         max_taps = 3;
       }
     }
     if (max_taps == 3) {
       video_orc_resample_h_muladdscaletaps3_u8_lq (d, pixels, pixels + count,
-          pixels + count * 2, taps, taps + count, taps + count * 2, temp,
+          pixels + count * 2, taps, taps + tstride, taps + tstride * 2, temp,
           count);
     } else {
       if (max_taps) {
         /* add other pixels with other taps to t4 */
         video_orc_resample_h_muladdtaps_u8_lq (temp, 0, pixels, count,
-            taps, count * 2, count, max_taps);
+            taps, tstride * 2, count, max_taps);
       }
       /* scale and write final result */
       video_orc_resample_scaletaps_u8_lq (d, temp, count);
@@ -749,7 +805,7 @@ video_scale_h_ntap_u8 (GstVideoScaler * scale,
   video_orc_resample_h_multaps_u8 (temp, pixels, taps, count);
   /* add other pixels with other taps to t4 */
   video_orc_resample_h_muladdtaps_u8 (temp, 0, pixels + count, count,
-      taps + count, count * 2, count, max_taps - 1);
+      taps + tstride, tstride * 2, count, max_taps - 1);
   /* scale and write final result */
   video_orc_resample_scaletaps_u8 (d, temp, count);
 #endif
@@ -760,7 +816,7 @@ video_scale_h_ntap_u16 (GstVideoScaler * scale,
     gpointer src, gpointer dest, guint dest_offset, guint width, guint n_elems)
 {
   gint16 *taps;
-  gint i, max_taps, count;
+  gint max_taps, count, out_size, tstride;
   gpointer d;
   guint32 *offset_n;
   guint16 *pixels;
@@ -770,52 +826,41 @@ video_scale_h_ntap_u16 (GstVideoScaler * scale,
     make_s16_taps (scale, n_elems, SCALE_U16);
 
   max_taps = scale->resampler.max_taps;
-  offset_n = scale->offset_n;
+  out_size = scale->resampler.out_size;
+  offset_n = scale->offset_n + dest_offset;
 
   pixels = (guint16 *) scale->tmpline1;
   /* prepare the arrays FIXME, we can add this into ORC */
-  count = width * max_taps;
   switch (n_elems) {
     case 1:
-    {
-      guint16 *s = (guint16 *) src;
-
-      for (i = 0; i < count; i++)
-        pixels[i] = s[offset_n[i]];
-
+      GATHER_TAPS (guint16, pixels, src, offset_n, out_size, width, max_taps);
       d = (guint16 *) dest + dest_offset;
       break;
-    }
     case 4:
-    {
-      guint64 *p64 = (guint64 *) pixels;
-      guint64 *s = (guint64 *) src;
-#if 0
-      video_orc_resample_h_near_u32 (p32, s, offset_n, count);
-#else
-      for (i = 0; i < count; i++)
-        p64[i] = s[offset_n[i]];
-#endif
+      GATHER_TAPS (guint64, pixels, src, offset_n, out_size, width, max_taps);
       d = (guint64 *) dest + dest_offset;
       break;
-    }
     default:
       return;
   }
 
   temp = (gint32 *) scale->tmpline2;
-  taps = scale->taps_s16_4;
+  taps = scale->taps_s16_4 + dest_offset * n_elems;
+  tstride = out_size * n_elems;
   count = width * n_elems;
 
   if (max_taps == 2) {
+    /* rounds differently than the other functions */
     video_orc_resample_h_2tap_u16 (d, pixels, pixels + count, taps,
-        taps + count, count);
+        taps + tstride, count);
+  } else if (scale->simd && video_scale_h_ntap_u16_simd) {
+    video_scale_h_ntap_u16_simd (d, pixels, taps, tstride, count, max_taps);
   } else {
     /* first pixels with first tap to t4 */
     video_orc_resample_h_multaps_u16 (temp, pixels, taps, count);
     /* add other pixels with other taps to t4 */
     video_orc_resample_h_muladdtaps_u16 (temp, 0, pixels + count, count * 2,
-        taps + count, count * 2, count, max_taps - 1);
+        taps + tstride, tstride * 2, count, max_taps - 1);
     /* scale and write final result */
     video_orc_resample_scaletaps_u16 (d, temp, count);
   }
@@ -971,6 +1016,10 @@ video_scale_v_4tap_u8 (GstVideoScaler * scale,
   p4 = taps[3];
 
 #ifdef LQ
+  if (scale->simd && video_scale_v_ntap_u8_simd) {
+    video_scale_v_ntap_u8_simd (d, srcs, src_inc, taps, width * n_elems, 4);
+    return;
+  }
   video_orc_resample_v_4tap_u8_lq (d, s1, s2, s3, s4, p1, p2, p3, p4,
       width * n_elems);
 #else
@@ -1010,6 +1059,11 @@ video_scale_v_ntap_u8 (GstVideoScaler * scale,
   count = width * n_elems;
 
 #ifdef LQ
+  if (scale->simd && video_scale_v_ntap_u8_simd) {
+    video_scale_v_ntap_u8_simd (d, srcs, src_inc, taps, count, max_taps);
+    return;
+  }
+
   if (max_taps >= 4) {
     video_orc_resample_v_multaps4_u8_lq (temp, srcs[0], srcs[1 * src_inc],
         srcs[2 * src_inc], srcs[3 * src_inc], taps[0], taps[1], taps[2],
@@ -1093,6 +1147,11 @@ video_scale_v_ntap_u16 (GstVideoScaler * scale,
   temp = (gint32 *) scale->tmpline2;
   count = width * n_elems;
 
+  if (scale->simd && video_scale_v_ntap_u16_simd) {
+    video_scale_v_ntap_u16_simd (d, srcs, src_inc, taps, count, max_taps);
+    return;
+  }
+
   video_orc_resample_v_multaps_u16 (temp, srcs[0], taps[0], count);
   for (i = 1; i < max_taps; i++) {
     video_orc_resample_v_muladdtaps_u16 (temp, srcs[i * src_inc], taps[i],
@@ -1147,6 +1206,7 @@ gst_video_scaler_combine_packed_YUV (GstVideoScaler * y_scale,
 
   scale->method = y_scale->method;
   scale->flags = y_scale->flags;
+  scale->simd = y_scale->simd && uv_scale->simd;
   scale->merged = TRUE;
 
   resampler = &scale->resampler;
@@ -36,6 +36,17 @@ G_BEGIN_DECLS
  */
 #define GST_VIDEO_SCALER_OPT_DITHER_METHOD   "GstVideoScaler.dither-method"
 
+/**
+ * GST_VIDEO_SCALER_OPT_SIMD:
+ *
+ * #G_TYPE_BOOLEAN, use the AVX2 or AVX-512 scaling functions when the CPU
+ * supports them. The output is identical to the ORC functions.
+ * Default %TRUE.
+ *
+ * Since: 1.14
+ */
+#define GST_VIDEO_SCALER_OPT_SIMD            "GstVideoScaler.simd"
+
 /**
  * GstVideoScalerFlags:
  * @GST_VIDEO_SCALER_FLAG_NONE: no flags
@@ -742,7 +742,9 @@ gst_audio_convert_transform (GstBaseTransform * base, GstBuffer * inbuf,
   } else {
     inbuf_writable = TRUE;
   }
-  if (!gst_buffer_map (outbuf, &dstmap, GST_MAP_WRITE))
+  /* in-place conversions read the samples from the output buffer */
+  if (!gst_buffer_map (outbuf, &dstmap,
+          inbuf == outbuf ? GST_MAP_READWRITE : GST_MAP_WRITE))
     goto outmap_error;
 
   /* check in and outsize */
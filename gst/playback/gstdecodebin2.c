@@ -155,6 +155,7 @@ struct _GstDecodeBin
   guint64 max_size_time;
   gboolean post_stream_topology;
   guint64 connection_speed;
+  gboolean recycle_elements;    /* keep decoders/parsers for reuse */
 
   GstElement *typefind;         /* this holds the typefind object */
 
@@ -187,6 +188,9 @@ struct _GstDecodeBin
   GList *buffering_status;      /* element currently buffering messages */
   GMutex buffering_lock;
   GMutex buffering_post_lock;
+
+  GMutex recycle_lock;          /* Protects the recycled list */
+  GList *recycled;              /* elements of freed chains kept in READY */
 };
 
 struct _GstDecodeBinClass
@@ -243,6 +247,9 @@ enum
 #define AUTO_PLAY_SIZE_BUFFERS      5
 #define AUTO_PLAY_SIZE_TIME         0
 
+/* maximum number of elements kept around for recycling */
+#define MAX_RECYCLED_ELEMENTS       16
+
 #define DEFAULT_SUBTITLE_ENCODING NULL
 #define DEFAULT_USE_BUFFERING     FALSE
 #define DEFAULT_LOW_PERCENT       10
@@ -254,6 +261,7 @@ enum
 #define DEFAULT_POST_STREAM_TOPOLOGY FALSE
 #define DEFAULT_EXPOSE_ALL_STREAMS  TRUE
 #define DEFAULT_CONNECTION_SPEED    0
+#define DEFAULT_RECYCLE_ELEMENTS    FALSE
 
 /* Properties */
 enum
@@ -270,7 +278,8 @@ enum
   PROP_MAX_SIZE_TIME,
   PROP_POST_STREAM_TOPOLOGY,
   PROP_EXPOSE_ALL_STREAMS,
-  PROP_CONNECTION_SPEED
+  PROP_CONNECTION_SPEED,
+  PROP_RECYCLE_ELEMENTS
 };
 
 static GstBinClass *parent_class;
@@ -323,6 +332,7 @@ static gboolean check_upstream_seekable (GstDecodeBin * dbin, GstPad * pad);
 
 static GstCaps *get_pad_caps (GstPad * pad);
 static void unblock_pads (GstDecodeBin * dbin);
+static void clear_recycled_elements (GstDecodeBin * dbin);
 
 #define EXPOSE_LOCK(dbin) G_STMT_START {				\
     GST_LOG_OBJECT (dbin,						\
@@ -983,6 +993,21 @@ gst_decode_bin_class_init (GstDecodeBinClass * klass)
           0, G_MAXUINT64 / 1000, DEFAULT_CONNECTION_SPEED,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstDecodeBin2::recycle-elements
+   *
+   * Keep the decoders and parsers of streams that are torn down around in
+   * READY state and reuse them when the same element factory is selected
+   * again, for example when switching to the next URI of a playlist. This
+   * avoids reloading and reinitialising codecs for similar streams.
+   *
+   * Since: 1.14
+   */
+  g_object_class_install_property (gobject_klass, PROP_RECYCLE_ELEMENTS,
+      g_param_spec_boolean ("recycle-elements", "Recycle Elements",
+          "Reuse decoders and parsers of previous streams when possible",
+          DEFAULT_RECYCLE_ELEMENTS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
 
   klass->autoplug_continue =
@@ -1083,6 +1108,7 @@ gst_decode_bin_init (GstDecodeBin * decode_bin)
   g_mutex_init (&decode_bin->subtitle_lock);
   g_mutex_init (&decode_bin->buffering_lock);
   g_mutex_init (&decode_bin->buffering_post_lock);
+  g_mutex_init (&decode_bin->recycle_lock);
 
   decode_bin->encoding = g_strdup (DEFAULT_SUBTITLE_ENCODING);
   decode_bin->caps = gst_static_caps_get (&default_raw_caps);
@@ -1096,6 +1122,7 @@ gst_decode_bin_init (GstDecodeBin * decode_bin)
 
   decode_bin->expose_allstreams = DEFAULT_EXPOSE_ALL_STREAMS;
   decode_bin->connection_speed = DEFAULT_CONNECTION_SPEED;
+  decode_bin->recycle_elements = DEFAULT_RECYCLE_ELEMENTS;
 }
 
 static void
@@ -1123,6 +1150,8 @@ gst_decode_bin_dispose (GObject * object)
   g_list_free (decode_bin->subtitles);
   decode_bin->subtitles = NULL;
 
+  clear_recycled_elements (decode_bin);
+
   unblock_pads (decode_bin);
 
   G_OBJECT_CLASS (parent_class)->dispose (object);
@@ -1141,6 +1170,7 @@ gst_decode_bin_finalize (GObject * object)
   g_mutex_clear (&decode_bin->buffering_lock);
   g_mutex_clear (&decode_bin->buffering_post_lock);
   g_mutex_clear (&decode_bin->factories_lock);
+  g_mutex_clear (&decode_bin->recycle_lock);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -1285,6 +1315,11 @@ gst_decode_bin_set_property (GObject * object, guint prop_id,
       dbin->connection_speed = g_value_get_uint64 (value) * 1000;
       GST_OBJECT_UNLOCK (dbin);
       break;
+    case PROP_RECYCLE_ELEMENTS:
+      dbin->recycle_elements = g_value_get_boolean (value);
+      if (!dbin->recycle_elements)
+        clear_recycled_elements (dbin);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1337,6 +1372,9 @@ gst_decode_bin_get_property (GObject * object, guint prop_id,
       g_value_set_uint64 (value, dbin->connection_speed / 1000);
       GST_OBJECT_UNLOCK (dbin);
       break;
+    case PROP_RECYCLE_ELEMENTS:
+      g_value_set_boolean (value, dbin->recycle_elements);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1943,6 +1981,101 @@ remove_error_filter (GstDecodeBin * dbin, GstElement * element,
   GST_OBJECT_UNLOCK (dbin);
 }
 
+/* Element recycling
+ *
+ * With the recycle-elements property set, decoders and parsers of chains
+ * that are freed are brought back to READY and kept in a small pool instead
+ * of being shut down. Going to READY resets their stream state while they
+ * keep their opened resources, so when the same factory is selected again
+ * for a later stream the element is taken from the pool and only needs to
+ * renegotiate. Elements with dynamic pads (demuxers) are never recycled.
+ */
+static gboolean
+is_recyclable_element (GstElement * element)
+{
+  GstElementFactory *factory;
+  const gchar *klass;
+
+  factory = gst_element_get_factory (element);
+  if (factory == NULL)
+    return FALSE;
+
+  klass = gst_element_factory_get_metadata (factory,
+      GST_ELEMENT_METADATA_KLASS);
+  if (klass == NULL || (strstr (klass, "Decoder") == NULL
+          && strstr (klass, "Parser") == NULL))
+    return FALSE;
+
+  return !is_demuxer_element (element);
+}
+
+/* Puts @element in the pool if possible, the pool takes its own reference.
+ * Returns FALSE if the caller still has to shut the element down. */
+static gboolean
+recycle_element (GstDecodeBin * dbin, GstElement * element)
+{
+  gboolean pooled = FALSE;
+
+  if (!dbin->recycle_elements || !is_recyclable_element (element))
+    return FALSE;
+
+  if (gst_element_set_state (element,
+          GST_STATE_READY) == GST_STATE_CHANGE_FAILURE)
+    return FALSE;
+
+  g_mutex_lock (&dbin->recycle_lock);
+  if (g_list_length (dbin->recycled) < MAX_RECYCLED_ELEMENTS) {
+    dbin->recycled = g_list_prepend (dbin->recycled, gst_object_ref (element));
+    pooled = TRUE;
+  }
+  g_mutex_unlock (&dbin->recycle_lock);
+
+  if (pooled)
+    GST_DEBUG_OBJECT (dbin, "Recycled element %s", GST_ELEMENT_NAME (element));
+
+  return pooled;
+}
+
+/* Returns a recycled element created from @factory, in READY state, or
+ * NULL if there is none. The caller owns the returned reference. */
+static GstElement *
+take_recycled_element (GstDecodeBin * dbin, GstElementFactory * factory)
+{
+  GstElement *element = NULL;
+  GList *l;
+
+  g_mutex_lock (&dbin->recycle_lock);
+  for (l = dbin->recycled; l; l = l->next) {
+    if (gst_element_get_factory (l->data) == factory) {
+      element = l->data;
+      dbin->recycled = g_list_delete_link (dbin->recycled, l);
+      break;
+    }
+  }
+  g_mutex_unlock (&dbin->recycle_lock);
+
+  return element;
+}
+
+static void
+clear_recycled_elements (GstDecodeBin * dbin)
+{
+  GList *recycled;
+
+  g_mutex_lock (&dbin->recycle_lock);
+  recycled = dbin->recycled;
+  dbin->recycled = NULL;
+  g_mutex_unlock (&dbin->recycle_lock);
+
+  while (recycled) {
+    GstElement *element = recycled->data;
+
+    gst_element_set_state (element, GST_STATE_NULL);
+    gst_object_unref (element);
+    recycled = g_list_delete_link (recycled, recycled);
+  }
+}
+
 typedef struct
 {
   gboolean ret;
@@ -2116,6 +2249,7 @@ connect_pad (GstDecodeBin * dbin, GstElement * src, GstDecodePad * dpad,
     GList *to_expose = NULL;
     gboolean is_parser = FALSE;
     gboolean is_decoder = FALSE;
+    gboolean recycled = FALSE;
 
     /* Set dpad target to pad again, it might've been unset
      * below but we came back here because something failed
@@ -2243,8 +2377,12 @@ connect_pad (GstDecodeBin * dbin, GstElement * src, GstDecodePad * dpad,
     /* 2.0. Unlink pad */
     decode_pad_set_target (dpad, NULL);
 
-    /* 2.1. Try to create an element */
-    if ((element = gst_element_factory_create (factory, NULL)) == NULL) {
+    /* 2.1. Try to reuse a recycled element or create a new one */
+    if ((element = take_recycled_element (dbin, factory)) != NULL) {
+      GST_DEBUG_OBJECT (dbin, "Reusing recycled element %s",
+          GST_ELEMENT_NAME (element));
+      recycled = TRUE;
+    } else if ((element = gst_element_factory_create (factory, NULL)) == NULL) {
       GST_WARNING_OBJECT (dbin, "Could not create an element from %s",
           gst_plugin_feature_get_name (GST_PLUGIN_FEATURE (factory)));
       g_string_append_printf (error_details,
@@ -2267,10 +2405,15 @@ connect_pad (GstDecodeBin * dbin, GstElement * src, GstDecodePad * dpad,
       remove_error_filter (dbin, element, NULL);
       g_string_append_printf (error_details, "Couldn't add %s to the bin\n",
           GST_ELEMENT_NAME (element));
+      gst_element_set_state (element, GST_STATE_NULL);
       gst_object_unref (element);
       continue;
     }
 
+    /* the bin took its own reference, drop the one from the pool */
+    if (recycled)
+      gst_object_unref (element);
+
     /* Find its sink pad. */
     if (!(sinkpad = find_sink_pad (element))) {
       GST_WARNING_OBJECT (dbin, "Element %s doesn't have a sink pad",
@@ -2278,6 +2421,7 @@ connect_pad (GstDecodeBin * dbin, GstElement * src, GstDecodePad * dpad,
       remove_error_filter (dbin, element, NULL);
       g_string_append_printf (error_details,
           "Element %s doesn't have a sink pad", GST_ELEMENT_NAME (element));
+      gst_element_set_state (element, GST_STATE_NULL);
       gst_bin_remove (GST_BIN (dbin), element);
       continue;
     }
@@ -2291,6 +2435,7 @@ connect_pad (GstDecodeBin * dbin, GstElement * src, GstDecodePad * dpad,
       g_string_append_printf (error_details, "Link failed on pad %s:%s",
           GST_DEBUG_PAD_NAME (sinkpad));
       gst_object_unref (sinkpad);
+      gst_element_set_state (element, GST_STATE_NULL);
       gst_bin_remove (GST_BIN (dbin), element);
       continue;
     }
@@ -3457,7 +3602,8 @@ gst_decode_chain_free_internal (GstDecodeChain * chain, gboolean hide)
   while (set_to_null) {
     GstElement *element = set_to_null->data;
     set_to_null = g_list_delete_link (set_to_null, set_to_null);
-    gst_element_set_state (element, GST_STATE_NULL);
+    if (!recycle_element (chain->dbin, element))
+      gst_element_set_state (element, GST_STATE_NULL);
     gst_object_unref (element);
   }
 
@@ -5365,6 +5511,8 @@ gst_decode_bin_change_state (GstElement * element, GstStateChange transition)
       dbin->buffering_status = NULL;
       break;
     case GST_STATE_CHANGE_READY_TO_NULL:
+      clear_recycled_elements (dbin);
+      break;
     default:
       break;
   }
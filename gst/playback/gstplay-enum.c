@@ -69,6 +69,8 @@ gst_play_flags_get_type (void)
         "soft-colorbalance"},
     {C_FLAGS (GST_PLAY_FLAG_FORCE_FILTERS),
         "Force audio/video filter(s) to be applied", "force-filters"},
+    {C_FLAGS (GST_PLAY_FLAG_RECYCLE_ELEMENTS),
+        "Reuse decoders and parsers across URIs", "recycle-elements"},
     {0, NULL, NULL}
   };
   static volatile GType id = 0;
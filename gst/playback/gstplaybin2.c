@@ -5280,7 +5280,10 @@ activate_group (GstPlayBin * playbin, GstSourceGroup * group, GstState target)
       /* configure buffering parameters */
       "buffer-duration", playbin->buffer_duration,
       "buffer-size", playbin->buffer_size,
-      "ring-buffer-max-size", playbin->ring_buffer_max_size, NULL);
+      "ring-buffer-max-size", playbin->ring_buffer_max_size,
+      /* configure reuse of decoders over URI changes */
+      "recycle-elements", ((flags & GST_PLAY_FLAG_RECYCLE_ELEMENTS) != 0),
+      NULL);
 
   /* connect pads and other things */
   group->pad_added_id = g_signal_connect (uridecodebin, "pad-added",
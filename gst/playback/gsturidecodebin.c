@@ -116,6 +116,8 @@ struct _GstURIDecodeBin
   gboolean expose_allstreams;   /* Whether to expose unknow type streams or not */
 
   guint64 ring_buffer_max_size; /* 0 means disabled */
+
+  gboolean recycle_elements;    /* reuse decoders/parsers in decodebin */
 };
 
 struct _GstURIDecodeBinClass
@@ -182,6 +184,7 @@ enum
 #define DEFAULT_USE_BUFFERING       FALSE
 #define DEFAULT_EXPOSE_ALL_STREAMS  TRUE
 #define DEFAULT_RING_BUFFER_MAX_SIZE 0
+#define DEFAULT_RECYCLE_ELEMENTS    FALSE
 
 enum
 {
@@ -196,7 +199,8 @@ enum
   PROP_DOWNLOAD,
   PROP_USE_BUFFERING,
   PROP_EXPOSE_ALL_STREAMS,
-  PROP_RING_BUFFER_MAX_SIZE
+  PROP_RING_BUFFER_MAX_SIZE,
+  PROP_RECYCLE_ELEMENTS
 };
 
 static guint gst_uri_decode_bin_signals[LAST_SIGNAL] = { 0 };
@@ -496,6 +500,22 @@ gst_uri_decode_bin_class_init (GstURIDecodeBinClass * klass)
           0, G_MAXUINT, DEFAULT_RING_BUFFER_MAX_SIZE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstURIDecodeBin::recycle-elements
+   *
+   * Keep the decoders and parsers of the previous URI around and reuse them
+   * when the next URI needs the same elements, instead of creating and
+   * initialising new ones. The internal decodebin elements are kept over
+   * URI changes as long as the element does not go to the NULL state.
+   *
+   * Since: 1.14
+   */
+  g_object_class_install_property (gobject_class, PROP_RECYCLE_ELEMENTS,
+      g_param_spec_boolean ("recycle-elements", "Recycle Elements",
+          "Reuse decoders and parsers of previous URIs when possible",
+          DEFAULT_RECYCLE_ELEMENTS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstURIDecodeBin::unknown-type:
    * @bin: The uridecodebin.
@@ -731,6 +751,7 @@ gst_uri_decode_bin_init (GstURIDecodeBin * dec)
   dec->use_buffering = DEFAULT_USE_BUFFERING;
   dec->expose_allstreams = DEFAULT_EXPOSE_ALL_STREAMS;
   dec->ring_buffer_max_size = DEFAULT_RING_BUFFER_MAX_SIZE;
+  dec->recycle_elements = DEFAULT_RECYCLE_ELEMENTS;
 
   GST_OBJECT_FLAG_SET (dec, GST_ELEMENT_FLAG_SOURCE);
   gst_bin_set_suppressed_flags (GST_BIN (dec),
@@ -823,6 +844,9 @@ gst_uri_decode_bin_set_property (GObject * object, guint prop_id,
     case PROP_RING_BUFFER_MAX_SIZE:
       dec->ring_buffer_max_size = g_value_get_uint64 (value);
       break;
+    case PROP_RECYCLE_ELEMENTS:
+      dec->recycle_elements = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -883,6 +907,9 @@ gst_uri_decode_bin_get_property (GObject * object, guint prop_id,
     case PROP_RING_BUFFER_MAX_SIZE:
       g_value_set_uint64 (value, dec->ring_buffer_max_size);
       break;
+    case PROP_RECYCLE_ELEMENTS:
+      g_value_set_boolean (value, dec->recycle_elements);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1828,9 +1855,11 @@ make_decoder (GstURIDecodeBin * decoder)
   if (decoder->caps)
     g_object_set (decodebin, "caps", decoder->caps, NULL);
 
-  /* Propagate expose-all-streams and connection-speed properties */
+  /* Propagate expose-all-streams, connection-speed and recycle-elements
+   * properties */
   g_object_set (decodebin, "expose-all-streams", decoder->expose_allstreams,
-      "connection-speed", decoder->connection_speed / 1000, NULL);
+      "connection-speed", decoder->connection_speed / 1000,
+      "recycle-elements", decoder->recycle_elements, NULL);
 
   if (!decoder->is_stream || decoder->is_adaptive) {
     /* propagate the use-buffering property but only when we are not already
@@ -117,12 +117,26 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
 
 #ifdef HAVE_FIONREAD_IN_SYS_FILIO
 #include <sys/filio.h>
 #endif
 
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+
+#ifdef HAVE_SYS_SENDFILE_H
+#include <sys/sendfile.h>
+#include <signal.h>
+#include <pthread.h>
+#endif
+
+#include <gst/allocators/gstfdmemory.h>
+
 #include "gstmultifdsink.h"
 
 #define NOT_IMPLEMENTED 0
@@ -150,11 +164,30 @@ enum
 
 /* this is really arbitrarily chosen */
 #define DEFAULT_HANDLE_READ             TRUE
+#define DEFAULT_USE_EPOLL               FALSE
+#define DEFAULT_VECTORED                FALSE
+#define DEFAULT_SENDFILE                FALSE
+
+/* max number of memory chunks and bytes written with one vectored write */
+#define VECTORED_MAX_VECS               64
+#define VECTORED_MAX_BYTES              (256 * 1024)
+
+#ifdef MSG_NOSIGNAL
+#define FLAGS MSG_NOSIGNAL
+#else
+#define FLAGS 0
+#endif
+
+/* max number of epoll events collected per epoll_wait() call */
+#define EPOLL_MAX_EVENTS                256
 
 enum
 {
   PROP_0,
-  PROP_HANDLE_READ
+  PROP_HANDLE_READ,
+  PROP_USE_EPOLL,
+  PROP_VECTORED,
+  PROP_SENDFILE
 };
 
 static void gst_multi_fd_sink_stop_pre (GstMultiHandleSink * mhsink);
@@ -225,6 +258,55 @@ gst_multi_fd_sink_class_init (GstMultiFdSinkClass * klass)
           "Handle client reads and discard the data",
           DEFAULT_HANDLE_READ, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstMultiFdSink::use-epoll
+   *
+   * Use an edge-triggered epoll set for the client fds instead of polling
+   * all of them on every wakeup. Only the clients that have events or new
+   * data to send are visited, which keeps the CPU usage bounded with many
+   * thousands of clients. The client fds are then not part of the #GstPoll
+   * passed to the wait vmethod. Has no effect on platforms without epoll.
+   * The value is used when the element starts.
+   *
+   * Since: 1.14
+   */
+  g_object_class_install_property (gobject_class, PROP_USE_EPOLL,
+      g_param_spec_boolean ("use-epoll", "Use epoll",
+          "Use an edge-triggered epoll set to wait for the clients",
+          DEFAULT_USE_EPOLL, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstMultiFdSink::vectored
+   *
+   * Coalesce the queued buffers of a client into one writev() or sendmsg()
+   * call, up to 64 memory chunks or 256KB, instead of doing one write per
+   * buffer.
+   *
+   * Since: 1.14
+   */
+  g_object_class_install_property (gobject_class, PROP_VECTORED,
+      g_param_spec_boolean ("vectored", "Vectored",
+          "Write all queued buffers of a client with one vectored write",
+          DEFAULT_VECTORED, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstMultiFdSink::sendfile
+   *
+   * Send buffer memory that is backed by a file descriptor (see
+   * #GstFdAllocator) with sendfile() so that the data is not copied through
+   * userspace. Memory that can't be sent this way, like most dmabufs, is
+   * written normally. Note that the data is read from the fd, so memory
+   * that was mapped privately and modified must not be used. Has no effect
+   * on platforms without sendfile(). The value is used when the element
+   * starts.
+   *
+   * Since: 1.14
+   */
+  g_object_class_install_property (gobject_class, PROP_SENDFILE,
+      g_param_spec_boolean ("sendfile", "Sendfile",
+          "Send fd backed memory with sendfile()",
+          DEFAULT_SENDFILE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstMultiFdSink::add:
    * @gstmultifdsink: the multifdsink element to emit this signal on
@@ -302,8 +384,10 @@ gst_multi_fd_sink_class_init (GstMultiFdSinkClass * klass)
    *     epoch seconds) (last-activity-time), number of buffers
    *     dropped (buffers-dropped), the timestamp of the first buffer
    *     (first-buffer-ts) and of the last buffer (last-buffer-ts).
-   *     All times are expressed in nanoseconds (GstClockTime).  The
-   *     structure can be empty if the client was not found.
+   *     All times are expressed in nanoseconds (GstClockTime).  Since 1.14
+   *     it also contains the number of bytes that were sent with
+   *     sendfile() (bytes-sendfile). The structure can be empty if the
+   *     client was not found.
    */
   gst_multi_fd_sink_signals[SIGNAL_GET_STATS] =
       g_signal_new ("get-stats", G_TYPE_FROM_CLASS (klass),
@@ -412,6 +496,12 @@ gst_multi_fd_sink_init (GstMultiFdSink * this)
   mhsink->handle_hash = g_hash_table_new (g_direct_hash, g_direct_equal);
 
   this->handle_read = DEFAULT_HANDLE_READ;
+  this->use_epoll = DEFAULT_USE_EPOLL;
+  this->vectored = DEFAULT_VECTORED;
+  this->sendfile = DEFAULT_SENDFILE;
+  this->epoll_fd = -1;
+  this->wakeup_fd = -1;
+  g_queue_init (&this->pending);
 }
 
 /* methods to emit signals */
@@ -485,12 +575,118 @@ gst_multi_fd_sink_remove_flush (GstMultiFdSink * sink, int fd)
 static GstStructure *
 gst_multi_fd_sink_get_stats (GstMultiFdSink * sink, int fd)
 {
+  GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK_CAST (sink);
   GstMultiSinkHandle handle;
+  GstStructure *result;
+  GList *clink;
 
   handle.fd = fd;
-  return gst_multi_handle_sink_get_stats (GST_MULTI_HANDLE_SINK_CAST (sink),
-      handle);
+  result = gst_multi_handle_sink_get_stats (mhsink, handle);
+
+  CLIENTS_LOCK (mhsink);
+  clink = g_hash_table_lookup (mhsink->handle_hash,
+      gst_multi_fd_sink_handle_hash_key (handle));
+  if (clink != NULL) {
+    GstTCPClient *client = clink->data;
+
+    gst_structure_set (result, "bytes-sendfile", G_TYPE_UINT64,
+        client->bytes_sendfile, NULL);
+  }
+  CLIENTS_UNLOCK (mhsink);
+
+  return result;
+}
+
+static void
+gst_multi_fd_sink_epoll_close (GstMultiFdSink * sink)
+{
+  if (sink->wakeup_fd != -1) {
+    close (sink->wakeup_fd);
+    sink->wakeup_fd = -1;
+  }
+  if (sink->epoll_fd != -1) {
+    close (sink->epoll_fd);
+    sink->epoll_fd = -1;
+  }
+}
+
+#ifdef HAVE_SYS_EPOLL_H
+/* The epoll backend keeps every client fd in an edge-triggered epoll set for
+ * its whole lifetime. The epoll fd itself is polled in fdset so that flushing
+ * and the wait vmethod keep working. Clients with events, and writable clients
+ * that get new data, are put on the pending queue and only those are visited
+ * by the thread. Called with the CLIENTS_LOCK. */
+static void
+gst_multi_fd_sink_epoll_add (GstMultiFdSink * sink, GstTCPClient * client,
+    gboolean do_read)
+{
+  GstMultiHandleClient *mhclient = (GstMultiHandleClient *) client;
+  struct epoll_event ev;
+
+  ev.events = EPOLLOUT | EPOLLET;
+  if (do_read)
+    ev.events |= EPOLLIN;
+  ev.data.ptr = client;
+
+  if (epoll_ctl (sink->epoll_fd, EPOLL_CTL_ADD, client->gfd.fd, &ev) == 0) {
+    client->registered = TRUE;
+  } else {
+    /* regular files can't be added but never block either, so we consider
+     * them always writable. For bad fds the write will error out. */
+    GST_DEBUG_OBJECT (sink, "%s not added to epoll set: %s", mhclient->debug,
+        g_strerror (errno));
+    client->writable = TRUE;
+  }
+}
+
+static void
+gst_multi_fd_sink_epoll_queue (GstMultiFdSink * sink, GstTCPClient * client)
+{
+  if (client->pending)
+    return;
+
+  /* wake up the thread when the queue becomes non-empty, it drains the queue
+   * completely before waiting again */
+  if (g_queue_is_empty (&sink->pending))
+    eventfd_write (sink->wakeup_fd, 1);
+
+  client->pending_link.data = client;
+  g_queue_push_tail_link (&sink->pending, &client->pending_link);
+  client->pending = TRUE;
+}
+
+static gboolean
+gst_multi_fd_sink_epoll_open (GstMultiFdSink * sink)
+{
+  struct epoll_event ev;
+
+  if ((sink->epoll_fd = epoll_create1 (EPOLL_CLOEXEC)) == -1)
+    goto error;
+  if ((sink->wakeup_fd = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC)) == -1)
+    goto error;
+
+  ev.events = EPOLLIN;
+  ev.data.ptr = NULL;
+  if (epoll_ctl (sink->epoll_fd, EPOLL_CTL_ADD, sink->wakeup_fd, &ev) == -1)
+    goto error;
+
+  gst_poll_fd_init (&sink->epoll_gfd);
+  sink->epoll_gfd.fd = sink->epoll_fd;
+  gst_poll_add_fd (sink->fdset, &sink->epoll_gfd);
+  gst_poll_fd_ctl_read (sink->fdset, &sink->epoll_gfd, TRUE);
+
+  return TRUE;
+
+  /* ERRORS */
+error:
+  {
+    GST_WARNING_OBJECT (sink, "could not set up epoll, falling back to "
+        "poll: %s (%d)", g_strerror (errno), errno);
+    gst_multi_fd_sink_epoll_close (sink);
+    return FALSE;
+  }
 }
+#endif
 
 /* vfuncs */
 
@@ -501,6 +697,7 @@ gst_multi_fd_sink_new_client (GstMultiHandleSink * mhsink,
   struct stat statbuf;
   GstTCPClient *client;
   GstMultiHandleClient *mhclient;
+  gboolean do_read = FALSE;
   GstMultiFdSink *sink = GST_MULTI_FD_SINK (mhsink);
   GstMultiHandleSinkClass *mhsinkclass =
       GST_MULTI_HANDLE_SINK_GET_CLASS (mhsink);
@@ -523,17 +720,24 @@ gst_multi_fd_sink_new_client (GstMultiHandleSink * mhsink,
         mhclient->debug, g_strerror (errno));
   }
 
-  /* we always read from a client */
-  gst_poll_add_fd (sink->fdset, &client->gfd);
-
   /* we don't try to read from write only fds */
   if (sink->handle_read) {
     gint flags;
 
     flags = fcntl (handle.fd, F_GETFL, 0);
-    if ((flags & O_ACCMODE) != O_WRONLY) {
+    do_read = (flags & O_ACCMODE) != O_WRONLY;
+  }
+
+#ifdef HAVE_SYS_EPOLL_H
+  if (sink->epoll_fd != -1) {
+    gst_multi_fd_sink_epoll_add (sink, client, do_read);
+  } else
+#endif
+  {
+    /* we always read from a client */
+    gst_poll_add_fd (sink->fdset, &client->gfd);
+    if (do_read)
       gst_poll_fd_ctl_read (sink->fdset, &client->gfd, TRUE);
-    }
   }
   /* figure out the mode, can't use send() for non sockets */
   if (fstat (handle.fd, &statbuf) == 0 && S_ISSOCK (statbuf.st_mode)) {
@@ -569,6 +773,11 @@ gst_multi_fd_sink_hash_changed (GstMultiHandleSink * mhsink)
 {
   GstMultiFdSink *sink = GST_MULTI_FD_SINK (mhsink);
 
+  /* the epoll set doesn't need to be rebuilt, the thread is woken up when
+   * clients are queued */
+  if (sink->epoll_fd != -1)
+    return;
+
   gst_poll_restart (sink->fdset);
 }
 
@@ -647,6 +856,196 @@ ioctl_failed:
   }
 }
 
+/* check if we can take another buffer from the global queue in the
+ * sending queue of @mhclient for a vectored write */
+static gboolean
+gst_multi_fd_sink_client_can_gather (GstMultiFdSink * sink,
+    GstMultiHandleClient * mhclient)
+{
+  GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (sink);
+  GSList *walk;
+  guint n_buffers = 0;
+  gsize size = 0;
+
+  if (!sink->vectored || mhclient->new_connection || mhclient->flushcount == 0
+      || gst_multi_handle_sink_client_get_bufpos (mhsink, mhclient) == -1)
+    return FALSE;
+
+  for (walk = mhclient->sending; walk; walk = walk->next) {
+    size += gst_buffer_get_size (GST_BUFFER (walk->data));
+    n_buffers++;
+  }
+  size -= mhclient->bufoffset;
+
+  return n_buffers < VECTORED_MAX_VECS && size < VECTORED_MAX_BYTES;
+}
+
+/* write as much of the sending queue of @client as possible with one call.
+ * @maxsize is set to the number of bytes we tried to write. */
+static gssize
+gst_multi_fd_sink_client_writev (GstMultiFdSink * sink, GstTCPClient * client,
+    gsize * maxsize)
+{
+  GstMultiHandleClient *mhclient = (GstMultiHandleClient *) client;
+  struct iovec iov[VECTORED_MAX_VECS];
+  GstMapInfo maps[VECTORED_MAX_VECS];
+  gsize offset = mhclient->bufoffset, size = 0;
+  GSList *walk;
+  gint i, n = 0;
+  gssize wrote;
+  int errsv;
+
+  for (walk = mhclient->sending; walk && n < VECTORED_MAX_VECS
+      && size < VECTORED_MAX_BYTES; walk = walk->next) {
+    GstBuffer *buf = GST_BUFFER (walk->data);
+    guint j, n_mem;
+
+    n_mem = gst_buffer_n_memory (buf);
+    for (j = 0; j < n_mem && n < VECTORED_MAX_VECS; j++) {
+      GstMemory *mem = gst_buffer_peek_memory (buf, j);
+
+      /* leave fd backed memory for sendfile */
+      if (n > 0 && sink->sendfile_active && gst_is_fd_memory (mem))
+        goto write;
+
+      if (!gst_memory_map (mem, &maps[n], GST_MAP_READ))
+        goto map_failed;
+
+      /* skip what was written already of the first buffer */
+      if (offset >= maps[n].size) {
+        offset -= maps[n].size;
+        gst_memory_unmap (mem, &maps[n]);
+        continue;
+      }
+      iov[n].iov_base = maps[n].data + offset;
+      iov[n].iov_len = maps[n].size - offset;
+      offset = 0;
+      size += iov[n].iov_len;
+      n++;
+    }
+  }
+
+write:
+  if (client->is_socket) {
+    struct msghdr msg;
+
+    memset (&msg, 0, sizeof (msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = n;
+    wrote = sendmsg (mhclient->handle.fd, &msg, FLAGS);
+  } else {
+    wrote = writev (mhclient->handle.fd, iov, n);
+  }
+  errsv = errno;
+
+  GST_LOG_OBJECT (sink, "%s wrote %" G_GSSIZE_FORMAT " of %" G_GSIZE_FORMAT
+      " bytes in %d vectors", mhclient->debug, wrote, size, n);
+
+  for (i = 0; i < n; i++)
+    gst_memory_unmap (maps[i].memory, &maps[i]);
+
+  *maxsize = size;
+  errno = errsv;
+
+  return wrote;
+
+  /* ERRORS */
+map_failed:
+  {
+    GST_WARNING_OBJECT (sink, "%s could not map buffer", mhclient->debug);
+    for (i = 0; i < n; i++)
+      gst_memory_unmap (maps[i].memory, &maps[i]);
+    *maxsize = 0;
+    errno = EINVAL;
+    return -1;
+  }
+}
+
+#ifdef HAVE_SYS_SENDFILE_H
+/* send the memory at the current offset of @client with sendfile() if it is
+ * backed by a file descriptor. Returns FALSE if the memory can't be sent this
+ * way and needs to be written normally. */
+static gboolean
+gst_multi_fd_sink_client_sendfile (GstMultiFdSink * sink,
+    GstTCPClient * client, gssize * wrote, gsize * maxsize)
+{
+  GstMultiHandleClient *mhclient = (GstMultiHandleClient *) client;
+  GstBuffer *head;
+  GstMemory *mem;
+  guint idx, length;
+  gsize skip, offset, size;
+  off_t off;
+
+  if (!sink->sendfile_active)
+    return FALSE;
+
+  head = GST_BUFFER (mhclient->sending->data);
+  if (!gst_buffer_find_memory (head, mhclient->bufoffset, 1, &idx, &length,
+          &skip))
+    return FALSE;
+
+  mem = gst_buffer_peek_memory (head, idx);
+  if (!gst_is_fd_memory (mem))
+    return FALSE;
+
+  /* fd memory maps the fd from the start, so the memory offset is the offset
+   * in the file */
+  size = gst_memory_get_sizes (mem, &offset, NULL);
+  off = offset + skip;
+  *maxsize = size - skip;
+
+  *wrote = sendfile (mhclient->handle.fd, gst_fd_memory_get_fd (mem), &off,
+      *maxsize);
+  if (*wrote < 0 && (errno == EINVAL || errno == ENOSYS)) {
+    GST_LOG_OBJECT (sink, "%s can't sendfile from fd %d: %s", mhclient->debug,
+        gst_fd_memory_get_fd (mem), g_strerror (errno));
+    return FALSE;
+  }
+  if (*wrote == 0 && *maxsize > 0) {
+    /* the file is shorter than the memory, the missing data will never
+     * arrive and mapping it would fail too, treat it as a read error */
+    GST_WARNING_OBJECT (sink, "%s fd %d ended %" G_GSIZE_FORMAT " bytes early",
+        mhclient->debug, gst_fd_memory_get_fd (mem), *maxsize);
+    errno = EIO;
+    *wrote = -1;
+    return TRUE;
+  }
+
+  GST_LOG_OBJECT (sink, "%s sent %" G_GSSIZE_FORMAT " of %" G_GSIZE_FORMAT
+      " bytes from fd %d", mhclient->debug, *wrote, *maxsize,
+      gst_fd_memory_get_fd (mem));
+  if (*wrote > 0)
+    client->bytes_sendfile += *wrote;
+
+  return TRUE;
+}
+#endif
+
+/* remove the buffers that were written completely from the sending queue of
+ * @mhclient and update the offset in the first remaining one */
+static void
+gst_multi_fd_sink_client_advance (GstMultiHandleClient * mhclient,
+    gsize wrote)
+{
+  while (mhclient->sending) {
+    GstBuffer *head = GST_BUFFER (mhclient->sending->data);
+    gsize left = gst_buffer_get_size (head) - mhclient->bufoffset;
+
+    if (wrote < left) {
+      mhclient->bufoffset += wrote;
+      break;
+    }
+
+    /* complete buffer was written, we can proceed to the next one */
+    wrote -= left;
+    mhclient->sending = g_slist_delete_link (mhclient->sending,
+        mhclient->sending);
+    gst_buffer_unref (head);
+    /* make sure we start from byte 0 for the next buffer */
+    mhclient->bufoffset = 0;
+  }
+}
+
 /* Handle a write on a client,
  * which indicates a read request from a client.
  *
@@ -687,18 +1086,24 @@ gst_multi_fd_sink_handle_client_write (GstMultiFdSink * sink,
 
   more = TRUE;
   do {
-    gint maxsize;
+    gsize maxsize = 0;
+    gssize wrote = 0;
 
     g_get_current_time (&nowtv);
     now = GST_TIMEVAL_TO_TIME (nowtv);
 
-    if (!mhclient->sending) {
-      /* client is not working on a buffer */
-      if (mhclient->bufpos == -1) {
+    if (!mhclient->sending
+        || gst_multi_fd_sink_client_can_gather (sink, mhclient)) {
+      gboolean gathering = mhclient->sending != NULL;
+
+      /* client is not working on a buffer, or it can pick more buffers for a
+       * vectored write */
+      if (gst_multi_handle_sink_client_get_bufpos (mhsink, mhclient) == -1) {
         /* client is too fast, remove from write queue until new buffer is
          * available */
         /* FIXME: specific */
-        gst_poll_fd_ctl_write (sink->fdset, &client->gfd, FALSE);
+        if (sink->epoll_fd == -1)
+          gst_poll_fd_ctl_write (sink->fdset, &client->gfd, FALSE);
 
         /* if we flushed out all of the client buffers, we can stop */
         if (mhclient->flushcount == 0)
@@ -719,11 +1124,13 @@ gst_multi_fd_sink_handle_client_write (GstMultiFdSink * sink,
           if (position >= 0) {
             /* we got a valid spot in the queue */
             mhclient->new_connection = FALSE;
-            mhclient->bufpos = position;
+            gst_multi_handle_sink_client_set_bufpos (mhsink, mhclient,
+                position);
           } else {
             /* cannot send data to this client yet */
             /* FIXME: specific */
-            gst_poll_fd_ctl_write (sink->fdset, &client->gfd, FALSE);
+            if (sink->epoll_fd == -1)
+              gst_poll_fd_ctl_write (sink->fdset, &client->gfd, FALSE);
             return TRUE;
           }
         }
@@ -733,8 +1140,9 @@ gst_multi_fd_sink_handle_client_write (GstMultiFdSink * sink,
           goto flushed;
 
         /* grab buffer */
-        buf = g_array_index (mhsink->bufqueue, GstBuffer *, mhclient->bufpos);
-        mhclient->bufpos--;
+        buf = gst_multi_handle_sink_get_buffer (mhsink,
+            gst_multi_handle_sink_client_get_bufpos (mhsink, mhclient));
+        mhclient->bufseq++;
 
         /* update stats */
         timestamp = GST_BUFFER_TIMESTAMP (buf);
@@ -748,19 +1156,33 @@ gst_multi_fd_sink_handle_client_write (GstMultiFdSink * sink,
           mhclient->flushcount--;
 
         GST_LOG_OBJECT (sink, "%s client %p at position %d",
-            mhclient->debug, client, mhclient->bufpos);
+            mhclient->debug, client,
+            gst_multi_handle_sink_client_get_bufpos (mhsink, mhclient));
 
         /* queueing a buffer will ref it */
         mhsinkclass->client_queue_buffer (mhsink, mhclient, buf);
 
         /* need to start from the first byte for this new buffer */
-        mhclient->bufoffset = 0;
+        if (!gathering)
+          mhclient->bufoffset = 0;
+
+        /* see if we can add more buffers to the vectored write */
+        if (gst_multi_fd_sink_client_can_gather (sink, mhclient))
+          continue;
       }
     }
 
     /* see if we need to send something */
-    if (mhclient->sending) {
-      ssize_t wrote;
+#ifdef HAVE_SYS_SENDFILE_H
+    if (mhclient->sending
+        && gst_multi_fd_sink_client_sendfile (sink, client, &wrote, &maxsize)) {
+      /* sent without copying */
+    } else
+#endif
+    if (mhclient->sending && sink->vectored) {
+      /* try to write all pending buffers */
+      wrote = gst_multi_fd_sink_client_writev (sink, client, &maxsize);
+    } else if (mhclient->sending) {
       GstBuffer *head;
       GstMapInfo info;
       guint8 *data;
@@ -776,44 +1198,38 @@ gst_multi_fd_sink_handle_client_write (GstMultiFdSink * sink,
 
       /* FIXME: specific */
       /* try to write the complete buffer */
-#ifdef MSG_NOSIGNAL
-#define FLAGS MSG_NOSIGNAL
-#else
-#define FLAGS 0
-#endif
       if (client->is_socket) {
         wrote = send (fd, data + mhclient->bufoffset, maxsize, FLAGS);
       } else {
         wrote = write (fd, data + mhclient->bufoffset, maxsize);
       }
       gst_buffer_unmap (head, &info);
+    }
 
+    if (mhclient->sending) {
       if (wrote < 0) {
         /* hmm error.. */
         if (errno == EAGAIN) {
           /* nothing serious, resource was unavailable, try again later */
           more = FALSE;
+          /* with epoll we get a new EPOLLOUT edge when there is space */
+          client->writable = FALSE;
         } else if (errno == ECONNRESET) {
           goto connection_reset;
         } else {
           goto write_error;
         }
       } else {
-        if (wrote < maxsize) {
+        if ((gsize) wrote < maxsize) {
           /* partial write means that the client cannot read more and we should
            * stop sending more */
           GST_LOG_OBJECT (sink,
               "partial write on %s of %" G_GSSIZE_FORMAT " bytes",
               mhclient->debug, wrote);
-          mhclient->bufoffset += wrote;
-          more = FALSE;
-        } else {
-          /* complete buffer was written, we can proceed to the next one */
-          mhclient->sending = g_slist_remove (mhclient->sending, head);
-          gst_buffer_unref (head);
-          /* make sure we start from byte 0 for the next buffer */
-          mhclient->bufoffset = 0;
+          /* with epoll we have to write until EAGAIN to get a new edge */
+          more = sink->epoll_fd != -1;
         }
+        gst_multi_fd_sink_client_advance (mhclient, wrote);
         /* update stats */
         mhclient->bytes_sent += wrote;
         mhclient->last_activity_time = now;
@@ -855,6 +1271,15 @@ gst_multi_fd_sink_hash_adding (GstMultiHandleSink * mhsink,
   GstMultiFdSink *sink = GST_MULTI_FD_SINK (mhsink);
   GstTCPClient *client = (GstTCPClient *) mhclient;
 
+#ifdef HAVE_SYS_EPOLL_H
+  if (sink->epoll_fd != -1) {
+    /* a writable client won't get a new edge, queue it ourselves */
+    if (client->writable)
+      gst_multi_fd_sink_epoll_queue (sink, client);
+    return;
+  }
+#endif
+
   gst_poll_fd_ctl_write (sink->fdset, &client->gfd, TRUE);
 }
 
@@ -865,10 +1290,117 @@ gst_multi_fd_sink_hash_removing (GstMultiHandleSink * mhsink,
   GstMultiFdSink *sink = GST_MULTI_FD_SINK (mhsink);
   GstTCPClient *client = (GstTCPClient *) mhclient;
 
+#ifdef HAVE_SYS_EPOLL_H
+  if (sink->epoll_fd != -1) {
+    if (client->registered) {
+      epoll_ctl (sink->epoll_fd, EPOLL_CTL_DEL, client->gfd.fd, NULL);
+      client->registered = FALSE;
+    }
+    if (client->pending) {
+      g_queue_unlink (&sink->pending, &client->pending_link);
+      client->pending = FALSE;
+    }
+    return;
+  }
+#endif
+
   gst_poll_remove_fd (sink->fdset, &client->gfd);
 }
 
 
+#ifdef HAVE_SYS_EPOLL_H
+/* collect the events from the epoll set and handle the pending clients.
+ * Called with the CLIENTS_LOCK. */
+static void
+gst_multi_fd_sink_epoll_dispatch (GstMultiFdSink * sink)
+{
+  GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (sink);
+  GstMultiHandleSinkClass *mhsinkclass =
+      GST_MULTI_HANDLE_SINK_GET_CLASS (mhsink);
+  struct epoll_event events[EPOLL_MAX_EVENTS];
+  GList *link;
+  gint i, n;
+
+  /* only record the events here, removing a client releases the lock so we
+   * can't keep client pointers from the events array around */
+  for (;;) {
+    n = epoll_wait (sink->epoll_fd, events, EPOLL_MAX_EVENTS, 0);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      GST_WARNING_OBJECT (sink, "epoll_wait failed: %s (%d)",
+          g_strerror (errno), errno);
+      break;
+    }
+
+    for (i = 0; i < n; i++) {
+      GstTCPClient *client = events[i].data.ptr;
+
+      if (client == NULL) {
+        eventfd_t val;
+
+        /* wakeup, the pending queue was filled */
+        eventfd_read (sink->wakeup_fd, &val);
+        continue;
+      }
+      if (events[i].events & EPOLLOUT)
+        client->writable = TRUE;
+      client->events |= events[i].events;
+      gst_multi_fd_sink_epoll_queue (sink, client);
+    }
+    if (n < EPOLL_MAX_EVENTS)
+      break;
+  }
+
+  GST_LOG_OBJECT (sink, "%u clients pending", sink->pending.length);
+
+  while ((link = g_queue_pop_head_link (&sink->pending))) {
+    GstTCPClient *client = link->data;
+    GstMultiHandleClient *mhclient = (GstMultiHandleClient *) client;
+    guint32 revents = client->events;
+    GList *clink;
+
+    client->pending = FALSE;
+    client->events = 0;
+
+    clink = g_hash_table_lookup (mhsink->handle_hash,
+        mhsinkclass->handle_hash_key (mhclient->handle));
+    if (G_UNLIKELY (clink == NULL))
+      continue;
+
+    if (mhclient->status != GST_CLIENT_STATUS_FLUSHING
+        && mhclient->status != GST_CLIENT_STATUS_OK) {
+      gst_multi_handle_sink_remove_client_link (mhsink, clink);
+      continue;
+    }
+    if (revents & EPOLLHUP) {
+      mhclient->status = GST_CLIENT_STATUS_CLOSED;
+      gst_multi_handle_sink_remove_client_link (mhsink, clink);
+      continue;
+    }
+    if (revents & EPOLLERR) {
+      GST_WARNING_OBJECT (sink, "epoll error for %d", client->gfd.fd);
+      mhclient->status = GST_CLIENT_STATUS_ERROR;
+      gst_multi_handle_sink_remove_client_link (mhsink, clink);
+      continue;
+    }
+    if (revents & EPOLLIN) {
+      if (!gst_multi_fd_sink_handle_client_read (sink, client)) {
+        gst_multi_handle_sink_remove_client_link (mhsink, clink);
+        continue;
+      }
+    }
+    if (client->writable) {
+      if (!gst_multi_fd_sink_handle_client_write (sink, client)) {
+        gst_multi_handle_sink_remove_client_link (mhsink, clink);
+        continue;
+      }
+    }
+  }
+}
+
+#endif
+
 /* Handle the clients. Basically does a blocking select for one
  * of the client fds to become read or writable. We also have a
  * filedescriptor to receive commands on that we need to check.
@@ -994,6 +1526,14 @@ gst_multi_fd_sink_handle_clients (GstMultiFdSink * sink)
   /* Check the clients */
   CLIENTS_LOCK (mhsink);
 
+#ifdef HAVE_SYS_EPOLL_H
+  if (sink->epoll_fd != -1) {
+    gst_multi_fd_sink_epoll_dispatch (sink);
+    CLIENTS_UNLOCK (mhsink);
+    return;
+  }
+#endif
+
 restart2:
   cookie = mhsink->clients_cookie;
   for (clients = mhsink->clients; clients; clients = next) {
@@ -1051,6 +1591,19 @@ gst_multi_fd_sink_thread (GstMultiHandleSink * mhsink)
 {
   GstMultiFdSink *sink = GST_MULTI_FD_SINK (mhsink);
 
+#ifdef HAVE_SYS_SENDFILE_H
+  sink->sendfile_active = sink->sendfile;
+  if (sink->sendfile_active) {
+    sigset_t set;
+
+    /* unlike send(), sendfile() has no MSG_NOSIGNAL, make it fail with EPIPE
+     * instead of raising SIGPIPE in this thread */
+    sigemptyset (&set);
+    sigaddset (&set, SIGPIPE);
+    pthread_sigmask (SIG_BLOCK, &set, NULL);
+  }
+#endif
+
   while (mhsink->running) {
     gst_multi_fd_sink_handle_clients (sink);
   }
@@ -1069,6 +1622,15 @@ gst_multi_fd_sink_set_property (GObject * object, guint prop_id,
     case PROP_HANDLE_READ:
       multifdsink->handle_read = g_value_get_boolean (value);
       break;
+    case PROP_USE_EPOLL:
+      multifdsink->use_epoll = g_value_get_boolean (value);
+      break;
+    case PROP_VECTORED:
+      multifdsink->vectored = g_value_get_boolean (value);
+      break;
+    case PROP_SENDFILE:
+      multifdsink->sendfile = g_value_get_boolean (value);
+      break;
 
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -1088,6 +1650,15 @@ gst_multi_fd_sink_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_HANDLE_READ:
       g_value_set_boolean (value, multifdsink->handle_read);
       break;
+    case PROP_USE_EPOLL:
+      g_value_set_boolean (value, multifdsink->use_epoll);
+      break;
+    case PROP_VECTORED:
+      g_value_set_boolean (value, multifdsink->vectored);
+      break;
+    case PROP_SENDFILE:
+      g_value_set_boolean (value, multifdsink->sendfile);
+      break;
 
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -1104,6 +1675,11 @@ gst_multi_fd_sink_start_pre (GstMultiHandleSink * mhsink)
   if ((mfsink->fdset = gst_poll_new (TRUE)) == NULL)
     goto socket_pair;
 
+#ifdef HAVE_SYS_EPOLL_H
+  if (mfsink->use_epoll)
+    gst_multi_fd_sink_epoll_open (mfsink);
+#endif
+
   return TRUE;
 
   /* ERRORS */
@@ -1138,6 +1714,7 @@ gst_multi_fd_sink_stop_post (GstMultiHandleSink * mhsink)
     gst_poll_free (mfsink->fdset);
     mfsink->fdset = NULL;
   }
+  gst_multi_fd_sink_epoll_close (mfsink);
   g_hash_table_foreach_remove (mhsink->handle_hash, multifdsink_hash_remove,
       mfsink);
 }
@@ -55,6 +55,15 @@ typedef struct {
   GstPollFD gfd;
 
   gboolean is_socket;
+
+  /* epoll backend state */
+  gboolean registered;  /* fd was added to the epoll set */
+  gboolean writable;    /* last EPOLLOUT edge was not followed by EAGAIN */
+  guint32 events;       /* events gathered since the last dispatch */
+  GList pending_link;   /* link in the pending queue */
+  gboolean pending;
+
+  guint64 bytes_sendfile; /* bytes sent with sendfile() */
 } GstTCPClient;
 
 /**
@@ -69,6 +78,15 @@ struct _GstMultiFdSink {
   GstPoll *fdset;
 
   gboolean handle_read;
+  gboolean use_epoll;
+  gboolean vectored;
+  gboolean sendfile;
+  gboolean sendfile_active; /* sendfile as used by the running thread */
+
+  gint epoll_fd;        /* -1 when clients are in fdset */
+  GstPollFD epoll_gfd;  /* epoll_fd as polled in fdset */
+  gint wakeup_fd;       /* eventfd in the epoll set to wake up the thread */
+  GQueue pending;       /* clients that have events or data to write */
 };
 
 struct _GstMultiFdSinkClass {
@@ -314,6 +314,8 @@ static gboolean
 find_limits (GstMultiHandleSink * sink,
     gint * min_idx, gint bytes_min, gint buffers_min, gint64 time_min,
     gint * max_idx, gint bytes_max, gint buffers_max, gint64 time_max);
+static GstCaps *gst_multi_handle_sink_get_buffer_caps (GstMultiHandleSink *
+    sink, gint pos);
 
 
 static void
@@ -494,7 +496,11 @@ gst_multi_handle_sink_init (GstMultiHandleSink * this)
   CLIENTS_LOCK_INIT (this);
   this->clients = NULL;
 
-  this->bufqueue = g_array_new (FALSE, TRUE, sizeof (GstBuffer *));
+  this->bufqueue = NULL;
+  this->bufcaps = NULL;
+  this->bufqueue_size = 0;
+  this->bufqueue_len = 0;
+  this->bufqueue_seq = 0;
   this->unit_format = DEFAULT_UNIT_FORMAT;
   this->units_max = DEFAULT_UNITS_MAX;
   this->units_soft_max = DEFAULT_UNITS_SOFT_MAX;
@@ -522,7 +528,8 @@ gst_multi_handle_sink_finalize (GObject * object)
   this = GST_MULTI_HANDLE_SINK (object);
 
   CLIENTS_LOCK_CLEAR (this);
-  g_array_free (this->bufqueue, TRUE);
+  g_free (this->bufqueue);
+  g_free (this->bufcaps);
   g_hash_table_destroy (this->handle_hash);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
@@ -602,7 +609,7 @@ gst_multi_handle_sink_client_init (GstMultiHandleClient * client,
   GTimeVal now;
 
   client->status = GST_CLIENT_STATUS_OK;
-  client->bufpos = -1;
+  client->bufseq = 0;
   client->flushcount = -1;
   client->bufoffset = 0;
   client->sending = NULL;
@@ -682,6 +689,8 @@ gst_multi_handle_sink_add_full (GstMultiHandleSink * sink,
    * GstMultiHandleSink relies on the derived class to take a reference for us
    * in new_client: */
   mhclient = mhsinkclass->new_client (mhsink, handle, sync_method);
+  /* the client starts with the next buffer that is queued */
+  gst_multi_handle_sink_client_set_bufpos (mhsink, mhclient, -1);
 
   /* we can add the handle now */
   clink = mhsink->clients = g_list_prepend (mhsink->clients, mhclient);
@@ -804,7 +813,8 @@ gst_multi_handle_sink_remove_flush (GstMultiHandleSink * sink,
     /* take the position of the client as the number of buffers left to flush.
      * If the client was at position -1, we flush 0 buffers, 0 == flush 1
      * buffer, etc... */
-    mhclient->flushcount = mhclient->bufpos + 1;
+    mhclient->flushcount =
+        gst_multi_handle_sink_client_get_bufpos (mhsink, mhclient) + 1;
     /* mark client as flushing. We can not remove the client right away because
      * it might have some buffers to flush in the ->sending queue. */
     mhclient->status = GST_CLIENT_STATUS_FLUSHING;
@@ -1027,15 +1037,29 @@ gst_multi_handle_sink_client_queue_buffer (GstMultiHandleSink * mhsink,
     GstMultiHandleClient * mhclient, GstBuffer * buffer)
 {
   GstMultiHandleSink *sink = GST_MULTI_HANDLE_SINK (mhsink);
-  GstCaps *caps;
+  GstCaps *caps = NULL;
+  gint pos;
 
   /* TRUE: send them if the new caps have them */
   gboolean send_streamheader = FALSE;
   GstStructure *s;
 
   /* before we queue the buffer, we check if we need to queue streamheader
-   * buffers (because it's a new client, or because they changed) */
-  caps = gst_pad_get_current_caps (GST_BASE_SINK_PAD (sink));
+   * buffers (because it's a new client, or because they changed). Use the
+   * caps that were recorded when the buffer was queued, they are shared by
+   * all clients, so we usually only need to compare pointers. */
+  pos = gst_multi_handle_sink_client_get_bufpos (sink, mhclient) + 1;
+  if (pos >= 0 && pos < sink->bufqueue_len
+      && gst_multi_handle_sink_get_buffer (sink, pos) == buffer)
+    caps = gst_multi_handle_sink_get_buffer_caps (sink, pos);
+
+  if (G_LIKELY (caps != NULL && caps == mhclient->caps))
+    goto queue;
+
+  if (caps)
+    gst_caps_ref (caps);
+  else
+    caps = gst_pad_get_current_caps (GST_BASE_SINK_PAD (sink));
 
   if (!mhclient->caps) {
     GST_DEBUG_OBJECT (sink,
@@ -1130,6 +1154,7 @@ gst_multi_handle_sink_client_queue_buffer (GstMultiHandleSink * mhsink,
   gst_caps_unref (caps);
   caps = NULL;
 
+queue:
   GST_LOG_OBJECT (sink, "%s queueing buffer of length %" G_GSIZE_FORMAT,
       mhclient->debug, gst_buffer_get_size (buffer));
 
@@ -1147,6 +1172,91 @@ is_sync_frame (GstMultiHandleSink * sink, GstBuffer * buffer)
   return TRUE;
 }
 
+/* The global buffer queue is a ring that is indexed by the sequence number of
+ * the buffers. Queueing a buffer is O(1) and positions in the queue are
+ * relative to the newest buffer, which is at position 0. Clients store the
+ * sequence number of the next buffer they need to send, so their position
+ * moves up automatically when a new buffer is queued. */
+GstBuffer *
+gst_multi_handle_sink_get_buffer (GstMultiHandleSink * sink, gint pos)
+{
+  guint64 seq = sink->bufqueue_seq - 1 - pos;
+
+  return sink->bufqueue[seq & (sink->bufqueue_size - 1)];
+}
+
+/* Returns: the position of the next buffer @client will send, -1 if the
+ * client has sent all queued buffers */
+gint
+gst_multi_handle_sink_client_get_bufpos (GstMultiHandleSink * sink,
+    GstMultiHandleClient * client)
+{
+  return (gint) ((gint64) (sink->bufqueue_seq - client->bufseq) - 1);
+}
+
+void
+gst_multi_handle_sink_client_set_bufpos (GstMultiHandleSink * sink,
+    GstMultiHandleClient * client, gint bufpos)
+{
+  client->bufseq = sink->bufqueue_seq - 1 - bufpos;
+}
+
+/* the caps that were current when the buffer at @pos was queued */
+static GstCaps *
+gst_multi_handle_sink_get_buffer_caps (GstMultiHandleSink * sink, gint pos)
+{
+  guint64 seq = sink->bufqueue_seq - 1 - pos;
+
+  return sink->bufcaps[seq & (sink->bufqueue_size - 1)];
+}
+
+/* takes ownership of @buffer and @caps */
+static void
+gst_multi_handle_sink_bufqueue_push (GstMultiHandleSink * sink,
+    GstBuffer * buffer, GstCaps * caps)
+{
+  guint slot;
+
+  if (sink->bufqueue_len == sink->bufqueue_size) {
+    guint size = MAX (sink->bufqueue_size * 2, 16);
+    GstBuffer **bufqueue = g_new (GstBuffer *, size);
+    GstCaps **bufcaps = g_new (GstCaps *, size);
+    guint64 seq;
+
+    /* move the buffers to their slot in the bigger ring */
+    for (seq = sink->bufqueue_seq - sink->bufqueue_len;
+        seq < sink->bufqueue_seq; seq++) {
+      slot = seq & (sink->bufqueue_size - 1);
+      bufqueue[seq & (size - 1)] = sink->bufqueue[slot];
+      bufcaps[seq & (size - 1)] = sink->bufcaps[slot];
+    }
+
+    g_free (sink->bufqueue);
+    g_free (sink->bufcaps);
+    sink->bufqueue = bufqueue;
+    sink->bufcaps = bufcaps;
+    sink->bufqueue_size = size;
+  }
+  slot = sink->bufqueue_seq & (sink->bufqueue_size - 1);
+  sink->bufqueue[slot] = buffer;
+  sink->bufcaps[slot] = caps;
+  sink->bufqueue_seq++;
+  sink->bufqueue_len++;
+}
+
+/* remove the oldest buffer from the queue and return it */
+static GstBuffer *
+gst_multi_handle_sink_bufqueue_pop (GstMultiHandleSink * sink)
+{
+  guint64 seq = sink->bufqueue_seq - sink->bufqueue_len;
+  guint slot = seq & (sink->bufqueue_size - 1);
+
+  sink->bufqueue_len--;
+  gst_caps_replace (&sink->bufcaps[slot], NULL);
+
+  return sink->bufqueue[slot];
+}
+
 /* find the keyframe in the list of buffers starting the
  * search from @idx. @direction as -1 will search backwards, 
  * 1 will search forwards.
@@ -1158,7 +1268,7 @@ find_syncframe (GstMultiHandleSink * sink, gint idx, gint direction)
   gint i, len, result;
 
   /* take length of queued buffers */
-  len = sink->bufqueue->len;
+  len = sink->bufqueue_len;
 
   /* assume we don't find a keyframe */
   result = -1;
@@ -1167,7 +1277,7 @@ find_syncframe (GstMultiHandleSink * sink, gint idx, gint direction)
   for (i = idx; i >= 0 && i < len; i += direction) {
     GstBuffer *buf;
 
-    buf = g_array_index (sink->bufqueue, GstBuffer *, i);
+    buf = gst_multi_handle_sink_get_buffer (sink, i);
     if (is_sync_frame (sink, buf)) {
       GST_LOG_OBJECT (sink, "found keyframe at %d from %d, direction %d",
           i, idx, direction);
@@ -1196,10 +1306,10 @@ get_buffers_max (GstMultiHandleSink * sink, gint64 max)
       gint64 diff;
       GstClockTime first = GST_CLOCK_TIME_NONE;
 
-      len = sink->bufqueue->len;
+      len = sink->bufqueue_len;
 
       for (i = 0; i < len; i++) {
-        buf = g_array_index (sink->bufqueue, GstBuffer *, i);
+        buf = gst_multi_handle_sink_get_buffer (sink, i);
         if (GST_BUFFER_TIMESTAMP_IS_VALID (buf)) {
           if (first == -1)
             first = GST_BUFFER_TIMESTAMP (buf);
@@ -1219,10 +1329,10 @@ get_buffers_max (GstMultiHandleSink * sink, gint64 max)
       int len;
       gint acc = 0;
 
-      len = sink->bufqueue->len;
+      len = sink->bufqueue_len;
 
       for (i = 0; i < len; i++) {
-        buf = g_array_index (sink->bufqueue, GstBuffer *, i);
+        buf = gst_multi_handle_sink_get_buffer (sink, i);
         acc += gst_buffer_get_size (buf);
 
         if (acc > max)
@@ -1257,7 +1367,7 @@ find_limits (GstMultiHandleSink * sink,
   gboolean result, max_hit;
 
   /* take length of queue */
-  len = sink->bufqueue->len;
+  len = sink->bufqueue_len;
 
   /* this must hold */
   g_assert (len > 0);
@@ -1304,7 +1414,7 @@ find_limits (GstMultiHandleSink * sink,
       result = *min_idx != -1;
       break;
     }
-    buf = g_array_index (sink->bufqueue, GstBuffer *, i);
+    buf = gst_multi_handle_sink_get_buffer (sink, i);
 
     bytes += gst_buffer_get_size (buf);
 
@@ -1416,27 +1526,28 @@ gst_multi_handle_sink_new_client_position (GstMultiHandleSink * sink,
     GstMultiHandleClient * client)
 {
   gint result;
+  gint bufpos = gst_multi_handle_sink_client_get_bufpos (sink, client);
 
   GST_DEBUG_OBJECT (sink,
       "%s new client, deciding where to start in queue", client->debug);
   GST_DEBUG_OBJECT (sink, "queue is currently %d buffers long",
-      sink->bufqueue->len);
+      sink->bufqueue_len);
   switch (client->sync_method) {
     case GST_SYNC_METHOD_LATEST:
       /* no syncing, we are happy with whatever the client is going to get */
-      result = client->bufpos;
+      result = bufpos;
       GST_DEBUG_OBJECT (sink,
           "%s SYNC_METHOD_LATEST, position %d", client->debug, result);
       break;
     case GST_SYNC_METHOD_NEXT_KEYFRAME:
     {
-      /* if one of the new buffers (between client->bufpos and 0) in the queue
+      /* if one of the new buffers (between bufpos and 0) in the queue
        * is a sync point, we can proceed, otherwise we need to keep waiting */
       GST_LOG_OBJECT (sink,
           "%s new client, bufpos %d, waiting for keyframe",
-          client->debug, client->bufpos);
+          client->debug, bufpos);
 
-      result = find_prev_syncframe (sink, client->bufpos);
+      result = find_prev_syncframe (sink, bufpos);
       if (result != -1) {
         GST_DEBUG_OBJECT (sink,
             "%s SYNC_METHOD_NEXT_KEYFRAME: result %d", client->debug, result);
@@ -1448,7 +1559,7 @@ gst_multi_handle_sink_new_client_position (GstMultiHandleSink * sink,
       GST_LOG_OBJECT (sink,
           "%s new client, skipping buffer(s), no syncpoint found",
           client->debug);
-      client->bufpos = -1;
+      gst_multi_handle_sink_client_set_bufpos (sink, client, -1);
       break;
     }
     case GST_SYNC_METHOD_LATEST_KEYFRAME:
@@ -1471,7 +1582,7 @@ gst_multi_handle_sink_new_client_position (GstMultiHandleSink * sink,
           "%s SYNC_METHOD_LATEST_KEYFRAME: no keyframe found, "
           "switching to SYNC_METHOD_NEXT_KEYFRAME", client->debug);
       /* throw client to the waiting state */
-      client->bufpos = -1;
+      gst_multi_handle_sink_client_set_bufpos (sink, client, -1);
       /* and make client sync to next keyframe */
       client->sync_method = GST_SYNC_METHOD_NEXT_KEYFRAME;
       break;
@@ -1546,7 +1657,7 @@ gst_multi_handle_sink_new_client_position (GstMultiHandleSink * sink,
           "no prev keyframe found in BURST_KEYFRAME sync mode, waiting for next");
 
       /* throw client to the waiting state */
-      client->bufpos = -1;
+      gst_multi_handle_sink_client_set_bufpos (sink, client, -1);
       /* and make client sync to next keyframe */
       client->sync_method = GST_SYNC_METHOD_NEXT_KEYFRAME;
       result = -1;
@@ -1593,7 +1704,7 @@ gst_multi_handle_sink_new_client_position (GstMultiHandleSink * sink,
     }
     default:
       g_warning ("unknown sync method %d", client->sync_method);
-      result = client->bufpos;
+      result = bufpos;
       break;
   }
   return result;
@@ -1607,17 +1718,19 @@ gint
 gst_multi_handle_sink_recover_client (GstMultiHandleSink * sink,
     GstMultiHandleClient * client)
 {
-  gint newbufpos;
+  gint bufpos, newbufpos;
+
+  bufpos = gst_multi_handle_sink_client_get_bufpos (sink, client);
 
   GST_WARNING_OBJECT (sink,
       "%s client %p is lagging at %d, recover using policy %d",
-      client->debug, client, client->bufpos, sink->recover_policy);
+      client->debug, client, bufpos, sink->recover_policy);
 
   switch (sink->recover_policy) {
     case GST_RECOVER_POLICY_NONE:
       /* do nothing, client will catch up or get kicked out when it reaches
        * the hard max */
-      newbufpos = client->bufpos;
+      newbufpos = bufpos;
       break;
     case GST_RECOVER_POLICY_RESYNC_LATEST:
       /* move to beginning of queue */
@@ -1630,13 +1743,13 @@ gst_multi_handle_sink_recover_client (GstMultiHandleSink * sink,
     case GST_RECOVER_POLICY_RESYNC_KEYFRAME:
       /* find keyframe in buffers, we search backwards to find the
        * closest keyframe relative to what this client already received. */
-      newbufpos = MIN (sink->bufqueue->len - 1,
+      newbufpos = MIN (sink->bufqueue_len - 1,
           get_buffers_max (sink, sink->units_soft_max) - 1);
 
       while (newbufpos >= 0) {
         GstBuffer *buf;
 
-        buf = g_array_index (sink->bufqueue, GstBuffer *, newbufpos);
+        buf = gst_multi_handle_sink_get_buffer (sink, newbufpos);
         if (is_sync_frame (sink, buf)) {
           /* found a buffer that is not a delta unit */
           break;
@@ -1654,13 +1767,13 @@ gst_multi_handle_sink_recover_client (GstMultiHandleSink * sink,
 
 /* Queue a buffer on the global queue.
  *
- * This function adds the buffer to the front of a GArray. It removes the
+ * This function adds the buffer to the front of the ring. It removes the
  * tail buffer if the max queue size is exceeded, unreffing the queued buffer.
  * Note that unreffing the buffer is not a problem as clients who
  * started writing out this buffer will still have a reference to it in the
  * mhclient->sending queue.
  *
- * After adding the buffer, we update all client positions in the queue. If
+ * After adding the buffer, we check all client positions in the queue. If
  * a client moves over the soft max, we start the recovery procedure for this
  * slow client. If it goes over the hard max, it is put into the slow list
  * and removed.
@@ -1683,14 +1796,18 @@ gst_multi_handle_sink_queue_buffer (GstMultiHandleSink * mhsink,
   GstClockTime now;
   gint max_buffers, soft_max_buffers;
   guint cookie;
+  GstCaps *caps;
   GstMultiHandleSink *sink = GST_MULTI_HANDLE_SINK (mhsink);
   GstMultiHandleSinkClass *mhsinkclass =
       GST_MULTI_HANDLE_SINK_GET_CLASS (mhsink);
 
+  /* record the caps of the buffer once for all clients */
+  caps = gst_pad_get_current_caps (GST_BASE_SINK_PAD (mhsink));
+
   CLIENTS_LOCK (mhsink);
   /* add buffer to queue */
-  g_array_prepend_val (mhsink->bufqueue, buffer);
-  queuelen = mhsink->bufqueue->len;
+  gst_multi_handle_sink_bufqueue_push (mhsink, buffer, caps);
+  queuelen = mhsink->bufqueue_len;
 
   if (mhsink->units_max > 0)
     max_buffers = get_buffers_max (mhsink, mhsink->units_max);
@@ -1704,26 +1821,26 @@ gst_multi_handle_sink_queue_buffer (GstMultiHandleSink * mhsink,
   GST_LOG_OBJECT (sink, "Using max %d, softmax %d", max_buffers,
       soft_max_buffers);
 
-  /* then loop over the clients and update the positions */
+  /* then loop over the clients and check the positions */
   cookie = mhsink->clients_cookie;
   for (clients = mhsink->clients; clients; clients = clients->next) {
     GstMultiHandleClient *mhclient = clients->data;
+    gint bufpos = gst_multi_handle_sink_client_get_bufpos (mhsink, mhclient);
 
-    mhclient->bufpos++;
     GST_LOG_OBJECT (sink, "%s client %p at position %d",
-        mhclient->debug, mhclient, mhclient->bufpos);
+        mhclient->debug, mhclient, bufpos);
 
     /* check soft max if needed, recover client */
-    if (soft_max_buffers > 0 && mhclient->bufpos >= soft_max_buffers) {
+    if (soft_max_buffers > 0 && bufpos >= soft_max_buffers) {
       gint newpos;
 
       newpos = gst_multi_handle_sink_recover_client (mhsink, mhclient);
-      if (newpos != mhclient->bufpos) {
-        mhclient->dropped_buffers += mhclient->bufpos - newpos;
-        mhclient->bufpos = newpos;
+      if (newpos != bufpos) {
+        mhclient->dropped_buffers += bufpos - newpos;
+        gst_multi_handle_sink_client_set_bufpos (mhsink, mhclient, newpos);
         mhclient->discont = TRUE;
         GST_INFO_OBJECT (sink, "%s client %p position reset to %d",
-            mhclient->debug, mhclient, mhclient->bufpos);
+            mhclient->debug, mhclient, newpos);
       } else {
         GST_INFO_OBJECT (sink,
             "%s client %p not recovering position", mhclient->debug, mhclient);
@@ -1740,6 +1857,7 @@ restart:
   cookie = mhsink->clients_cookie;
   for (clients = mhsink->clients; clients; clients = next) {
     GstMultiHandleClient *mhclient = clients->data;
+    gint bufpos;
 
     if (cookie != mhsink->clients_cookie) {
       GST_DEBUG_OBJECT (sink, "Clients cookie outdated, restarting");
@@ -1747,9 +1865,10 @@ restart:
     }
 
     next = g_list_next (clients);
+    bufpos = gst_multi_handle_sink_client_get_bufpos (mhsink, mhclient);
 
     /* check hard max and timeout, remove client */
-    if ((max_buffers > 0 && mhclient->bufpos >= max_buffers) ||
+    if ((max_buffers > 0 && bufpos >= max_buffers) ||
         (mhsink->timeout > 0
             && now - mhclient->last_activity_time > mhsink->timeout)) {
       /* remove client */
@@ -1759,11 +1878,11 @@ restart:
        * will be signaled */
       mhclient->status = GST_CLIENT_STATUS_SLOW;
       /* set client to invalid position while being removed */
-      mhclient->bufpos = -1;
+      gst_multi_handle_sink_client_set_bufpos (mhsink, mhclient, -1);
       gst_multi_handle_sink_remove_client_link (mhsink, clients);
       hash_changed = TRUE;
       continue;
-    } else if (mhclient->bufpos == 0 || mhclient->new_connection) {
+    } else if (bufpos == 0 || mhclient->new_connection) {
       /* can send data to this client now. need to signal the select thread that
        * the handle_set changed */
       mhsinkclass->hash_adding (mhsink, mhclient);
@@ -1771,8 +1890,8 @@ restart:
     }
 
     /* keep track of maximum buffer usage */
-    if (mhclient->bufpos > max_buffer_usage) {
-      max_buffer_usage = mhclient->bufpos;
+    if (bufpos > max_buffer_usage) {
+      max_buffer_usage = bufpos;
     }
   }
 
@@ -1813,7 +1932,7 @@ restart:
         "extending queue to include sync point, now at %d, limit is %d",
         max_buffer_usage, limit);
     for (i = 0; i < limit; i++) {
-      buf = g_array_index (mhsink->bufqueue, GstBuffer *, i);
+      buf = gst_multi_handle_sink_get_buffer (mhsink, i);
       if (is_sync_frame (mhsink, buf)) {
         /* found a sync frame, now extend the buffer usage to
          * include at least this frame. */
@@ -1827,15 +1946,13 @@ restart:
   GST_LOG_OBJECT (sink, "len %d, usage %d", queuelen, max_buffer_usage);
 
   /* nobody is referencing units after max_buffer_usage so we can
-   * remove them from the queue. We remove them in reverse order as
-   * this is the most optimal for GArray. */
+   * remove them from the tail of the queue. */
   for (i = queuelen - 1; i > max_buffer_usage; i--) {
     GstBuffer *old;
 
     /* queue exceeded max size */
     queuelen--;
-    old = g_array_index (mhsink->bufqueue, GstBuffer *, i);
-    mhsink->bufqueue = g_array_remove_index (mhsink->bufqueue, i);
+    old = gst_multi_handle_sink_bufqueue_pop (mhsink);
 
     /* unref tail buffer */
     gst_buffer_unref (old);
@@ -2205,15 +2322,14 @@ gst_multi_handle_sink_stop (GstBaseSink * bsink)
   /* remove all queued buffers */
   if (mhsink->bufqueue) {
     GST_DEBUG_OBJECT (mhsink, "Emptying bufqueue with %d buffers",
-        mhsink->bufqueue->len);
-    for (i = mhsink->bufqueue->len - 1; i >= 0; --i) {
-      buf = g_array_index (mhsink->bufqueue, GstBuffer *, i);
+        mhsink->bufqueue_len);
+    for (i = mhsink->bufqueue_len - 1; i >= 0; --i) {
+      buf = gst_multi_handle_sink_bufqueue_pop (mhsink);
       GST_LOG_OBJECT (mhsink, "Removing buffer %p (%d) with refcount %d", buf,
           i, GST_MINI_OBJECT_REFCOUNT (buf));
       gst_buffer_unref (buf);
-      mhsink->bufqueue = g_array_remove_index (mhsink->bufqueue, i);
     }
-    /* freeing the array is done in _finalize */
+    /* freeing the ring is done in _finalize */
   }
   GST_OBJECT_FLAG_UNSET (mhsink, GST_MULTI_HANDLE_SINK_OPEN);
 
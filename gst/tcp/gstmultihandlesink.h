@@ -136,7 +136,8 @@ typedef struct {
 
   gchar debug[30];              /* a debug string used in debug calls to
                                    identify the client */
-  gint bufpos;                  /* position of this client in the global queue */
+  guint64 bufseq;               /* sequence number of the next buffer to send,
+                                   see gst_multi_handle_sink_client_get_bufpos() */
   gint flushcount;              /* the remaining number of buffers to flush out or -1 if the 
                                    client is not flushing. */
 
@@ -181,6 +182,12 @@ gint
 gst_multi_handle_sink_new_client_position (GstMultiHandleSink * sink,
     GstMultiHandleClient * client);
 
+GstBuffer * gst_multi_handle_sink_get_buffer (GstMultiHandleSink * sink, gint pos);
+gint gst_multi_handle_sink_client_get_bufpos (GstMultiHandleSink * sink,
+    GstMultiHandleClient * client);
+void gst_multi_handle_sink_client_set_bufpos (GstMultiHandleSink * sink,
+    GstMultiHandleClient * client, gint bufpos);
+
 /**
  * GstMultiHandleSink:
  *
@@ -204,7 +211,13 @@ struct _GstMultiHandleSink {
 
   gint qos_dscp;
 
-  GArray *bufqueue;     /* global queue of buffers */
+  /* global queue of buffers, a ring indexed by buffer sequence number */
+  GstBuffer **bufqueue;
+  GstCaps **bufcaps;    /* caps the buffers were queued with, shared by all
+                           clients sending the buffer */
+  guint bufqueue_size;  /* allocated size, a power of 2 */
+  gint bufqueue_len;    /* number of queued buffers */
+  guint64 bufqueue_seq; /* sequence number of the next buffer to queue */
 
   gboolean running;     /* the thread state */
   GThread *thread;      /* the sender thread */
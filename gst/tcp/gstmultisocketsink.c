@@ -843,7 +843,7 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
   do {
     if (!mhclient->sending) {
       /* client is not working on a buffer */
-      if (mhclient->bufpos == -1) {
+      if (gst_multi_handle_sink_client_get_bufpos (mhsink, mhclient) == -1) {
         /* client is too fast, remove from write queue until new buffer is
          * available */
         gst_multi_socket_sink_stop_sending (sink, client);
@@ -867,7 +867,8 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
           if (position >= 0) {
             /* we got a valid spot in the queue */
             mhclient->new_connection = FALSE;
-            mhclient->bufpos = position;
+            gst_multi_handle_sink_client_set_bufpos (mhsink, mhclient,
+                position);
           } else {
             /* cannot send data to this client yet */
             gst_multi_socket_sink_stop_sending (sink, client);
@@ -880,8 +881,9 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
           goto flushed;
 
         /* grab buffer */
-        buf = g_array_index (mhsink->bufqueue, GstBuffer *, mhclient->bufpos);
-        mhclient->bufpos--;
+        buf = gst_multi_handle_sink_get_buffer (mhsink,
+            gst_multi_handle_sink_client_get_bufpos (mhsink, mhclient));
+        mhclient->bufseq++;
 
         /* update stats */
         timestamp = GST_BUFFER_TIMESTAMP (buf);
@@ -895,7 +897,8 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
           mhclient->flushcount--;
 
         GST_LOG_OBJECT (sink, "%s client %p at position %d",
-            mhclient->debug, client, mhclient->bufpos);
+            mhclient->debug, client,
+            gst_multi_handle_sink_client_get_bufpos (mhsink, mhclient));
 
         /* queueing a buffer will ref it */
         mhsinkclass->client_queue_buffer (mhsink, mhclient, buf);
@@ -63,6 +63,11 @@ enum
   PROP_PORT
 };
 
+/* max number of memory chunks and bytes we send with one
+ * g_socket_send_message() */
+#define MAX_VECTORS             64
+#define MAX_VECTORED_BYTES      (256 * 1024)
+
 static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
     GST_PAD_ALWAYS,
@@ -74,6 +79,8 @@ static gboolean gst_tcp_client_sink_setcaps (GstBaseSink * bsink,
     GstCaps * caps);
 static GstFlowReturn gst_tcp_client_sink_render (GstBaseSink * bsink,
     GstBuffer * buf);
+static GstFlowReturn gst_tcp_client_sink_render_list (GstBaseSink * bsink,
+    GstBufferList * list);
 static gboolean gst_tcp_client_sink_start (GstBaseSink * bsink);
 static gboolean gst_tcp_client_sink_stop (GstBaseSink * bsink);
 static gboolean gst_tcp_client_sink_unlock (GstBaseSink * bsink);
@@ -126,6 +133,7 @@ gst_tcp_client_sink_class_init (GstTCPClientSinkClass * klass)
   gstbasesink_class->stop = gst_tcp_client_sink_stop;
   gstbasesink_class->set_caps = gst_tcp_client_sink_setcaps;
   gstbasesink_class->render = gst_tcp_client_sink_render;
+  gstbasesink_class->render_list = gst_tcp_client_sink_render_list;
   gstbasesink_class->unlock = gst_tcp_client_sink_unlock;
   gstbasesink_class->unlock_stop = gst_tcp_client_sink_unlock_stop;
 
@@ -169,44 +177,60 @@ gst_tcp_client_sink_setcaps (GstBaseSink * bsink, GstCaps * caps)
   return TRUE;
 }
 
+/* send the mapped memory in @maps with as few g_socket_send_message() calls
+ * as possible and unmap it */
 static GstFlowReturn
-gst_tcp_client_sink_render (GstBaseSink * bsink, GstBuffer * buf)
+gst_tcp_client_sink_send_vectors (GstTCPClientSink * sink, GstMapInfo * maps,
+    guint n_maps, gsize size)
 {
-  GstTCPClientSink *sink;
-  GstMapInfo map;
+  GOutputVector vecs[MAX_VECTORS];
+  GOutputVector *vec = vecs;
+  guint i, n_vecs = n_maps;
   gsize written = 0;
   gssize rret;
   GError *err = NULL;
+  GstFlowReturn ret = GST_FLOW_OK;
 
-  sink = GST_TCP_CLIENT_SINK (bsink);
-
-  g_return_val_if_fail (GST_OBJECT_FLAG_IS_SET (sink, GST_TCP_CLIENT_SINK_OPEN),
-      GST_FLOW_FLUSHING);
+  for (i = 0; i < n_maps; i++) {
+    vecs[i].buffer = maps[i].data;
+    vecs[i].size = maps[i].size;
+  }
 
-  gst_buffer_map (buf, &map, GST_MAP_READ);
-  GST_LOG_OBJECT (sink, "writing %" G_GSIZE_FORMAT " bytes for buffer data",
-      map.size);
+  GST_LOG_OBJECT (sink, "writing %" G_GSIZE_FORMAT " bytes in %u vectors",
+      size, n_maps);
 
   /* write buffer data */
-  while (written < map.size) {
+  while (written < size) {
     rret =
-        g_socket_send (sink->socket, (gchar *) map.data + written,
-        map.size - written, sink->cancellable, &err);
+        g_socket_send_message (sink->socket, NULL, vec, n_vecs, NULL, 0, 0,
+        sink->cancellable, &err);
     if (rret < 0)
       goto write_error;
     written += rret;
+
+    /* skip what was written */
+    while (n_vecs > 0 && rret >= vec->size) {
+      rret -= vec->size;
+      vec++;
+      n_vecs--;
+    }
+    if (n_vecs > 0) {
+      vec->buffer = (const guint8 *) vec->buffer + rret;
+      vec->size -= rret;
+    }
   }
-  gst_buffer_unmap (buf, &map);
 
   sink->data_written += written;
 
-  return GST_FLOW_OK;
+done:
+  for (i = 0; i < n_maps; i++)
+    gst_memory_unmap (maps[i].memory, &maps[i]);
+
+  return ret;
 
   /* ERRORS */
 write_error:
   {
-    GstFlowReturn ret;
-
     if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
       ret = GST_FLOW_FLUSHING;
       GST_DEBUG_OBJECT (sink, "Cancelled reading from socket");
@@ -214,15 +238,104 @@ write_error:
       GST_ELEMENT_ERROR (sink, RESOURCE, WRITE,
           (_("Error while sending data to \"%s:%d\"."), sink->host, sink->port),
           ("Only %" G_GSIZE_FORMAT " of %" G_GSIZE_FORMAT " bytes written: %s",
-              written, map.size, err->message));
+              written, size, err->message));
       ret = GST_FLOW_ERROR;
     }
-    gst_buffer_unmap (buf, &map);
     g_clear_error (&err);
-    return ret;
+    goto done;
+  }
+}
+
+/* map the memory of @buf after the *@n_maps already mapped chunks in @maps,
+ * sending the collected chunks first when the limits are reached */
+static GstFlowReturn
+gst_tcp_client_sink_add_buffer (GstTCPClientSink * sink, GstBuffer * buf,
+    GstMapInfo * maps, guint * n_maps, gsize * size)
+{
+  guint i, n_mem;
+  GstFlowReturn ret;
+
+  n_mem = gst_buffer_n_memory (buf);
+  for (i = 0; i < n_mem; i++) {
+    GstMemory *mem = gst_buffer_peek_memory (buf, i);
+
+    if (*n_maps == MAX_VECTORS || *size >= MAX_VECTORED_BYTES) {
+      ret = gst_tcp_client_sink_send_vectors (sink, maps, *n_maps, *size);
+      *n_maps = 0;
+      *size = 0;
+      if (ret != GST_FLOW_OK)
+        return ret;
+    }
+
+    if (!gst_memory_map (mem, &maps[*n_maps], GST_MAP_READ))
+      goto map_failed;
+
+    *size += maps[*n_maps].size;
+    (*n_maps)++;
+  }
+  return GST_FLOW_OK;
+
+  /* ERRORS */
+map_failed:
+  {
+    GST_ELEMENT_ERROR (sink, RESOURCE, READ, (NULL),
+        ("Failed to map memory %u of buffer %" GST_PTR_FORMAT, i, buf));
+    for (i = 0; i < *n_maps; i++)
+      gst_memory_unmap (maps[i].memory, &maps[i]);
+    *n_maps = 0;
+    *size = 0;
+    return GST_FLOW_ERROR;
   }
 }
 
+/* buffers are sent without merging their memory, all the pending chunks of a
+ * buffer list are coalesced into one vectored send up to the limits */
+static GstFlowReturn
+gst_tcp_client_sink_render (GstBaseSink * bsink, GstBuffer * buf)
+{
+  GstTCPClientSink *sink;
+  GstMapInfo maps[MAX_VECTORS];
+  guint n_maps = 0;
+  gsize size = 0;
+  GstFlowReturn ret;
+
+  sink = GST_TCP_CLIENT_SINK (bsink);
+
+  g_return_val_if_fail (GST_OBJECT_FLAG_IS_SET (sink, GST_TCP_CLIENT_SINK_OPEN),
+      GST_FLOW_FLUSHING);
+
+  ret = gst_tcp_client_sink_add_buffer (sink, buf, maps, &n_maps, &size);
+  if (ret == GST_FLOW_OK && n_maps > 0)
+    ret = gst_tcp_client_sink_send_vectors (sink, maps, n_maps, size);
+
+  return ret;
+}
+
+static GstFlowReturn
+gst_tcp_client_sink_render_list (GstBaseSink * bsink, GstBufferList * list)
+{
+  GstTCPClientSink *sink;
+  GstMapInfo maps[MAX_VECTORS];
+  guint i, len, n_maps = 0;
+  gsize size = 0;
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  sink = GST_TCP_CLIENT_SINK (bsink);
+
+  g_return_val_if_fail (GST_OBJECT_FLAG_IS_SET (sink, GST_TCP_CLIENT_SINK_OPEN),
+      GST_FLOW_FLUSHING);
+
+  len = gst_buffer_list_length (list);
+  for (i = 0; i < len && ret == GST_FLOW_OK; i++) {
+    ret = gst_tcp_client_sink_add_buffer (sink, gst_buffer_list_get (list, i),
+        maps, &n_maps, &size);
+  }
+  if (ret == GST_FLOW_OK && n_maps > 0)
+    ret = gst_tcp_client_sink_send_vectors (sink, maps, n_maps, size);
+
+  return ret;
+}
+
 static void
 gst_tcp_client_sink_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec)
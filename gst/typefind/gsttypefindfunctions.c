@@ -40,12 +40,20 @@
 #include <string.h>
 #include <ctype.h>
 
+#if defined (__AVX2__)
+#include <immintrin.h>
+#elif defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include <gst/pbutils/pbutils.h>
 #include <gst/base/gstbytereader.h>
 
 GST_DEBUG_CATEGORY_STATIC (type_find_debug);
 #define GST_CAT_DEFAULT type_find_debug
 
+static gboolean signature_index_claims_data (GstTypeFind * tf);
+
 /* DataScanCtx: helper for typefind functions that scan through data
  * step-by-step, to avoid doing a peek at each and every offset */
 
@@ -118,6 +126,91 @@ data_scan_ctx_memcmp (GstTypeFind * tf, DataScanCtx * c, guint offset,
   return (memcmp (c->data + offset, data, len) == 0);
 }
 
+/* Returns the first 00 00 01 start code starting within the first @len bytes
+ * of @data, or NULL. @data must have @len + 2 bytes available. Most of the
+ * data the scanning typefinders look at is not a start code, so check a
+ * whole vector worth of positions at a time where we can. */
+static inline const guint8 *
+scan_for_start_code (const guint8 * data, gsize len)
+{
+  gsize i = 0;
+
+#if defined (__AVX2__)
+  const __m256i zero = _mm256_setzero_si256 ();
+  const __m256i one = _mm256_set1_epi8 (1);
+
+  for (; i + 32 <= len; i += 32) {
+    __m256i b0 = _mm256_loadu_si256 ((const __m256i *) (data + i));
+    __m256i b1 = _mm256_loadu_si256 ((const __m256i *) (data + i + 1));
+    __m256i b2 = _mm256_loadu_si256 ((const __m256i *) (data + i + 2));
+    guint32 mask;
+
+    mask = _mm256_movemask_epi8 (_mm256_and_si256 (_mm256_and_si256
+            (_mm256_cmpeq_epi8 (b0, zero), _mm256_cmpeq_epi8 (b1, zero)),
+            _mm256_cmpeq_epi8 (b2, one)));
+    if (mask != 0)
+      return data + i + g_bit_nth_lsf (mask, -1);
+  }
+#elif defined (__SSE2__)
+  const __m128i zero = _mm_setzero_si128 ();
+  const __m128i one = _mm_set1_epi8 (1);
+
+  for (; i + 16 <= len; i += 16) {
+    __m128i b0 = _mm_loadu_si128 ((const __m128i *) (data + i));
+    __m128i b1 = _mm_loadu_si128 ((const __m128i *) (data + i + 1));
+    __m128i b2 = _mm_loadu_si128 ((const __m128i *) (data + i + 2));
+    guint32 mask;
+
+    mask = _mm_movemask_epi8 (_mm_and_si128 (_mm_and_si128
+            (_mm_cmpeq_epi8 (b0, zero), _mm_cmpeq_epi8 (b1, zero)),
+            _mm_cmpeq_epi8 (b2, one)));
+    if (mask != 0)
+      return data + i + g_bit_nth_lsf (mask, -1);
+  }
+#endif
+
+  /* no start code can begin at i, i + 1 or i + 2 unless data[i + 2] is 0,
+   * or it is 1 and the start code begins at i */
+  while (i < len) {
+    if (data[i + 2] > 1) {
+      i += 3;
+    } else if (data[i + 2] == 0) {
+      i++;
+    } else if (data[i] == 0 && data[i + 1] == 0) {
+      return data + i;
+    } else {
+      i += 3;
+    }
+  }
+
+  return NULL;
+}
+
+/* Moves @c to the next start code before @max_offset in the data that is
+ * currently available with at least @min_len bytes following it. Returns
+ * FALSE if there is none, in which case @c is moved past all positions that
+ * were checked and the caller needs to ensure data again. */
+static inline gboolean
+data_scan_ctx_skip_to_start_code (GstTypeFind * tf, DataScanCtx * c,
+    gint min_len, guint64 max_offset)
+{
+  const guint8 *sc;
+  guint64 len;
+
+  if (c->size < min_len || c->offset >= max_offset)
+    return FALSE;
+
+  len = MIN (c->size - min_len + 1, max_offset - c->offset);
+  sc = scan_for_start_code (c->data, len);
+  if (sc == NULL) {
+    data_scan_ctx_advance (tf, c, len);
+    return FALSE;
+  }
+
+  data_scan_ctx_advance (tf, c, sc - c->data);
+  return TRUE;
+}
+
 /*** text/plain ***/
 static gboolean xml_check_first_element (GstTypeFind * tf,
     const gchar * element, guint elen, gboolean strict);
@@ -1098,6 +1191,9 @@ aac_type_find (GstTypeFind * tf, gpointer unused)
   GstCaps *best_caps = NULL;
   guint best_count = 0;
 
+  if (signature_index_claims_data (tf))
+    return;
+
   while (c.offset < AAC_AMOUNT) {
     guint snc, len, offset, i;
 
@@ -1560,6 +1656,9 @@ mp3_type_find (GstTypeFind * tf, gpointer unused)
   guint layer, mid_layer;
   guint64 length;
 
+  if (signature_index_claims_data (tf))
+    return;
+
   mp3_type_find_at_offset (tf, 0, &layer, &prob);
   length = gst_type_find_get_length (tf);
 
@@ -1711,6 +1810,9 @@ ac3_type_find (GstTypeFind * tf, gpointer unused)
 {
   DataScanCtx c = { 0, NULL, 0 };
 
+  if (signature_index_claims_data (tf))
+    return;
+
   /* Search for an ac3 frame; not necessarily right at the start, but give it
    * a lower probability if not found right at the start. Check that the
    * frame is followed by a second frame at the expected offset.
@@ -1878,6 +1980,9 @@ dts_type_find (GstTypeFind * tf, gpointer unused)
 {
   DataScanCtx c = { 0, NULL, 0 };
 
+  if (signature_index_claims_data (tf))
+    return;
+
   /* Search for an dts frame; not necessarily right at the start, but give it
    * a lower probability if not found right at the start. Check that the
    * frame is followed by a second frame at the expected offset. */
@@ -2293,6 +2398,9 @@ mpeg_sys_type_find (GstTypeFind * tf, gpointer unused)
   }
   G_STMT_END;
 
+  if (signature_index_claims_data (tf))
+    return;
+
   data0 = data;
   first_sync = NULL;
 
@@ -2349,6 +2457,32 @@ mpeg_sys_type_find (GstTypeFind * tf, gpointer unused)
     since_last_sync++;
     data++;
 
+    /* Unless we're in the middle of a possible sync word, jump to the next
+     * one. The bytes in between would only be shifted through sync_word */
+    if ((sync_word & 0xffffff) != 0x000001 && data < end) {
+      const guint8 *from, *sc;
+
+      if ((sync_word & 0xffff) == 0x0000)
+        from = data - 2;
+      else if ((sync_word & 0xff) == 0x00)
+        from = data - 1;
+      else
+        from = data;
+
+      sc = NULL;
+      if (end - from >= 3)
+        sc = scan_for_start_code (from, end - from - 2);
+
+      if (sc == NULL) {
+        since_last_sync += end - data;
+        data = end;
+      } else {
+        since_last_sync += sc + 3 - data;
+        data = sc + 3;
+        sync_word = 0x000001;
+      }
+    }
+
     /* If we have found MAX headers, and *some* were pes headers (pack headers
      * are optional in an mpeg system stream) then return our high-probability
      * result */
@@ -2456,6 +2590,9 @@ mpeg_ts_type_find (GstTypeFind * tf, gpointer unused)
   guint size = 0;
   guint64 skipped = 0;
 
+  if (signature_index_claims_data (tf))
+    return;
+
   while (skipped < GST_MPEGTS_TYPEFIND_SCAN_LENGTH) {
     if (size < MPEGTS_HDR_SIZE) {
       data = gst_type_find_peek (tf, skipped, GST_MPEGTS_TYPEFIND_SYNC_SIZE);
@@ -2464,7 +2601,18 @@ mpeg_ts_type_find (GstTypeFind * tf, gpointer unused)
       size = GST_MPEGTS_TYPEFIND_SYNC_SIZE;
     }
 
-    /* Have at least MPEGTS_HDR_SIZE bytes at this point */
+    /* Have at least MPEGTS_HDR_SIZE bytes at this point. Jump straight to
+     * the next sync byte, memchr() is a lot faster than looping here */
+    if (data[0] != 0x47) {
+      const guint8 *sync = memchr (data, 0x47, size);
+      guint skip = (sync != NULL) ? sync - data : size;
+
+      data += skip;
+      skipped += skip;
+      size -= skip;
+      continue;
+    }
+
     if (IS_MPEGTS_HEADER (data)) {
       gint p;
 
@@ -2507,16 +2655,15 @@ static gboolean
 mpeg_find_next_header (GstTypeFind * tf, DataScanCtx * c,
     guint64 max_extra_offset)
 {
-  guint64 extra_offset;
+  guint64 max_offset = c->offset + max_extra_offset + 1;
 
-  for (extra_offset = 0; extra_offset <= max_extra_offset; ++extra_offset) {
+  while (c->offset < max_offset) {
     if (!data_scan_ctx_ensure_data (tf, c, 4))
       return FALSE;
-    if (IS_MPEG_HEADER (c->data)) {
+    if (data_scan_ctx_skip_to_start_code (tf, c, 4, max_offset)) {
       data_scan_ctx_advance (tf, c, 3);
       return TRUE;
     }
-    data_scan_ctx_advance (tf, c, 1);
   }
   return FALSE;
 }
@@ -2545,6 +2692,9 @@ mpeg4_video_type_find (GstTypeFind * tf, gpointer unused)
   guint num_vop_headers = 0;
   guint8 sc;
 
+  if (signature_index_claims_data (tf))
+    return;
+
   while (c.offset < GST_MPEGVID_TYPEFIND_TRY_SYNC) {
     if (num_vop_headers >= GST_MPEGVID_TYPEFIND_TRY_PICTURES)
       break;
@@ -2666,6 +2816,9 @@ h263_video_type_find (GstTypeFind * tf, gpointer unused)
   guint bad = 0;
   guint pc_type, pb_mode;
 
+  if (signature_index_claims_data (tf))
+    return;
+
   while (c.offset < H263_MAX_PROBE_LENGTH) {
     if (G_UNLIKELY (!data_scan_ctx_ensure_data (tf, &c, 4)))
       break;
@@ -2731,68 +2884,71 @@ h264_video_type_find (GstTypeFind * tf, gpointer unused)
   int good = 0;
   int bad = 0;
 
+  if (signature_index_claims_data (tf))
+    return;
+
   while (c.offset < H264_MAX_PROBE_LENGTH) {
     if (G_UNLIKELY (!data_scan_ctx_ensure_data (tf, &c, 4)))
       break;
 
-    if (IS_MPEG_HEADER (c.data)) {
-      nut = c.data[3] & 0x9f;   /* forbiden_zero_bit | nal_unit_type */
-      ref = c.data[3] & 0x60;   /* nal_ref_idc */
+    if (!data_scan_ctx_skip_to_start_code (tf, &c, 4, H264_MAX_PROBE_LENGTH))
+      continue;
 
-      /* if forbidden bit is different to 0 won't be h264 */
-      if (nut > 0x1f) {
-        bad++;
-        break;
-      }
+    nut = c.data[3] & 0x9f;   /* forbiden_zero_bit | nal_unit_type */
+    ref = c.data[3] & 0x60;   /* nal_ref_idc */
 
-      /* collect statistics about the NAL types */
-      if ((nut >= 1 && nut <= 13) || nut == 19) {
-        if ((nut == 5 && ref == 0) ||
-            ((nut == 6 || (nut >= 9 && nut <= 12)) && ref != 0)) {
-          bad++;
-        } else {
-          if (nut == 7)
-            seen_sps = TRUE;
-          else if (nut == 8)
-            seen_pps = TRUE;
-          else if (nut == 5)
-            seen_idr = TRUE;
+    /* if forbidden bit is different to 0 won't be h264 */
+    if (nut > 0x1f) {
+      bad++;
+      break;
+    }
 
+    /* collect statistics about the NAL types */
+    if ((nut >= 1 && nut <= 13) || nut == 19) {
+      if ((nut == 5 && ref == 0) ||
+          ((nut == 6 || (nut >= 9 && nut <= 12)) && ref != 0)) {
+        bad++;
+      } else {
+        if (nut == 7)
+          seen_sps = TRUE;
+        else if (nut == 8)
+          seen_pps = TRUE;
+        else if (nut == 5)
+          seen_idr = TRUE;
+
+        good++;
+      }
+    } else if (nut >= 14 && nut <= 33) {
+      if (nut == 15) {
+        seen_ssps = TRUE;
+        good++;
+      } else if (nut == 14 || nut == 20) {
+        /* Sometimes we see NAL 14 or 20 without SSPS
+         * if dropped into the middle of a stream -
+         * just ignore those (don't add to bad count) */
+        if (seen_ssps)
           good++;
-        }
-      } else if (nut >= 14 && nut <= 33) {
-        if (nut == 15) {
-          seen_ssps = TRUE;
-          good++;
-        } else if (nut == 14 || nut == 20) {
-          /* Sometimes we see NAL 14 or 20 without SSPS
-           * if dropped into the middle of a stream -
-           * just ignore those (don't add to bad count) */
-          if (seen_ssps)
-            good++;
-        } else {
-          /* reserved */
-          /* Theoretically these are good, since if they exist in the
-             stream it merely means that a newer backwards-compatible
-             h.264 stream.  But we should be identifying that separately. */
-          bad++;
-        }
       } else {
-        /* unspecified, application specific */
-        /* don't consider these bad */
+        /* reserved */
+        /* Theoretically these are good, since if they exist in the
+           stream it merely means that a newer backwards-compatible
+           h.264 stream.  But we should be identifying that separately. */
+        bad++;
       }
+    } else {
+      /* unspecified, application specific */
+      /* don't consider these bad */
+    }
 
-      GST_LOG ("good:%d, bad:%d, pps:%d, sps:%d, idr:%d ssps:%d", good, bad,
-          seen_pps, seen_sps, seen_idr, seen_ssps);
-
-      if (seen_sps && seen_pps && seen_idr && good >= 10 && bad < 4) {
-        gst_type_find_suggest (tf, GST_TYPE_FIND_LIKELY, H264_VIDEO_CAPS);
-        return;
-      }
+    GST_LOG ("good:%d, bad:%d, pps:%d, sps:%d, idr:%d ssps:%d", good, bad,
+        seen_pps, seen_sps, seen_idr, seen_ssps);
 
-      data_scan_ctx_advance (tf, &c, 4);
+    if (seen_sps && seen_pps && seen_idr && good >= 10 && bad < 4) {
+      gst_type_find_suggest (tf, GST_TYPE_FIND_LIKELY, H264_VIDEO_CAPS);
+      return;
     }
-    data_scan_ctx_advance (tf, &c, 1);
+
+    data_scan_ctx_advance (tf, &c, 5);
   }
 
   GST_LOG ("good:%d, bad:%d, pps:%d, sps:%d, idr:%d ssps=%d", good, bad,
@@ -2828,64 +2984,67 @@ h265_video_type_find (GstTypeFind * tf, gpointer unused)
   int good = 0;
   int bad = 0;
 
+  if (signature_index_claims_data (tf))
+    return;
+
   while (c.offset < H265_MAX_PROBE_LENGTH) {
     if (G_UNLIKELY (!data_scan_ctx_ensure_data (tf, &c, 5)))
       break;
 
-    if (IS_MPEG_HEADER (c.data)) {
-      /* forbiden_zero_bit | nal_unit_type */
-      nut = c.data[3] & 0xfe;
+    if (!data_scan_ctx_skip_to_start_code (tf, &c, 5, H265_MAX_PROBE_LENGTH))
+      continue;
 
-      /* if forbidden bit is different to 0 won't be h265 */
-      if (nut > 0x7e) {
-        bad++;
-        break;
-      }
-      nut = nut >> 1;
+    /* forbiden_zero_bit | nal_unit_type */
+    nut = c.data[3] & 0xfe;
 
-      /* if nuh_layer_id is not zero or nuh_temporal_id_plus1 is zero then
-       * it won't be h265 */
-      if ((c.data[3] & 0x01) || (c.data[4] & 0xf8) || !(c.data[4] & 0x07)) {
-        bad++;
-        break;
-      }
+    /* if forbidden bit is different to 0 won't be h265 */
+    if (nut > 0x7e) {
+      bad++;
+      break;
+    }
+    nut = nut >> 1;
 
-      /* collect statistics about the NAL types */
-      if ((nut >= 0 && nut <= 9) || (nut >= 16 && nut <= 21) || (nut >= 32
-              && nut <= 40)) {
-        if (nut == 32)
-          seen_vps = TRUE;
-        else if (nut == 33)
-          seen_sps = TRUE;
-        else if (nut == 34)
-          seen_pps = TRUE;
-        else if (nut >= 16 && nut <= 21) {
-          /* BLA, IDR and CRA pictures are belongs to be IRAP picture */
-          /* we are not counting the reserved IRAP pictures (22 and 23) to good */
-          seen_irap = TRUE;
-        }
+    /* if nuh_layer_id is not zero or nuh_temporal_id_plus1 is zero then
+     * it won't be h265 */
+    if ((c.data[3] & 0x01) || (c.data[4] & 0xf8) || !(c.data[4] & 0x07)) {
+      bad++;
+      break;
+    }
 
-        good++;
-      } else if ((nut >= 10 && nut <= 15) || (nut >= 22 && nut <= 31)
-          || (nut >= 41 && nut <= 47)) {
-        /* reserved values are counting as bad */
-        bad++;
-      } else {
-        /* unspecified (48..63), application specific */
-        /* don't consider these as bad */
+    /* collect statistics about the NAL types */
+    if ((nut >= 0 && nut <= 9) || (nut >= 16 && nut <= 21) || (nut >= 32
+            && nut <= 40)) {
+      if (nut == 32)
+        seen_vps = TRUE;
+      else if (nut == 33)
+        seen_sps = TRUE;
+      else if (nut == 34)
+        seen_pps = TRUE;
+      else if (nut >= 16 && nut <= 21) {
+        /* BLA, IDR and CRA pictures are belongs to be IRAP picture */
+        /* we are not counting the reserved IRAP pictures (22 and 23) to good */
+        seen_irap = TRUE;
       }
 
-      GST_LOG ("good:%d, bad:%d, pps:%d, sps:%d, vps:%d, irap:%d", good, bad,
-          seen_pps, seen_sps, seen_vps, seen_irap);
+      good++;
+    } else if ((nut >= 10 && nut <= 15) || (nut >= 22 && nut <= 31)
+        || (nut >= 41 && nut <= 47)) {
+      /* reserved values are counting as bad */
+      bad++;
+    } else {
+      /* unspecified (48..63), application specific */
+      /* don't consider these as bad */
+    }
 
-      if (seen_sps && seen_pps && seen_irap && good >= 10 && bad < 4) {
-        gst_type_find_suggest (tf, GST_TYPE_FIND_LIKELY, H265_VIDEO_CAPS);
-        return;
-      }
+    GST_LOG ("good:%d, bad:%d, pps:%d, sps:%d, vps:%d, irap:%d", good, bad,
+        seen_pps, seen_sps, seen_vps, seen_irap);
 
-      data_scan_ctx_advance (tf, &c, 5);
+    if (seen_sps && seen_pps && seen_irap && good >= 10 && bad < 4) {
+      gst_type_find_suggest (tf, GST_TYPE_FIND_LIKELY, H265_VIDEO_CAPS);
+      return;
     }
-    data_scan_ctx_advance (tf, &c, 1);
+
+    data_scan_ctx_advance (tf, &c, 6);
   }
 
   GST_LOG ("good:%d, bad:%d, pps:%d, sps:%d, vps:%d, irap:%d", good, bad,
@@ -2922,6 +3081,9 @@ mpeg_video_stream_type_find (GstTypeFind * tf, gpointer unused)
   guint num_pic_headers = 0;
   gint found = 0;
 
+  if (signature_index_claims_data (tf))
+    return;
+
   while (c.offset < GST_MPEGVID_TYPEFIND_TRY_SYNC) {
     if (found >= GST_MPEGVID_TYPEFIND_TRY_PICTURES)
       break;
@@ -5585,6 +5747,92 @@ sw_data_destroy (GstTypeFindData * sw_data)
   g_slice_free (GstTypeFindData, sw_data);
 }
 
+/* Prefix index over the fixed offset 0 signatures registered with
+ * TYPE_FIND_REGISTER_START_WITH and TYPE_FIND_REGISTER_RIFF, keyed by the
+ * first byte of the signature (RIFF types have a chain of their own, keyed
+ * by the fourcc at offset 8). It is filled from plugin_init() and read-only
+ * afterwards.
+ *
+ * Only signatures that are suggested with GST_TYPE_FIND_MAXIMUM end up in
+ * the index: data that starts with one of those is going to be claimed by
+ * that typefinder no matter what, so the typefinders that scan through the
+ * first kilobytes of data looking for sync words don't need to bother. */
+#define SIGNATURE_INDEX_MAX_ENTRIES 64
+
+typedef struct
+{
+  const guint8 *data;
+  guint size;
+  guint next;                   /* 1-based index of next entry, 0 ends chain */
+} SignatureIndexEntry;
+
+static SignatureIndexEntry signature_index[SIGNATURE_INDEX_MAX_ENTRIES];
+static guint signature_index_len;
+static guint signature_index_heads[256];
+static guint signature_index_riff_head;
+
+static void
+signature_index_add (const guint8 * data, guint size, gboolean riff)
+{
+  SignatureIndexEntry *entry;
+  guint *head;
+
+  g_return_if_fail (signature_index_len < SIGNATURE_INDEX_MAX_ENTRIES);
+
+  head = riff ? &signature_index_riff_head : &signature_index_heads[data[0]];
+
+  entry = &signature_index[signature_index_len++];
+  entry->data = data;
+  entry->size = size;
+  entry->next = *head;
+  *head = signature_index_len;
+}
+
+static gboolean
+signature_index_match (GstTypeFind * tf, guint head, guint offset)
+{
+  const SignatureIndexEntry *entry;
+  const guint8 *data;
+
+  while (head != 0) {
+    entry = &signature_index[head - 1];
+    data = gst_type_find_peek (tf, offset, entry->size);
+    if (data != NULL && memcmp (data, entry->data, entry->size) == 0) {
+      GST_LOG ("data starts with a signature of %u bytes", entry->size);
+      return TRUE;
+    }
+    head = entry->next;
+  }
+
+  return FALSE;
+}
+
+static gboolean
+signature_index_claims_data (GstTypeFind * tf)
+{
+  const guint8 *data;
+  guint8 first;
+
+  data = gst_type_find_peek (tf, 0, 1);
+  if (data == NULL)
+    return FALSE;
+
+  first = data[0];
+
+  if (signature_index_heads[first] != 0 &&
+      signature_index_match (tf, signature_index_heads[first], 0))
+    return TRUE;
+
+  if (first == 'R' || first == 'A') {
+    data = gst_type_find_peek (tf, 0, 12);
+    if (data != NULL && (memcmp (data, "RIFF", 4) == 0 ||
+            memcmp (data, "AVF0", 4) == 0))
+      return signature_index_match (tf, signature_index_riff_head, 8);
+  }
+
+  return FALSE;
+}
+
 #define TYPE_FIND_REGISTER_START_WITH(plugin,name,rank,ext,_data,_size,_probability)\
 G_BEGIN_DECLS{                                                          \
   GstTypeFindData *sw_data = g_slice_new (GstTypeFindData);             \
@@ -5596,6 +5844,8 @@ G_BEGIN_DECLS{                                                          \
                      ext, sw_data->caps, sw_data,                       \
                      (GDestroyNotify) (sw_data_destroy))) {             \
     sw_data_destroy (sw_data);                                          \
+  } else if (_probability == GST_TYPE_FIND_MAXIMUM) {                   \
+    signature_index_add ((const guint8 *) _data, _size, FALSE);         \
   }                                                                     \
 }G_END_DECLS
 
@@ -5625,6 +5875,8 @@ G_BEGIN_DECLS{                                                          \
                       ext, sw_data->caps, sw_data,                      \
                       (GDestroyNotify) (sw_data_destroy))) {            \
     sw_data_destroy (sw_data);                                          \
+  } else {                                                              \
+    signature_index_add ((const guint8 *) _data, 4, TRUE);              \
   }                                                                     \
 }G_END_DECLS
 
@@ -419,6 +419,124 @@ GST_START_TEST (test_appsrc_caps_in_push_modes)
 
 GST_END_TEST;
 
+#define N_ORDER_BUFFERS 2000
+
+static gpointer
+push_ordered_buffers (GstAppSrc * src)
+{
+  guint i;
+
+  for (i = 0; i < N_ORDER_BUFFERS; i++) {
+    GstBuffer *buffer = gst_buffer_new_allocate (NULL, 4, NULL);
+
+    GST_BUFFER_OFFSET (buffer) = i;
+    fail_unless_equals_int (gst_app_src_push_buffer (src, buffer),
+        GST_FLOW_OK);
+  }
+  fail_unless_equals_int (gst_app_src_end_of_stream (src), GST_FLOW_OK);
+
+  return NULL;
+}
+
+/* Push many small buffers through appsrc and appsink with tiny queues so that
+ * both sides of both queues have to wait for each other, and check that
+ * nothing is lost or reordered */
+GST_START_TEST (test_appsrc_block_ordering)
+{
+  GstElement *pipeline, *src, *sink;
+  GstSample *sample;
+  GThread *thread;
+  guint64 expected = 0;
+
+  pipeline = gst_parse_launch ("appsrc name=src block=1 max-bytes=64 "
+      "format=time ! appsink name=sink sync=false max-buffers=4", NULL);
+  fail_unless (pipeline != NULL);
+  src = gst_bin_get_by_name (GST_BIN (pipeline), "src");
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+
+  ASSERT_SET_STATE (pipeline, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  thread = g_thread_new ("appsrc-push", (GThreadFunc) push_ordered_buffers,
+      src);
+
+  while ((sample = gst_app_sink_pull_sample (GST_APP_SINK (sink)))) {
+    GstBuffer *buffer = gst_sample_get_buffer (sample);
+
+    fail_unless_equals_uint64 (GST_BUFFER_OFFSET (buffer), expected);
+    expected++;
+    gst_sample_unref (sample);
+  }
+  fail_unless (gst_app_sink_is_eos (GST_APP_SINK (sink)));
+  fail_unless_equals_uint64 (expected, N_ORDER_BUFFERS);
+
+  g_thread_join (thread);
+
+  ASSERT_SET_STATE (pipeline, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  gst_object_unref (src);
+  gst_object_unref (sink);
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_appsrc_push_buffer_list)
+{
+  GstElement *pipeline, *src, *sink;
+  GstBufferList *list;
+  GPtrArray *samples;
+  guint64 expected = 0;
+  guint i;
+
+  pipeline = gst_parse_launch ("appsrc name=src format=time ! "
+      "appsink name=sink sync=false", NULL);
+  fail_unless (pipeline != NULL);
+  src = gst_bin_get_by_name (GST_BIN (pipeline), "src");
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+
+  ASSERT_SET_STATE (pipeline, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  list = gst_buffer_list_new ();
+  for (i = 0; i < 10; i++) {
+    GstBuffer *buffer = gst_buffer_new_allocate (NULL, 4, NULL);
+
+    GST_BUFFER_OFFSET (buffer) = i;
+    gst_buffer_list_add (list, buffer);
+  }
+  fail_unless_equals_int (gst_app_src_push_buffer_list (GST_APP_SRC (src),
+          list), GST_FLOW_OK);
+  fail_unless_equals_int (gst_app_src_end_of_stream (GST_APP_SRC (src)),
+      GST_FLOW_OK);
+
+  /* drain in batches of at most 4 samples */
+  while ((samples = gst_app_sink_pull_samples (GST_APP_SINK (sink), 4,
+              GST_CLOCK_TIME_NONE))) {
+    fail_unless (samples->len > 0 && samples->len <= 4);
+    for (i = 0; i < samples->len; i++) {
+      GstBuffer *buffer =
+          gst_sample_get_buffer (g_ptr_array_index (samples, i));
+
+      fail_unless_equals_uint64 (GST_BUFFER_OFFSET (buffer), expected);
+      expected++;
+    }
+    g_ptr_array_unref (samples);
+  }
+  fail_unless (gst_app_sink_is_eos (GST_APP_SINK (sink)));
+  fail_unless_equals_uint64 (expected, 10);
+
+  /* no more buffers accepted after EOS */
+  list = gst_buffer_list_new ();
+  gst_buffer_list_add (list, gst_buffer_new_allocate (NULL, 4, NULL));
+  fail_unless_equals_int (gst_app_src_push_buffer_list (GST_APP_SRC (src),
+          list), GST_FLOW_EOS);
+
+  ASSERT_SET_STATE (pipeline, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  gst_object_unref (src);
+  gst_object_unref (sink);
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
 static Suite *
 appsrc_suite (void)
 {
@@ -428,6 +546,8 @@ appsrc_suite (void)
   tcase_add_test (tc_chain, test_appsrc_non_null_caps);
   tcase_add_test (tc_chain, test_appsrc_set_caps_twice);
   tcase_add_test (tc_chain, test_appsrc_caps_in_push_modes);
+  tcase_add_test (tc_chain, test_appsrc_block_ordering);
+  tcase_add_test (tc_chain, test_appsrc_push_buffer_list);
 
   if (RUNNING_ON_VALGRIND)
     tcase_add_loop_test (tc_chain, test_appsrc_block_deadlock, 0, 5);
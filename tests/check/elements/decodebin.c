@@ -441,11 +441,15 @@ gst_fake_h264_parser_sink_chain (GstPad * pad, GstObject * parent,
   return ret;
 }
 
+static gint num_h264_parser_instances = 0;
+
 static void
 gst_fake_h264_parser_init (GstFakeH264Parser * self)
 {
   GstPad *pad;
 
+  num_h264_parser_instances++;
+
   pad =
       gst_pad_new_from_template (gst_element_class_get_pad_template
       (GST_ELEMENT_GET_CLASS (self), "sink"), "sink");
@@ -533,11 +537,15 @@ gst_fake_h264_decoder_sink_chain (GstPad * pad, GstObject * parent,
   return ret;
 }
 
+static gint num_h264_decoder_instances = 0;
+
 static void
 gst_fake_h264_decoder_init (GstFakeH264Decoder * self)
 {
   GstPad *pad;
 
+  num_h264_decoder_instances++;
+
   pad =
       gst_pad_new_from_template (gst_element_class_get_pad_template
       (GST_ELEMENT_GET_CLASS (self), "sink"), "sink");
@@ -617,6 +625,91 @@ GST_START_TEST (test_parser_negotiation)
 
 GST_END_TEST;
 
+static void
+recycle_pad_added_cb (GstElement * dec, GstPad * pad, gpointer user_data)
+{
+  GstBin *pipe = user_data;
+  GstElement *sink;
+  GstPad *sinkpad;
+
+  sink = gst_element_factory_make ("fakesink", "sink");
+  gst_bin_add (pipe, sink);
+  gst_element_sync_state_with_parent (sink);
+  sinkpad = gst_element_get_static_pad (sink, "sink");
+  gst_pad_link (pad, sinkpad);
+  gst_object_unref (sinkpad);
+}
+
+/* make sure that the parser and decoder of the first run are reused for the
+ * second run instead of new instances being created */
+GST_START_TEST (test_recycle_elements)
+{
+  GstStateChangeReturn sret;
+  GstMessage *msg;
+  GstCaps *caps;
+  GstElement *pipe, *src, *filter, *dec, *sink;
+  gint i;
+
+  gst_element_register (NULL, "fakeh264parse", GST_RANK_PRIMARY + 101,
+      gst_fake_h264_parser_get_type ());
+  gst_element_register (NULL, "fakeh264dec", GST_RANK_PRIMARY + 100,
+      gst_fake_h264_decoder_get_type ());
+
+  num_h264_parser_instances = 0;
+  num_h264_decoder_instances = 0;
+
+  pipe = gst_pipeline_new (NULL);
+
+  src = gst_element_factory_make ("fakesrc", NULL);
+  fail_unless (src != NULL);
+  g_object_set (G_OBJECT (src), "num-buffers", 5, "sizetype", 2, "filltype", 2,
+      "can-activate-pull", FALSE, NULL);
+
+  filter = gst_element_factory_make ("capsfilter", NULL);
+  fail_unless (filter != NULL);
+  caps = gst_caps_from_string ("video/x-h264");
+  g_object_set (G_OBJECT (filter), "caps", caps, NULL);
+  gst_caps_unref (caps);
+
+  dec = gst_element_factory_make ("decodebin", NULL);
+  fail_unless (dec != NULL);
+  g_object_set (dec, "recycle-elements", TRUE, NULL);
+
+  g_signal_connect (dec, "pad-added",
+      G_CALLBACK (recycle_pad_added_cb), pipe);
+
+  gst_bin_add_many (GST_BIN (pipe), src, filter, dec, NULL);
+  gst_element_link_many (src, filter, dec, NULL);
+
+  for (i = 0; i < 2; i++) {
+    sret = gst_element_set_state (pipe, GST_STATE_PLAYING);
+    fail_unless_equals_int (sret, GST_STATE_CHANGE_ASYNC);
+
+    /* wait for EOS or error */
+    msg = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipe),
+        GST_CLOCK_TIME_NONE, GST_MESSAGE_ERROR | GST_MESSAGE_EOS);
+    fail_unless (msg != NULL);
+    fail_unless (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_EOS);
+    gst_message_unref (msg);
+
+    gst_element_set_state (pipe, GST_STATE_READY);
+
+    sink = gst_bin_get_by_name (GST_BIN (pipe), "sink");
+    fail_unless (sink != NULL);
+    gst_bin_remove (GST_BIN (pipe), sink);
+    gst_element_set_state (sink, GST_STATE_NULL);
+    gst_object_unref (sink);
+  }
+
+  fail_unless_equals_int (num_h264_parser_instances, 1);
+  fail_unless_equals_int (num_h264_decoder_instances, 1);
+
+  gst_element_set_state (pipe, GST_STATE_NULL);
+  gst_object_unref (pipe);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_buffering_aggregation)
 {
   GstElement *pipe, *decodebin;
@@ -721,6 +814,7 @@ decodebin_suite (void)
   tcase_add_test (tc_chain, test_reuse_without_decoders);
   tcase_add_test (tc_chain, test_mp3_parser_loop);
   tcase_add_test (tc_chain, test_parser_negotiation);
+  tcase_add_test (tc_chain, test_recycle_elements);
   tcase_add_test (tc_chain, test_buffering_aggregation);
 
   return s;
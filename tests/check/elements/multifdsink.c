@@ -25,6 +25,7 @@
 #endif
 
 #include <gst/check/gstcheck.h>
+#include <gst/allocators/gstfdmemory.h>
 
 static GstPad *mysrcpad;
 
@@ -946,13 +947,315 @@ GST_START_TEST (test_client_kick)
 
 GST_END_TEST;
 
-/* FIXME: add test simulating chained oggs where:
- * sync-method is burst-on-connect
- * (when multifdsink actually does burst-on-connect based on byte size, not
-   "last keyframe" which any frame for audio :))
- * an old client still needs to read from before the new streamheaders
- * a new client gets the new streamheaders
+/* keep more buffers than fit in the initial buffer queue and let the queue
+ * wrap around before a client bursts from it */
+GST_START_TEST (test_burst_client_queue_wrap)
+{
+  GstElement *sink;
+  GstCaps *caps;
+  int pfd[2];
+  gint i;
+  guint buffers_queued;
+
+  sink = setup_multifdsink ();
+  /* keep at least 40 buffers of 16 bytes */
+  g_object_set (sink, "bytes-min", 640, NULL);
+
+  fail_if (pipe (pfd) == -1);
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  caps = gst_caps_from_string ("application/x-gst-check");
+  gst_check_setup_events (mysrcpad, sink, caps, GST_FORMAT_BYTES);
+
+  for (i = 0; i < 100; i++) {
+    GstBuffer *buffer = gst_new_buffer (i);
+
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  g_object_get (sink, "buffers-queued", &buffers_queued, NULL);
+  fail_unless (buffers_queued >= 40);
+
+  /* burst 50 bytes, we get 4 buffers since the max allows it */
+  g_signal_emit_by_name (sink, "add_full", pfd[1], 3,
+      GST_FORMAT_BYTES, (guint64) 50, GST_FORMAT_BYTES, (guint64) 200);
+  fail_unless_num_handles (sink, 1);
+
+  fail_unless (gst_pad_push (mysrcpad, gst_new_buffer (100)) == GST_FLOW_OK);
+
+  for (i = 97; i <= 100; i++) {
+    gchar ref[16];
+
+    g_snprintf (ref, 16, "deadbee%08x", i);
+    fail_unless_read ("client", pfd[0], 16, ref);
+  }
+
+  GST_DEBUG ("cleaning up multifdsink");
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_multifdsink (sink);
+
+  ASSERT_CAPS_REFCOUNT (caps, "caps", 1);
+  gst_caps_unref (caps);
+}
+
+GST_END_TEST;
+
+/* burst buffers made of two memory chunks to a client in vectored mode */
+GST_START_TEST (test_vectored_client)
+{
+  GstElement *sink;
+  GstCaps *caps;
+  int pfd[2];
+  gint i;
+
+  sink = setup_multifdsink ();
+  g_object_set (sink, "vectored", TRUE, NULL);
+  g_object_set (sink, "bytes-min", 160, NULL);
+
+  fail_if (pipe (pfd) == -1);
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  caps = gst_caps_from_string ("application/x-gst-check");
+  gst_check_setup_events (mysrcpad, sink, caps, GST_FORMAT_BYTES);
+
+  for (i = 0; i < 11; i++) {
+    GstBuffer *buffer = gst_new_buffer (i);
+    GstBuffer *head, *tail;
+
+    head = gst_buffer_copy_region (buffer, GST_BUFFER_COPY_MEMORY, 0, 8);
+    tail = gst_buffer_copy_region (buffer, GST_BUFFER_COPY_MEMORY, 8, 8);
+    gst_buffer_unref (buffer);
+    buffer = gst_buffer_append (head, tail);
+    fail_unless (gst_buffer_n_memory (buffer) == 2);
+
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+
+    /* add the client before the last buffer, it gets a burst of 4 buffers
+     * since the max allows it */
+    if (i == 9) {
+      g_signal_emit_by_name (sink, "add_full", pfd[1], 3,
+          GST_FORMAT_BYTES, (guint64) 50, GST_FORMAT_BYTES, (guint64) 200);
+    }
+  }
+
+  for (i = 7; i <= 10; i++) {
+    gchar ref[16];
+
+    g_snprintf (ref, 16, "deadbee%08x", i);
+    fail_unless_read ("client", pfd[0], 16, ref);
+  }
+
+  GST_DEBUG ("cleaning up multifdsink");
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_multifdsink (sink);
+
+  ASSERT_CAPS_REFCOUNT (caps, "caps", 1);
+  gst_caps_unref (caps);
+}
+
+GST_END_TEST;
+
+#ifdef __linux__
+/* send a part of a file backed memory with sendfile() */
+GST_START_TEST (test_sendfile_client)
+{
+  GstElement *sink;
+  GstCaps *caps;
+  GstAllocator *alloc;
+  GstBuffer *buffer, *region;
+  GstStructure *stats;
+  guint64 sent;
+  gchar *path;
+  int pfd[2];
+  int fd;
+
+  sink = setup_multifdsink ();
+  g_object_set (sink, "sendfile", TRUE, NULL);
+
+  fail_if (pipe (pfd) == -1);
+  fd = g_file_open_tmp ("multifdsink-XXXXXX", &path, NULL);
+  fail_if (fd == -1);
+  fail_unless (write (fd, "0123456789abcdefghijklmnopqrstuv", 32) == 32);
+
+  alloc = gst_fd_allocator_new ();
+  buffer = gst_buffer_new ();
+  gst_buffer_append_memory (buffer, gst_fd_allocator_alloc (alloc, fd, 32,
+          GST_FD_MEMORY_FLAG_DONT_CLOSE));
+  region = gst_buffer_copy_region (buffer, GST_BUFFER_COPY_MEMORY, 8, 16);
+  gst_buffer_unref (buffer);
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  g_signal_emit_by_name (sink, "add", pfd[1]);
+
+  caps = gst_caps_from_string ("application/x-gst-check");
+  gst_check_setup_events (mysrcpad, sink, caps, GST_FORMAT_BYTES);
+  fail_unless (gst_pad_push (mysrcpad, region) == GST_FLOW_OK);
+
+  fail_unless_read ("client", pfd[0], 16, "89abcdefghijklmn");
+  wait_bytes_served (sink, 16);
+
+  /* all of it went through sendfile(), nothing was mapped and written */
+  g_signal_emit_by_name (sink, "get-stats", pfd[1], &stats);
+  fail_unless (gst_structure_get_uint64 (stats, "bytes-sendfile", &sent));
+  fail_unless_equals_uint64 (sent, 16);
+  gst_structure_free (stats);
+
+  GST_DEBUG ("cleaning up multifdsink");
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_multifdsink (sink);
+
+  ASSERT_CAPS_REFCOUNT (caps, "caps", 1);
+  gst_caps_unref (caps);
+  gst_object_unref (alloc);
+
+  close (fd);
+  unlink (path);
+  g_free (path);
+}
+
+GST_END_TEST;
+#endif
+
+/* test serving many clients through the epoll backend */
+GST_START_TEST (test_epoll_clients)
+{
+  GstElement *sink;
+  GstCaps *caps;
+  int pfd[64][2];
+  gint i, j, num_clients = G_N_ELEMENTS (pfd), num_buffers = 8;
+
+  sink = setup_multifdsink ();
+  g_object_set (sink, "use-epoll", TRUE, NULL);
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  caps = gst_caps_from_string ("application/x-gst-check");
+  gst_check_setup_events (mysrcpad, sink, caps, GST_FORMAT_BYTES);
+
+  for (i = 0; i < num_clients; i++) {
+    fail_if (pipe (pfd[i]) == -1);
+    g_signal_emit_by_name (sink, "add", pfd[i][1]);
+  }
+  fail_unless_num_handles (sink, num_clients);
+
+  for (i = 0; i < num_buffers; i++) {
+    GstBuffer *buffer = gst_buffer_new_and_alloc (16);
+    gchar data[16];
+
+    g_snprintf (data, 16, "deadbee%08x", i);
+    gst_buffer_fill (buffer, 0, data, 16);
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  for (i = 0; i < num_clients; i++) {
+    for (j = 0; j < num_buffers; j++) {
+      gchar ref[16];
+
+      g_snprintf (ref, 16, "deadbee%08x", j);
+      fail_unless_read ("client", pfd[i][0], 16, ref);
+    }
+  }
+  fail_unless_num_handles (sink, num_clients);
+
+  GST_DEBUG ("cleaning up multifdsink");
+  for (i = 0; i < num_clients; i++) {
+    g_signal_emit_by_name (sink, "remove", pfd[i][1]);
+    fail_unless (close (pfd[i][1]) == 0);
+    fail_unless_eof ("client", pfd[i][0]);
+    close (pfd[i][0]);
+  }
+
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_multifdsink (sink);
+
+  ASSERT_CAPS_REFCOUNT (caps, "caps", 1);
+  gst_caps_unref (caps);
+}
+
+GST_END_TEST;
+
+/* this test simulates chained oggs:
+ * - set streamheader caps and push buffers
+ * - change the streamheader caps and push more buffers
+ * - add a client that bursts from before the caps change
+ * - verify that the client first gets the old streamheader with the old
+ *   buffers, and then the new streamheader with the new buffers
  */
+GST_START_TEST (test_burst_client_changed_streamheader)
+{
+  GstElement *sink;
+  GstBuffer *hbuf1, *hbuf2;
+  GstCaps *caps1, *caps2;
+  int pfd[2];
+  gint i;
+  gchar ref[16];
+
+  sink = setup_multifdsink ();
+  g_object_set (sink, "bytes-min", 100, NULL);
+
+  fail_if (pipe (pfd) == -1);
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  gst_multifdsink_create_streamheader ("first", "header", &hbuf1, &hbuf2,
+      &caps1);
+  gst_check_setup_events (mysrcpad, sink, caps1, GST_FORMAT_BYTES);
+  fail_unless (gst_pad_push (mysrcpad, hbuf1) == GST_FLOW_OK);
+  fail_unless (gst_pad_push (mysrcpad, hbuf2) == GST_FLOW_OK);
+  gst_buffer_unref (hbuf1);
+  gst_buffer_unref (hbuf2);
+
+  for (i = 0; i < 2; i++)
+    fail_unless (gst_pad_push (mysrcpad, gst_new_buffer (i)) == GST_FLOW_OK);
+
+  /* change the streamheader while the old buffers are still queued */
+  gst_multifdsink_create_streamheader ("second", "header", &hbuf1, &hbuf2,
+      &caps2);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_caps (caps2)));
+  fail_unless (gst_pad_push (mysrcpad, hbuf1) == GST_FLOW_OK);
+  fail_unless (gst_pad_push (mysrcpad, hbuf2) == GST_FLOW_OK);
+  gst_buffer_unref (hbuf1);
+  gst_buffer_unref (hbuf2);
+
+  fail_unless (gst_pad_push (mysrcpad, gst_new_buffer (2)) == GST_FLOW_OK);
+
+  /* burst 50 bytes, we get 4 buffers since the max allows it, so the client
+   * starts at the first buffer queued with the old caps */
+  g_signal_emit_by_name (sink, "add_full", pfd[1], 3,
+      GST_FORMAT_BYTES, (guint64) 50, GST_FORMAT_BYTES, (guint64) 200);
+  fail_unless_num_handles (sink, 1);
+
+  fail_unless (gst_pad_push (mysrcpad, gst_new_buffer (3)) == GST_FLOW_OK);
+
+  fail_unless_read ("client", pfd[0], 5, "first");
+  fail_unless_read ("client", pfd[0], 6, "header");
+  for (i = 0; i < 2; i++) {
+    g_snprintf (ref, 16, "deadbee%08x", i);
+    fail_unless_read ("client", pfd[0], 16, ref);
+  }
+  fail_unless_read ("client", pfd[0], 6, "second");
+  fail_unless_read ("client", pfd[0], 6, "header");
+  for (i = 2; i < 4; i++) {
+    g_snprintf (ref, 16, "deadbee%08x", i);
+    fail_unless_read ("client", pfd[0], 16, ref);
+  }
+
+  GST_DEBUG ("cleaning up multifdsink");
+  g_signal_emit_by_name (sink, "remove", pfd[1]);
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_multifdsink (sink);
+
+  ASSERT_CAPS_REFCOUNT (caps1, "caps1", 1);
+  gst_caps_unref (caps1);
+  ASSERT_CAPS_REFCOUNT (caps2, "caps2", 1);
+  gst_caps_unref (caps2);
+}
+
+GST_END_TEST;
+
 static Suite *
 multifdsink_suite (void)
 {
@@ -968,8 +1271,15 @@ multifdsink_suite (void)
   tcase_add_test (tc_chain, test_burst_client_bytes);
   tcase_add_test (tc_chain, test_burst_client_bytes_keyframe);
   tcase_add_test (tc_chain, test_burst_client_bytes_with_keyframe);
+  tcase_add_test (tc_chain, test_burst_client_queue_wrap);
+  tcase_add_test (tc_chain, test_burst_client_changed_streamheader);
   tcase_add_test (tc_chain, test_client_next_keyframe);
   tcase_add_test (tc_chain, test_client_kick);
+  tcase_add_test (tc_chain, test_vectored_client);
+#ifdef __linux__
+  tcase_add_test (tc_chain, test_sendfile_client);
+#endif
+  tcase_add_test (tc_chain, test_epoll_clients);
 
   return s;
 }
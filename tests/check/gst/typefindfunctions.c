@@ -477,6 +477,69 @@ GST_START_TEST (test_manifest_typefinding)
 
 GST_END_TEST;
 
+/* data that starts with a signature must still be claimed by that signature,
+ * even if what follows looks like something the scanning typefinders like */
+GST_START_TEST (test_signature_prefix)
+{
+  GstTypeFindProbability prob;
+  const gchar *type;
+  GstCaps *caps;
+  guint8 *data;
+  gint i;
+
+  data = g_malloc0 (TEST_RANDOM_DATA_SIZE);
+  memcpy (data, "RIFF\000\000\000\000WAVEfmt ", 16);
+  for (i = 188; i + 188 <= TEST_RANDOM_DATA_SIZE; i += 188) {
+    data[i] = 0x47;
+    data[i + 1] = 0x40;
+    data[i + 3] = 0x10;
+  }
+
+  prob = 0;
+  caps = typefind_data (data, TEST_RANDOM_DATA_SIZE, &prob);
+  fail_unless (caps != NULL);
+  type = gst_structure_get_name (gst_caps_get_structure (caps, 0));
+  fail_unless_equals_string (type, "audio/x-wav");
+  fail_unless_equals_int (prob, GST_TYPE_FIND_MAXIMUM);
+  gst_caps_unref (caps);
+
+  g_free (data);
+}
+
+GST_END_TEST;
+
+/* start codes are found even if there's a lot of junk in front of them */
+GST_START_TEST (test_h264_junk_prefix)
+{
+  const guint8 nal_types[] = { 0x67, 0x68, 0x65 };
+  GstTypeFindProbability prob;
+  const gchar *type;
+  GstCaps *caps;
+  guint8 *data;
+  gint i, j;
+
+  data = g_malloc (TEST_RANDOM_DATA_SIZE * 4);
+  memset (data, 0xaa, TEST_RANDOM_DATA_SIZE * 4);
+
+  for (i = 0, j = 3000; i < 12; ++i, j += 16) {
+    data[j] = data[j + 1] = data[j + 2] = 0x00;
+    data[j + 3] = 0x01;
+    data[j + 4] = nal_types[i % G_N_ELEMENTS (nal_types)];
+  }
+
+  prob = 0;
+  caps = typefind_data (data, TEST_RANDOM_DATA_SIZE * 4, &prob);
+  fail_unless (caps != NULL);
+  type = gst_structure_get_name (gst_caps_get_structure (caps, 0));
+  fail_unless_equals_string (type, "video/x-h264");
+  fail_unless_equals_int (prob, GST_TYPE_FIND_LIKELY);
+  gst_caps_unref (caps);
+
+  g_free (data);
+}
+
+GST_END_TEST;
+
 static Suite *
 typefindfunctions_suite (void)
 {
@@ -494,6 +557,8 @@ typefindfunctions_suite (void)
   tcase_add_test (tc_chain, test_random_data);
   tcase_add_test (tc_chain, test_hls_m3u8);
   tcase_add_test (tc_chain, test_manifest_typefinding);
+  tcase_add_test (tc_chain, test_signature_prefix);
+  tcase_add_test (tc_chain, test_h264_junk_prefix);
 
   return s;
 }
@@ -29,6 +29,7 @@
 
 #include <gst/audio/audio.h>
 #include <string.h>
+#include <math.h>
 
 static GstBuffer *
 make_buffer (guint8 ** _data)
@@ -705,6 +706,379 @@ GST_START_TEST (test_fill_silence)
 
 GST_END_TEST;
 
+static void
+fill_sine (GstAudioFormat format, gpointer data, gint samples)
+{
+  gint i;
+
+  for (i = 0; i < samples; i++) {
+    gdouble v = 0.8 * sin (2.0 * G_PI * 440.0 * i / 44100.0);
+
+    switch (format) {
+      case GST_AUDIO_FORMAT_S16:
+        ((gint16 *) data)[i] = v * G_MAXINT16;
+        break;
+      case GST_AUDIO_FORMAT_S32:
+        ((gint32 *) data)[i] = v * G_MAXINT32;
+        break;
+      case GST_AUDIO_FORMAT_F32:
+        ((gfloat *) data)[i] = v;
+        break;
+      case GST_AUDIO_FORMAT_F64:
+        ((gdouble *) data)[i] = v;
+        break;
+      default:
+        g_assert_not_reached ();
+    }
+  }
+}
+
+GST_START_TEST (test_audio_resampler_quality)
+{
+  static const GstAudioFormat formats[] = {
+    GST_AUDIO_FORMAT_S16, GST_AUDIO_FORMAT_S32,
+    GST_AUDIO_FORMAT_F32, GST_AUDIO_FORMAT_F64
+  };
+  GTimer *timer;
+  guint i, quality;
+
+#define IN_RATE 44100
+#define OUT_RATE 48000
+#define CHANNELS 2
+#define FRAMES 4096
+/* set to something larger to do benchmarks */
+#define TIME 0.01
+
+  timer = g_timer_new ();
+
+  GST_DEBUG ("samples/sec\tformat\tquality");
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    const GstAudioFormatInfo *finfo = gst_audio_format_get_info (formats[i]);
+    gint bpf = GST_AUDIO_FORMAT_INFO_WIDTH (finfo) / 8 * CHANNELS;
+    gpointer in, out;
+
+    in = g_malloc (FRAMES * bpf);
+    /* the output can be a little larger than the input because of the
+     * latency of the filter */
+    out = g_malloc (2 * FRAMES * bpf);
+    fill_sine (formats[i], in, FRAMES * CHANNELS);
+
+    for (quality = GST_AUDIO_RESAMPLER_QUALITY_MIN;
+        quality <= GST_AUDIO_RESAMPLER_QUALITY_MAX; quality++) {
+      GstAudioResampler *resampler;
+      GstStructure *options;
+      gsize out_frames, total = 0;
+      gdouble elapsed;
+
+      options = gst_structure_new_empty ("GstAudioResampler.options");
+      gst_audio_resampler_options_set_quality
+          (GST_AUDIO_RESAMPLER_METHOD_KAISER, quality, IN_RATE, OUT_RATE,
+          options);
+      resampler = gst_audio_resampler_new (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+          GST_AUDIO_RESAMPLER_FLAG_NONE, formats[i], CHANNELS, IN_RATE,
+          OUT_RATE, options);
+      fail_unless (resampler != NULL);
+      gst_structure_free (options);
+
+      g_timer_start (timer);
+      while (TRUE) {
+        out_frames = gst_audio_resampler_get_out_frames (resampler, FRAMES);
+        fail_unless (out_frames <= 2 * FRAMES);
+        gst_audio_resampler_resample (resampler, &in, FRAMES, &out,
+            out_frames);
+        total += FRAMES;
+
+        elapsed = g_timer_elapsed (timer, NULL);
+        if (elapsed >= TIME)
+          break;
+      }
+      GST_DEBUG ("%f\t%s\t%u", total * CHANNELS / elapsed,
+          GST_AUDIO_FORMAT_INFO_NAME (finfo), quality);
+
+      gst_audio_resampler_free (resampler);
+    }
+    g_free (in);
+    g_free (out);
+  }
+  g_timer_destroy (timer);
+
+#undef IN_RATE
+#undef OUT_RATE
+#undef CHANNELS
+#undef FRAMES
+#undef TIME
+}
+
+GST_END_TEST;
+
+static gsize
+resample_sine (GstAudioFormat format, GstAudioResamplerFilterMode mode,
+    GstAudioResamplerFilterInterpolation interpolation, gpointer in,
+    gsize in_frames, gpointer out, gboolean simd)
+{
+  GstAudioResampler *resampler;
+  GstStructure *options;
+  gsize out_frames;
+
+  options = gst_structure_new_empty ("GstAudioResampler.options");
+  gst_audio_resampler_options_set_quality (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+      GST_AUDIO_RESAMPLER_QUALITY_DEFAULT, 44100, 48000, options);
+  gst_structure_set (options,
+      GST_AUDIO_RESAMPLER_OPT_FILTER_MODE, GST_TYPE_AUDIO_RESAMPLER_FILTER_MODE,
+      mode, GST_AUDIO_RESAMPLER_OPT_FILTER_INTERPOLATION,
+      GST_TYPE_AUDIO_RESAMPLER_FILTER_INTERPOLATION, interpolation,
+      GST_AUDIO_RESAMPLER_OPT_SIMD, G_TYPE_BOOLEAN, simd, NULL);
+  resampler = gst_audio_resampler_new (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+      GST_AUDIO_RESAMPLER_FLAG_NONE, format, 2, 44100, 48000, options);
+  fail_unless (resampler != NULL);
+  gst_structure_free (options);
+
+  out_frames = gst_audio_resampler_get_out_frames (resampler, in_frames);
+  gst_audio_resampler_resample (resampler, &in, in_frames, &out, out_frames);
+  gst_audio_resampler_free (resampler);
+
+  return out_frames;
+}
+
+static gdouble
+get_sample (GstAudioFormat format, gpointer data, gint i)
+{
+  switch (format) {
+    case GST_AUDIO_FORMAT_S16:
+      return ((gint16 *) data)[i] / (gdouble) G_MAXINT16;
+    case GST_AUDIO_FORMAT_S32:
+      return ((gint32 *) data)[i] / (gdouble) G_MAXINT32;
+    case GST_AUDIO_FORMAT_F32:
+      return ((gfloat *) data)[i];
+    case GST_AUDIO_FORMAT_F64:
+      return ((gdouble *) data)[i];
+    default:
+      g_assert_not_reached ();
+      return 0.0;
+  }
+}
+
+/* the SSE, AVX2 and FMA inner products and interpolation functions must
+ * produce the same result as the C versions, within rounding errors */
+GST_START_TEST (test_audio_resampler_simd)
+{
+  static const struct
+  {
+    GstAudioFormat format;
+    gdouble tolerance;
+  } formats[] = {
+    {
+    GST_AUDIO_FORMAT_S16, 3.0 / G_MAXINT16}, {
+    GST_AUDIO_FORMAT_S32, 1e-6}, {
+    GST_AUDIO_FORMAT_F32, 1e-5}, {
+    GST_AUDIO_FORMAT_F64, 1e-10}
+  };
+  static const struct
+  {
+    GstAudioResamplerFilterMode mode;
+    GstAudioResamplerFilterInterpolation interpolation;
+  } modes[] = {
+    {
+    GST_AUDIO_RESAMPLER_FILTER_MODE_FULL,
+          GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_NONE}, {
+    GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED,
+          GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_LINEAR}, {
+    GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED,
+          GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_CUBIC}
+  };
+  guint i, j;
+
+#define FRAMES 1024
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    const GstAudioFormatInfo *finfo =
+        gst_audio_format_get_info (formats[i].format);
+    gint bpf = GST_AUDIO_FORMAT_INFO_WIDTH (finfo) / 8 * 2;
+    gpointer in, out, out_c;
+
+    in = g_malloc (FRAMES * bpf);
+    out = g_malloc (2 * FRAMES * bpf);
+    out_c = g_malloc (2 * FRAMES * bpf);
+    fill_sine (formats[i].format, in, FRAMES * 2);
+
+    for (j = 0; j < G_N_ELEMENTS (modes); j++) {
+      gsize n, n_c, k;
+
+      n = resample_sine (formats[i].format, modes[j].mode,
+          modes[j].interpolation, in, FRAMES, out, TRUE);
+      n_c = resample_sine (formats[i].format, modes[j].mode,
+          modes[j].interpolation, in, FRAMES, out_c, FALSE);
+      fail_unless_equals_int (n, n_c);
+
+      for (k = 0; k < n * 2; k++) {
+        gdouble v = get_sample (formats[i].format, out, k);
+        gdouble v_c = get_sample (formats[i].format, out_c, k);
+
+        if (fabs (v - v_c) > formats[i].tolerance)
+          fail ("%s mode %u sample %" G_GSIZE_FORMAT ": %f != %f",
+              GST_AUDIO_FORMAT_INFO_NAME (finfo), j, k, v, v_c);
+      }
+    }
+    g_free (in);
+    g_free (out);
+    g_free (out_c);
+  }
+
+#undef FRAMES
+}
+
+GST_END_TEST;
+
+static void
+run_threaded_converter (GstAudioInfo * in_info, GstAudioInfo * out_info,
+    guint threads, gpointer in, gsize in_frames, gpointer out,
+    gsize * out_frames, gint n_buffers)
+{
+  GstAudioConverter *convert;
+  gint i;
+
+  convert = gst_audio_converter_new (GST_AUDIO_CONVERTER_FLAG_NONE, in_info,
+      out_info, gst_structure_new ("GstAudioConverter.config",
+          GST_AUDIO_CONVERTER_OPT_THREADS, G_TYPE_UINT, threads, NULL));
+  fail_unless (convert != NULL);
+
+  *out_frames = 0;
+  for (i = 0; i < n_buffers; i++) {
+    gsize frames = gst_audio_converter_get_out_frames (convert, in_frames);
+    gpointer out_ptr = (guint8 *) out + *out_frames * out_info->bpf;
+
+    fail_unless (gst_audio_converter_samples (convert, 0, &in, in_frames,
+            &out_ptr, frames));
+    *out_frames += frames;
+  }
+  gst_audio_converter_free (convert);
+}
+
+GST_START_TEST (test_audio_converter_threads)
+{
+  static const GstAudioChannelPosition surround[] = {
+    GST_AUDIO_CHANNEL_POSITION_FRONT_LEFT,
+    GST_AUDIO_CHANNEL_POSITION_FRONT_RIGHT,
+    GST_AUDIO_CHANNEL_POSITION_FRONT_CENTER,
+    GST_AUDIO_CHANNEL_POSITION_LFE1,
+    GST_AUDIO_CHANNEL_POSITION_REAR_LEFT,
+    GST_AUDIO_CHANNEL_POSITION_REAR_RIGHT
+  };
+  GstAudioInfo in_info, out_info;
+  gpointer in, out_single, out_threaded;
+  gsize frames_single, frames_threaded;
+  gint i;
+
+#define FRAMES 4096
+#define BUFFERS 4
+
+  for (i = 0; i < 2; i++) {
+    if (i == 0) {
+      /* resampling only, channels split over the threads */
+      gst_audio_info_set_format (&in_info, GST_AUDIO_FORMAT_F32, 96000, 16,
+          NULL);
+      gst_audio_info_set_format (&out_info, GST_AUDIO_FORMAT_F32, 48000, 16,
+          NULL);
+    } else {
+      /* channel mixing and resampling */
+      gst_audio_info_set_format (&in_info, GST_AUDIO_FORMAT_S16, 44100, 6,
+          surround);
+      gst_audio_info_set_format (&out_info, GST_AUDIO_FORMAT_S16, 48000, 2,
+          NULL);
+    }
+
+    in = g_malloc (FRAMES * in_info.bpf);
+    fill_sine (GST_AUDIO_INFO_FORMAT (&in_info), in,
+        FRAMES * in_info.channels);
+    out_single = g_malloc0 (2 * BUFFERS * FRAMES * out_info.bpf);
+    out_threaded = g_malloc0 (2 * BUFFERS * FRAMES * out_info.bpf);
+
+    run_threaded_converter (&in_info, &out_info, 1, in, FRAMES, out_single,
+        &frames_single, BUFFERS);
+    run_threaded_converter (&in_info, &out_info, 4, in, FRAMES, out_threaded,
+        &frames_threaded, BUFFERS);
+
+    /* every channel is resampled independently, the result must not depend
+     * on how the channels are split */
+    fail_unless_equals_int (frames_single, frames_threaded);
+    fail_unless (frames_single > 0);
+    fail_unless (memcmp (out_single, out_threaded,
+            frames_single * out_info.bpf) == 0);
+
+    g_free (in);
+    g_free (out_single);
+    g_free (out_threaded);
+  }
+
+#undef FRAMES
+#undef BUFFERS
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_audio_converter_inplace)
+{
+  static const struct
+  {
+    GstAudioFormat in_format;
+    GstAudioFormat out_format;
+    gboolean in_place;
+  } tests[] = {
+    {GST_AUDIO_FORMAT_S16, GST_AUDIO_FORMAT_U16, TRUE},
+    {GST_AUDIO_FORMAT_S32, GST_AUDIO_FORMAT_S24_32, TRUE},
+    {GST_AUDIO_FORMAT_S32, GST_AUDIO_FORMAT_F32, TRUE},
+    {GST_AUDIO_FORMAT_F32, GST_AUDIO_FORMAT_S32, TRUE},
+    {GST_AUDIO_FORMAT_F64, GST_AUDIO_FORMAT_F64, TRUE},
+    {GST_AUDIO_FORMAT_S16, GST_AUDIO_FORMAT_S8, FALSE},
+    {GST_AUDIO_FORMAT_F32, GST_AUDIO_FORMAT_F64, FALSE},
+  };
+  guint i;
+
+#define FRAMES 1024
+#define CHANNELS 2
+
+  for (i = 0; i < G_N_ELEMENTS (tests); i++) {
+    GstAudioInfo in_info, out_info;
+    GstAudioConverter *convert;
+    gpointer in, out, inout;
+
+    gst_audio_info_set_format (&in_info, tests[i].in_format, 44100, CHANNELS,
+        NULL);
+    gst_audio_info_set_format (&out_info, tests[i].out_format, 44100,
+        CHANNELS, NULL);
+
+    convert = gst_audio_converter_new (GST_AUDIO_CONVERTER_FLAG_NONE,
+        &in_info, &out_info, NULL);
+    fail_unless (convert != NULL);
+    fail_unless_equals_int (gst_audio_converter_supports_inplace (convert),
+        tests[i].in_place);
+
+    if (tests[i].in_place) {
+      in = g_malloc (FRAMES * in_info.bpf);
+      fill_sine (tests[i].in_format, in, FRAMES * CHANNELS);
+      inout = g_memdup (in, FRAMES * in_info.bpf);
+      out = g_malloc (FRAMES * out_info.bpf);
+
+      fail_unless (gst_audio_converter_samples (convert, 0, &in, FRAMES,
+              &out, FRAMES));
+      fail_unless (gst_audio_converter_samples (convert, 0, &inout, FRAMES,
+              &inout, FRAMES));
+      fail_unless (memcmp (out, inout, FRAMES * out_info.bpf) == 0);
+
+      g_free (in);
+      g_free (inout);
+      g_free (out);
+    }
+    gst_audio_converter_free (convert);
+  }
+
+#undef FRAMES
+#undef CHANNELS
+}
+
+GST_END_TEST;
+
 static Suite *
 audio_suite (void)
 {
@@ -732,6 +1106,10 @@ audio_suite (void)
   tcase_add_test (tc_chain, test_audio_format_s8);
   tcase_add_test (tc_chain, test_audio_format_u8);
   tcase_add_test (tc_chain, test_fill_silence);
+  tcase_add_test (tc_chain, test_audio_resampler_quality);
+  tcase_add_test (tc_chain, test_audio_resampler_simd);
+  tcase_add_test (tc_chain, test_audio_converter_threads);
+  tcase_add_test (tc_chain, test_audio_converter_inplace);
 
   return s;
 }
@@ -41,6 +41,12 @@ typedef struct _GstAudioEncoderTesterClass GstAudioEncoderTesterClass;
 struct _GstAudioEncoderTester
 {
   GstAudioEncoder parent;
+
+  /* checks that the input is a contiguous byte counter */
+  gboolean check_input;
+  guint64 bytes_in;
+  guint max_n_memory;
+  gboolean input_corrupted;
 };
 
 struct _GstAudioEncoderTesterClass
@@ -80,6 +86,7 @@ static GstFlowReturn
 gst_audio_encoder_tester_handle_frame (GstAudioEncoder * enc,
     GstBuffer * buffer)
 {
+  GstAudioEncoderTester *tester = (GstAudioEncoderTester *) enc;
   guint8 *data;
   GstMapInfo map;
   guint64 input_num;
@@ -88,6 +95,25 @@ gst_audio_encoder_tester_handle_frame (GstAudioEncoder * enc,
   if (buffer == NULL)
     return GST_FLOW_OK;
 
+  if (tester->check_input) {
+    gsize i, size = gst_buffer_get_size (buffer);
+
+    data = g_malloc (size);
+    gst_buffer_extract (buffer, 0, data, size);
+    for (i = 0; i < size; i++) {
+      if (data[i] != ((tester->bytes_in + i) & 0xff))
+        tester->input_corrupted = TRUE;
+    }
+    g_free (data);
+
+    tester->bytes_in += size;
+    tester->max_n_memory =
+        MAX (tester->max_n_memory, gst_buffer_n_memory (buffer));
+
+    return gst_audio_encoder_finish_frame (enc,
+        gst_buffer_new_allocate (NULL, 1, NULL), size / 4);
+  }
+
   gst_buffer_map (buffer, &map, GST_MAP_READ);
   input_num = *((guint64 *) map.data);
   gst_buffer_unmap (buffer, &map);
@@ -395,6 +421,59 @@ GST_START_TEST (audioencoder_events_before_eos)
 
 GST_END_TEST;
 
+#define SCATTERED_FRAME_SAMPLES 1000
+#define SCATTERED_BUFFER_SAMPLES 1500
+#define SCATTERED_NUM_BUFFERS 6
+GST_START_TEST (audioencoder_scattered_input)
+{
+  GstHarness *h = setup_audioencodertester ();
+  GstAudioEncoder *enc = GST_AUDIO_ENCODER (h->element);
+  GstAudioEncoderTester *tester = (GstAudioEncoderTester *) h->element;
+  guint64 offset = 0;
+  guint i, j;
+
+  tester->check_input = TRUE;
+  gst_audio_encoder_set_scattered_input (enc, TRUE);
+  fail_unless (gst_audio_encoder_get_scattered_input (enc));
+
+  /* frames don't line up with the input buffers */
+  gst_audio_encoder_set_frame_samples_min (enc, SCATTERED_FRAME_SAMPLES);
+  gst_audio_encoder_set_frame_samples_max (enc, SCATTERED_FRAME_SAMPLES);
+  gst_audio_encoder_set_frame_max (enc, 1);
+
+  for (i = 0; i < SCATTERED_NUM_BUFFERS; i++) {
+    GstBuffer *buffer;
+    GstMapInfo map;
+
+    buffer = gst_buffer_new_allocate (NULL, SCATTERED_BUFFER_SAMPLES * 4,
+        NULL);
+    gst_buffer_map (buffer, &map, GST_MAP_WRITE);
+    for (j = 0; j < map.size; j++)
+      map.data[j] = (offset + j) & 0xff;
+    offset += map.size;
+    gst_buffer_unmap (buffer, &map);
+
+    GST_BUFFER_PTS (buffer) = gst_util_uint64_scale (i,
+        SCATTERED_BUFFER_SAMPLES * GST_SECOND, TEST_AUDIO_RATE);
+    fail_unless_equals_int (gst_harness_push (h, buffer), GST_FLOW_OK);
+  }
+
+  fail_unless (gst_harness_push_event (h, gst_event_new_eos ()));
+
+  /* all samples were handed over in order, and some frames were made of
+   * more than one upstream buffer */
+  fail_unless_equals_uint64 (tester->bytes_in, offset);
+  fail_if (tester->input_corrupted);
+  fail_unless (tester->max_n_memory > 1);
+  fail_unless_equals_int (gst_harness_buffers_in_queue (h),
+      SCATTERED_NUM_BUFFERS * SCATTERED_BUFFER_SAMPLES /
+      SCATTERED_FRAME_SAMPLES);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_audioencoder_suite (void)
 {
@@ -407,6 +486,7 @@ gst_audioencoder_suite (void)
   tcase_add_test (tc, audioencoder_tags_before_eos);
   tcase_add_test (tc, audioencoder_events_before_eos);
   tcase_add_test (tc, audioencoder_flush_events);
+  tcase_add_test (tc, audioencoder_scattered_input);
 
   return s;
 }
@@ -243,6 +243,166 @@ GST_START_TEST (test_disco_missing_plugins)
 
 GST_END_TEST;
 
+static void
+async_workers_discovered_cb (GstDiscoverer * dc, GstDiscovererInfo * info,
+    const GError * err, gint * num_discovered)
+{
+  GST_INFO ("discovered %s, result %d", gst_discoverer_info_get_uri (info),
+      gst_discoverer_info_get_result (info));
+  *num_discovered += 1;
+}
+
+static void
+async_workers_finished_cb (GstDiscoverer * dc, GMainLoop * loop)
+{
+  g_main_loop_quit (loop);
+}
+
+GST_START_TEST (test_disco_async_workers)
+{
+  const gchar *files[] = { "theora-vorbis.ogg", "test.mp3", "test.mkv",
+    "theora-vorbis.ogg", "partialframe.mjpeg", "theora-vorbis.ogg"
+  };
+  GError *err = NULL;
+  GstDiscoverer *dc;
+  GMainLoop *loop;
+  gint num_discovered = 0;
+  gchar *uri, *path;
+  guint workers;
+  int i;
+
+  dc = gst_discoverer_new (5 * GST_SECOND, &err);
+  fail_unless (dc != NULL);
+  fail_unless (err == NULL);
+
+  g_object_set (dc, "workers", 3, NULL);
+  g_object_get (dc, "workers", &workers, NULL);
+  fail_unless_equals_int (workers, 3);
+
+  loop = g_main_loop_new (NULL, FALSE);
+  g_signal_connect (dc, "discovered",
+      G_CALLBACK (async_workers_discovered_cb), &num_discovered);
+  g_signal_connect (dc, "finished", G_CALLBACK (async_workers_finished_cb),
+      loop);
+
+  gst_discoverer_start (dc);
+
+  for (i = 0; i < G_N_ELEMENTS (files); ++i) {
+    path = g_build_filename (GST_TEST_FILES_PATH, files[i], NULL);
+    uri = gst_filename_to_uri (path, &err);
+    g_free (path);
+    fail_unless (err == NULL);
+
+    fail_unless (gst_discoverer_discover_uri_async (dc, uri));
+    g_free (uri);
+  }
+
+  g_main_loop_run (loop);
+  fail_unless_equals_int (num_discovered, G_N_ELEMENTS (files));
+
+  gst_discoverer_stop (dc);
+  g_main_loop_unref (loop);
+  g_object_unref (dc);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_disco_cache)
+{
+  GError *err = NULL;
+  GstDiscoverer *dc;
+  GstDiscovererInfo *info, *cached_info;
+  GList *streams, *cached_streams;
+  gchar *uri, *path;
+
+  if (!have_theora || !have_ogg)
+    return;
+
+  dc = gst_discoverer_new (5 * GST_SECOND, &err);
+  fail_unless (dc != NULL);
+  fail_unless (err == NULL);
+  g_object_set (dc, "use-cache", TRUE, NULL);
+
+  path = g_build_filename (GST_TEST_FILES_PATH, "theora-vorbis.ogg", NULL);
+  uri = gst_filename_to_uri (path, &err);
+  g_free (path);
+  fail_unless (err == NULL);
+
+  /* the first run might or might not come from the cache already, the
+   * second one surely does, and both must have the same information */
+  info = gst_discoverer_discover_uri (dc, uri, &err);
+  fail_unless (info != NULL);
+  fail_unless (err == NULL);
+  fail_unless_equals_int (gst_discoverer_info_get_result (info),
+      GST_DISCOVERER_OK);
+
+  cached_info = gst_discoverer_discover_uri (dc, uri, &err);
+  fail_unless (cached_info != NULL);
+  fail_unless (err == NULL);
+  fail_unless_equals_int (gst_discoverer_info_get_result (cached_info),
+      GST_DISCOVERER_OK);
+
+  fail_unless_equals_string (gst_discoverer_info_get_uri (cached_info), uri);
+  fail_unless_equals_uint64 (gst_discoverer_info_get_duration (cached_info),
+      gst_discoverer_info_get_duration (info));
+
+  streams = gst_discoverer_info_get_stream_list (info);
+  cached_streams = gst_discoverer_info_get_stream_list (cached_info);
+  fail_unless_equals_int (g_list_length (cached_streams),
+      g_list_length (streams));
+  gst_discoverer_stream_info_list_free (cached_streams);
+  gst_discoverer_stream_info_list_free (streams);
+
+  gst_discoverer_info_unref (cached_info);
+  gst_discoverer_info_unref (info);
+  g_free (uri);
+  g_object_unref (dc);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_disco_parse_only)
+{
+  GError *err = NULL;
+  GstDiscoverer *dc;
+  GstDiscovererInfo *info;
+  GList *streams;
+  gchar *uri, *path;
+
+  if (!have_ogg)
+    return;
+
+  dc = gst_discoverer_new (5 * GST_SECOND, &err);
+  fail_unless (dc != NULL);
+  fail_unless (err == NULL);
+  g_object_set (dc, "parse-only", TRUE, NULL);
+
+  path = g_build_filename (GST_TEST_FILES_PATH, "theora-vorbis.ogg", NULL);
+  uri = gst_filename_to_uri (path, &err);
+  g_free (path);
+  fail_unless (err == NULL);
+
+  info = gst_discoverer_discover_uri (dc, uri, &err);
+  fail_unless (info != NULL);
+  fail_unless (err == NULL);
+  fail_unless_equals_int (gst_discoverer_info_get_result (info),
+      GST_DISCOVERER_OK);
+
+  streams = gst_discoverer_info_get_video_streams (info);
+  fail_unless_equals_int (g_list_length (streams), 1);
+  gst_discoverer_stream_info_list_free (streams);
+
+  streams = gst_discoverer_info_get_audio_streams (info);
+  fail_unless_equals_int (g_list_length (streams), 1);
+  gst_discoverer_stream_info_list_free (streams);
+
+  gst_discoverer_info_unref (info);
+  g_free (uri);
+  g_object_unref (dc);
+}
+
+GST_END_TEST;
+
 static Suite *
 discoverer_suite (void)
 {
@@ -262,6 +422,9 @@ discoverer_suite (void)
   tcase_add_test (tc_chain, test_disco_sync_reuse_timeout);
   tcase_add_test (tc_chain, test_disco_missing_plugins);
   tcase_add_test (tc_chain, test_disco_serializing);
+  tcase_add_test (tc_chain, test_disco_async_workers);
+  tcase_add_test (tc_chain, test_disco_cache);
+  tcase_add_test (tc_chain, test_disco_parse_only);
   return s;
 }
 
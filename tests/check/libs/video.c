@@ -2277,6 +2277,123 @@ GST_START_TEST (test_video_scaler)
 
 GST_END_TEST;
 
+static GstVideoScaler *
+make_simd_scaler (GstVideoResamplerMethod method, guint n_taps, guint in_size,
+    guint out_size, gboolean simd)
+{
+  GstVideoScaler *scale;
+  GstStructure *options;
+
+  options = gst_structure_new ("GstVideoScaler",
+      GST_VIDEO_SCALER_OPT_SIMD, G_TYPE_BOOLEAN, simd, NULL);
+  scale = gst_video_scaler_new (method, GST_VIDEO_SCALER_FLAG_NONE, n_taps,
+      in_size, out_size, options);
+  gst_structure_free (options);
+
+  return scale;
+}
+
+static void
+check_scaler_simd (GRand * rand, GstVideoFormat format, guint bpp,
+    GstVideoResamplerMethod method, guint n_taps, guint in_size,
+    guint out_size)
+{
+  GstVideoScaler *simd, *orc;
+  guint8 *src, *dest1, *dest2;
+  gpointer lines[32];
+  guint i, j, width, offset, taps, stride;
+
+  width = MAX (in_size, out_size);
+  stride = width * bpp;
+  src = g_malloc (stride * in_size);
+  dest1 = g_malloc0 (stride);
+  dest2 = g_malloc0 (stride);
+  for (i = 0; i < stride * in_size; i++)
+    src[i] = g_rand_int (rand);
+
+  GST_DEBUG ("%s method %d taps %u %u->%u", gst_video_format_to_string (format),
+      method, n_taps, in_size, out_size);
+
+  /* horizontal, the whole line and from an offset */
+  simd = make_simd_scaler (method, n_taps, in_size, out_size, TRUE);
+  orc = make_simd_scaler (method, n_taps, in_size, out_size, FALSE);
+  gst_video_scaler_horizontal (simd, format, src, dest1, 0, out_size);
+  gst_video_scaler_horizontal (orc, format, src, dest2, 0, out_size);
+  fail_unless (memcmp (dest1, dest2, out_size * bpp) == 0);
+
+  offset = out_size / 3;
+  gst_video_scaler_horizontal (simd, format, src, dest1, offset,
+      out_size - offset);
+  gst_video_scaler_horizontal (orc, format, src, dest2, offset,
+      out_size - offset);
+  fail_unless (memcmp (dest1, dest2, out_size * bpp) == 0);
+  gst_video_scaler_free (simd);
+  gst_video_scaler_free (orc);
+
+  /* vertical, every output line for an odd width */
+  simd = make_simd_scaler (method, n_taps, in_size, out_size, TRUE);
+  orc = make_simd_scaler (method, n_taps, in_size, out_size, FALSE);
+  width = 123;
+  for (i = 0; i < out_size; i++) {
+    gst_video_scaler_get_coeff (simd, i, &offset, &taps);
+    fail_unless (taps <= G_N_ELEMENTS (lines));
+    for (j = 0; j < taps; j++)
+      lines[j] = src + (offset + j) * stride;
+
+    gst_video_scaler_vertical (simd, format, lines, dest1, i, width);
+    gst_video_scaler_vertical (orc, format, lines, dest2, i, width);
+    fail_unless (memcmp (dest1, dest2, width * bpp) == 0);
+  }
+  gst_video_scaler_free (simd);
+  gst_video_scaler_free (orc);
+
+  g_free (src);
+  g_free (dest1);
+  g_free (dest2);
+}
+
+GST_START_TEST (test_video_scaler_simd)
+{
+  static const struct
+  {
+    GstVideoFormat format;
+    guint bpp;
+  } formats[] = {
+    {GST_VIDEO_FORMAT_GRAY8, 1},
+    {GST_VIDEO_FORMAT_NV12, 2},
+    {GST_VIDEO_FORMAT_RGB, 3},
+    {GST_VIDEO_FORMAT_RGBA, 4},
+    {GST_VIDEO_FORMAT_AYUV, 4},
+    {GST_VIDEO_FORMAT_GRAY16_LE, 2},
+    {GST_VIDEO_FORMAT_AYUV64, 8},
+  };
+  static const guint lanczos_taps[] = { 3, 4, 6, 8, 12 };
+  GRand *rand;
+  guint i, j;
+
+  rand = g_rand_new_with_seed (0x5ca1e);
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    GstVideoFormat format = formats[i].format;
+    guint bpp = formats[i].bpp;
+
+    check_scaler_simd (rand, format, bpp, GST_VIDEO_RESAMPLER_METHOD_CUBIC,
+        0, 320, 237);
+    check_scaler_simd (rand, format, bpp, GST_VIDEO_RESAMPLER_METHOD_CUBIC,
+        0, 123, 400);
+
+    for (j = 0; j < G_N_ELEMENTS (lanczos_taps); j++) {
+      check_scaler_simd (rand, format, bpp,
+          GST_VIDEO_RESAMPLER_METHOD_LANCZOS, lanczos_taps[j], 320, 237);
+      check_scaler_simd (rand, format, bpp,
+          GST_VIDEO_RESAMPLER_METHOD_LANCZOS, lanczos_taps[j], 123, 400);
+    }
+  }
+  g_rand_free (rand);
+}
+
+GST_END_TEST;
+
 #define WIDTH 320
 #define HEIGHT 240
 #define TIME 0.01
@@ -2527,6 +2644,377 @@ GST_START_TEST (test_video_convert)
 
 GST_END_TEST;
 
+static GstBuffer *
+convert_tiled_frame (GstVideoInfo * ininfo, GstBuffer * inbuffer,
+    GstVideoInfo * outinfo, guint tile_width, guint n_threads, gint dest_x,
+    GTimer * timer, gdouble * rate)
+{
+  GstVideoFrame inframe, outframe;
+  GstBuffer *outbuffer;
+  GstVideoConverter *convert;
+  gdouble elapsed;
+  gint count;
+
+  outbuffer = gst_buffer_new_and_alloc (outinfo->size);
+  gst_buffer_memset (outbuffer, 0, 0, -1);
+  gst_video_frame_map (&inframe, ininfo, inbuffer, GST_MAP_READ);
+  gst_video_frame_map (&outframe, outinfo, outbuffer, GST_MAP_WRITE);
+
+  convert = gst_video_converter_new (ininfo, outinfo,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
+          GST_TYPE_VIDEO_RESAMPLER_METHOD, GST_VIDEO_RESAMPLER_METHOD_CUBIC,
+          GST_VIDEO_CONVERTER_OPT_TILE_WIDTH, G_TYPE_UINT, tile_width,
+          GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, n_threads,
+          GST_VIDEO_CONVERTER_OPT_DEST_X, G_TYPE_INT, dest_x,
+          GST_VIDEO_CONVERTER_OPT_DEST_WIDTH, G_TYPE_INT,
+          GST_VIDEO_INFO_WIDTH (outinfo) - dest_x, NULL));
+
+  gst_video_converter_frame (convert, &inframe, &outframe);
+
+  if (timer) {
+    count = 0;
+    g_timer_start (timer);
+    while (TRUE) {
+      gst_video_converter_frame (convert, &inframe, &outframe);
+
+      count++;
+      elapsed = g_timer_elapsed (timer, NULL);
+      if (elapsed >= TIME)
+        break;
+    }
+    *rate = count / elapsed;
+  }
+  gst_video_converter_free (convert);
+
+  gst_video_frame_unmap (&outframe);
+  gst_video_frame_unmap (&inframe);
+
+  return outbuffer;
+}
+
+static const struct
+{
+  GstVideoFormat infmt;
+  gint in_width, in_height;
+  GstVideoFormat outfmt;
+  gint out_width, out_height;
+  guint n_threads;
+  gint dest_x;
+} tiled_cases[] = {
+  /* all of these need the generic converter, fast paths are not tiled */
+  {GST_VIDEO_FORMAT_I420, 640, 480, GST_VIDEO_FORMAT_BGRx, 800, 600, 1, 0},
+  {GST_VIDEO_FORMAT_YUY2, 800, 600, GST_VIDEO_FORMAT_Y444, 555, 333, 1, 0},
+  {GST_VIDEO_FORMAT_ARGB, 333, 200, GST_VIDEO_FORMAT_NV16, 640, 360, 1, 0},
+  {GST_VIDEO_FORMAT_v210, 1280, 720, GST_VIDEO_FORMAT_AYUV64, 720, 480, 1, 0},
+  {GST_VIDEO_FORMAT_I420, 1920, 1080, GST_VIDEO_FORMAT_AYUV64, 1920, 1080, 1,
+      0},
+  {GST_VIDEO_FORMAT_I420, 1920, 1080, GST_VIDEO_FORMAT_BGRx, 1280, 720, 1, 0},
+  {GST_VIDEO_FORMAT_I420, 3840, 2160, GST_VIDEO_FORMAT_BGRx, 1920, 1080, 1, 0},
+  {GST_VIDEO_FORMAT_I420, 7680, 4320, GST_VIDEO_FORMAT_BGRx, 3840, 2160, 1, 0},
+  /* subsampled and packed output at odd destination offsets, the tile
+   * boundaries must not split chroma samples or macropixels */
+  {GST_VIDEO_FORMAT_Y444, 800, 600, GST_VIDEO_FORMAT_YUY2, 720, 480, 4, 3},
+  {GST_VIDEO_FORMAT_AYUV, 1280, 720, GST_VIDEO_FORMAT_I420, 1000, 562, 4, 5},
+  {GST_VIDEO_FORMAT_BGRx, 640, 480, GST_VIDEO_FORMAT_Y41B, 960, 540, 3, 7},
+};
+
+GST_START_TEST (test_video_convert_tiled)
+{
+  GTimer *timer;
+  guint i, j;
+
+  timer = g_timer_new ();
+
+  for (i = 0; i < G_N_ELEMENTS (tiled_cases); i++) {
+    GstVideoInfo ininfo, outinfo;
+    GstBuffer *inbuffer, *lines, *tiles;
+    GstMapInfo inmap, lmap, tmap;
+    gdouble lines_sec = 0.0, tiles_sec = 0.0;
+
+    gst_video_info_set_format (&ininfo, tiled_cases[i].infmt,
+        tiled_cases[i].in_width, tiled_cases[i].in_height);
+    inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+    gst_buffer_map (inbuffer, &inmap, GST_MAP_WRITE);
+    for (j = 0; j < inmap.size; j++)
+      inmap.data[j] = (j * 7 + (j >> 9) * 13) & 0xff;
+    gst_buffer_unmap (inbuffer, &inmap);
+
+    gst_video_info_set_format (&outinfo, tiled_cases[i].outfmt,
+        tiled_cases[i].out_width, tiled_cases[i].out_height);
+
+    lines = convert_tiled_frame (&ininfo, inbuffer, &outinfo, 0, 1,
+        tiled_cases[i].dest_x, timer, &lines_sec);
+    tiles = convert_tiled_frame (&ininfo, inbuffer, &outinfo, 256,
+        tiled_cases[i].n_threads, tiled_cases[i].dest_x, timer, &tiles_sec);
+
+    GST_DEBUG ("%s %dx%d -> %s %dx%d: %f lines/sec, %f tiles/sec",
+        gst_video_format_to_string (tiled_cases[i].infmt),
+        tiled_cases[i].in_width, tiled_cases[i].in_height,
+        gst_video_format_to_string (tiled_cases[i].outfmt),
+        tiled_cases[i].out_width, tiled_cases[i].out_height, lines_sec,
+        tiles_sec);
+
+    /* tiled conversion must produce exactly the same pixels */
+    gst_buffer_map (lines, &lmap, GST_MAP_READ);
+    gst_buffer_map (tiles, &tmap, GST_MAP_READ);
+    fail_unless_equals_int (lmap.size, tmap.size);
+    fail_unless (memcmp (lmap.data, tmap.data, lmap.size) == 0);
+    gst_buffer_unmap (tiles, &tmap);
+    gst_buffer_unmap (lines, &lmap);
+
+    gst_buffer_unref (tiles);
+    gst_buffer_unref (lines);
+    gst_buffer_unref (inbuffer);
+  }
+
+  g_timer_destroy (timer);
+}
+
+GST_END_TEST;
+
+static const struct
+{
+  GstVideoFormat infmt;
+  gint in_width, in_height;
+  GstVideoFormat outfmt;
+  gint out_width, out_height;
+} fused_cases[] = {
+  {GST_VIDEO_FORMAT_I420, 640, 480, GST_VIDEO_FORMAT_NV12, 320, 240},
+  {GST_VIDEO_FORMAT_YV12, 640, 480, GST_VIDEO_FORMAT_NV21, 500, 301},
+  {GST_VIDEO_FORMAT_NV12, 1280, 720, GST_VIDEO_FORMAT_I420, 853, 481},
+  {GST_VIDEO_FORMAT_NV21, 1280, 720, GST_VIDEO_FORMAT_I420, 640, 360},
+  {GST_VIDEO_FORMAT_YUY2, 720, 576, GST_VIDEO_FORMAT_I420, 640, 360},
+  {GST_VIDEO_FORMAT_UYVY, 720, 576, GST_VIDEO_FORMAT_YV12, 1023, 767},
+  {GST_VIDEO_FORMAT_RGBA, 1920, 1080, GST_VIDEO_FORMAT_NV12, 1280, 720},
+  {GST_VIDEO_FORMAT_BGRx, 1920, 1080, GST_VIDEO_FORMAT_NV21, 963, 541},
+};
+
+static void
+fill_fused_frame (GstVideoFrame * frame)
+{
+  const guint8 yuv[] = { 0x50, 0x60, 0x70 };
+  gint c, i, j;
+
+  if (GST_VIDEO_INFO_IS_RGB (&frame->info)) {
+    for (i = 0; i < GST_VIDEO_FRAME_HEIGHT (frame); i++)
+      memset ((guint8 *) GST_VIDEO_FRAME_PLANE_DATA (frame, 0) +
+          i * GST_VIDEO_FRAME_PLANE_STRIDE (frame, 0), 0x80,
+          GST_VIDEO_FRAME_WIDTH (frame) * 4);
+    return;
+  }
+
+  for (c = 0; c < 3; c++) {
+    guint8 *d = GST_VIDEO_FRAME_COMP_DATA (frame, c);
+    gint stride = GST_VIDEO_FRAME_COMP_STRIDE (frame, c);
+    gint pstride = GST_VIDEO_FRAME_COMP_PSTRIDE (frame, c);
+
+    for (i = 0; i < GST_VIDEO_FRAME_COMP_HEIGHT (frame, c); i++)
+      for (j = 0; j < GST_VIDEO_FRAME_COMP_WIDTH (frame, c); j++)
+        d[i * stride + j * pstride] = yuv[c];
+  }
+}
+
+GST_START_TEST (test_video_convert_scale_fused)
+{
+  GTimer *timer;
+  guint i;
+
+  timer = g_timer_new ();
+
+  for (i = 0; i < G_N_ELEMENTS (fused_cases); i++) {
+    GstVideoInfo ininfo, outinfo;
+    GstVideoFrame inframe, outframe;
+    GstBuffer *inbuffer, *outbuffer;
+    GstVideoConverter *convert;
+    gdouble elapsed;
+    gint count, c, x, y;
+    guint8 expect[3];
+
+    gst_video_info_set_format (&ininfo, fused_cases[i].infmt,
+        fused_cases[i].in_width, fused_cases[i].in_height);
+    inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+    gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_WRITE);
+    fill_fused_frame (&inframe);
+
+    gst_video_info_set_format (&outinfo, fused_cases[i].outfmt,
+        fused_cases[i].out_width, fused_cases[i].out_height);
+    outbuffer = gst_buffer_new_and_alloc (outinfo.size);
+    gst_buffer_memset (outbuffer, 0, 0, -1);
+    gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
+
+    convert = gst_video_converter_new (&ininfo, &outinfo, NULL);
+
+    count = 0;
+    g_timer_start (timer);
+    while (TRUE) {
+      gst_video_converter_frame (convert, &inframe, &outframe);
+
+      count++;
+      elapsed = g_timer_elapsed (timer, NULL);
+      if (elapsed >= TIME)
+        break;
+    }
+    gst_video_converter_free (convert);
+
+    GST_DEBUG ("%f scale-convert/sec %s %dx%d -> %s %dx%d",
+        count / elapsed, gst_video_format_to_string (fused_cases[i].infmt),
+        fused_cases[i].in_width, fused_cases[i].in_height,
+        gst_video_format_to_string (fused_cases[i].outfmt),
+        fused_cases[i].out_width, fused_cases[i].out_height);
+
+    /* a flat input must give a flat output */
+    if (GST_VIDEO_INFO_IS_RGB (&ininfo)) {
+      /* mid gray in limited range */
+      expect[0] = 126;
+      expect[1] = expect[2] = 128;
+    } else {
+      expect[0] = 0x50;
+      expect[1] = 0x60;
+      expect[2] = 0x70;
+    }
+
+    for (c = 0; c < 3; c++) {
+      guint8 *d = GST_VIDEO_FRAME_COMP_DATA (&outframe, c);
+      gint stride = GST_VIDEO_FRAME_COMP_STRIDE (&outframe, c);
+      gint pstride = GST_VIDEO_FRAME_COMP_PSTRIDE (&outframe, c);
+
+      for (y = 0; y < GST_VIDEO_FRAME_COMP_HEIGHT (&outframe, c); y++) {
+        for (x = 0; x < GST_VIDEO_FRAME_COMP_WIDTH (&outframe, c); x++) {
+          gint v = d[y * stride + x * pstride];
+
+          fail_unless (ABS (v - expect[c]) <= 1,
+              "%s->%s comp %d at %d,%d: %d != %d",
+              gst_video_format_to_string (fused_cases[i].infmt),
+              gst_video_format_to_string (fused_cases[i].outfmt), c, x, y,
+              v, expect[c]);
+        }
+      }
+    }
+
+    gst_video_frame_unmap (&outframe);
+    gst_buffer_unref (outbuffer);
+    gst_video_frame_unmap (&inframe);
+    gst_buffer_unref (inbuffer);
+  }
+
+  g_timer_destroy (timer);
+}
+
+GST_END_TEST;
+
+static void
+fill_gradient_frame (GstVideoFrame * frame)
+{
+  gint c, i, j, w, h;
+
+  for (c = 0; c < GST_VIDEO_FRAME_N_COMPONENTS (frame); c++) {
+    guint8 *d = GST_VIDEO_FRAME_COMP_DATA (frame, c);
+    gint stride = GST_VIDEO_FRAME_COMP_STRIDE (frame, c);
+    gint pstride = GST_VIDEO_FRAME_COMP_PSTRIDE (frame, c);
+
+    w = GST_VIDEO_FRAME_COMP_WIDTH (frame, c);
+    h = GST_VIDEO_FRAME_COMP_HEIGHT (frame, c);
+
+    /* slow ramps in a different direction for each component */
+    for (i = 0; i < h; i++)
+      for (j = 0; j < w; j++)
+        d[i * stride + j * pstride] =
+            32 + (((c & 1 ? w - 1 - j : j) * 96) / w) + ((i * 96) / h);
+  }
+}
+
+static GstBuffer *
+convert_gradient_frame (GstVideoInfo * ininfo, GstBuffer * inbuffer,
+    GstVideoInfo * outinfo, gboolean generic)
+{
+  GstVideoFrame inframe, outframe;
+  GstBuffer *outbuffer;
+  GstVideoConverter *convert;
+  GstStructure *config;
+
+  outbuffer = gst_buffer_new_and_alloc (outinfo->size);
+  gst_buffer_memset (outbuffer, 0, 0, -1);
+  gst_video_frame_map (&inframe, ininfo, inbuffer, GST_MAP_READ);
+  gst_video_frame_map (&outframe, outinfo, outbuffer, GST_MAP_WRITE);
+
+  config = gst_structure_new ("options",
+      GST_VIDEO_CONVERTER_OPT_DITHER_METHOD, GST_TYPE_VIDEO_DITHER_METHOD,
+      GST_VIDEO_DITHER_NONE, NULL);
+  /* fast paths are not used when quantizing, without dithering this does
+   * not change the output */
+  if (generic)
+    gst_structure_set (config, GST_VIDEO_CONVERTER_OPT_DITHER_QUANTIZATION,
+        G_TYPE_UINT, 2, NULL);
+
+  convert = gst_video_converter_new (ininfo, outinfo, config);
+  gst_video_converter_frame (convert, &inframe, &outframe);
+  gst_video_converter_free (convert);
+
+  gst_video_frame_unmap (&outframe);
+  gst_video_frame_unmap (&inframe);
+
+  return outbuffer;
+}
+
+GST_START_TEST (test_video_convert_scale_fused_generic)
+{
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (fused_cases); i++) {
+    GstVideoInfo ininfo, outinfo;
+    GstVideoFrame inframe, fframe, gframe;
+    GstBuffer *inbuffer, *fused, *generic;
+    gint c, x, y;
+
+    gst_video_info_set_format (&ininfo, fused_cases[i].infmt,
+        fused_cases[i].in_width, fused_cases[i].in_height);
+    inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+    gst_buffer_memset (inbuffer, 0, 0xff, -1);
+    gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_WRITE);
+    fill_gradient_frame (&inframe);
+    gst_video_frame_unmap (&inframe);
+
+    gst_video_info_set_format (&outinfo, fused_cases[i].outfmt,
+        fused_cases[i].out_width, fused_cases[i].out_height);
+
+    fused = convert_gradient_frame (&ininfo, inbuffer, &outinfo, FALSE);
+    generic = convert_gradient_frame (&ininfo, inbuffer, &outinfo, TRUE);
+
+    /* the fused paths filter chroma a bit differently, the result must
+     * still be close to the generic converter */
+    gst_video_frame_map (&fframe, &outinfo, fused, GST_MAP_READ);
+    gst_video_frame_map (&gframe, &outinfo, generic, GST_MAP_READ);
+    for (c = 0; c < GST_VIDEO_FRAME_N_COMPONENTS (&fframe); c++) {
+      guint8 *f = GST_VIDEO_FRAME_COMP_DATA (&fframe, c);
+      guint8 *g = GST_VIDEO_FRAME_COMP_DATA (&gframe, c);
+      gint stride = GST_VIDEO_FRAME_COMP_STRIDE (&fframe, c);
+      gint pstride = GST_VIDEO_FRAME_COMP_PSTRIDE (&fframe, c);
+
+      for (y = 0; y < GST_VIDEO_FRAME_COMP_HEIGHT (&fframe, c); y++) {
+        for (x = 0; x < GST_VIDEO_FRAME_COMP_WIDTH (&fframe, c); x++) {
+          gint fv = f[y * stride + x * pstride];
+          gint gv = g[y * stride + x * pstride];
+
+          fail_unless (ABS (fv - gv) <= 6,
+              "%s->%s comp %d at %d,%d: fused %d, generic %d",
+              gst_video_format_to_string (fused_cases[i].infmt),
+              gst_video_format_to_string (fused_cases[i].outfmt), c, x, y,
+              fv, gv);
+        }
+      }
+    }
+    gst_video_frame_unmap (&gframe);
+    gst_video_frame_unmap (&fframe);
+
+    gst_buffer_unref (generic);
+    gst_buffer_unref (fused);
+    gst_buffer_unref (inbuffer);
+  }
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_video_transfer)
 {
   gint i, j;
@@ -2859,9 +3347,13 @@ video_suite (void)
   tcase_add_test (tc_chain, test_video_pack_unpack2);
   tcase_add_test (tc_chain, test_video_chroma);
   tcase_add_test (tc_chain, test_video_scaler);
+  tcase_add_test (tc_chain, test_video_scaler_simd);
   tcase_add_test (tc_chain, test_video_color_convert);
   tcase_add_test (tc_chain, test_video_size_convert);
   tcase_add_test (tc_chain, test_video_convert);
+  tcase_add_test (tc_chain, test_video_convert_tiled);
+  tcase_add_test (tc_chain, test_video_convert_scale_fused);
+  tcase_add_test (tc_chain, test_video_convert_scale_fused_generic);
   tcase_add_test (tc_chain, test_video_transfer);
   tcase_add_test (tc_chain, test_overlay_blend);
   tcase_add_test (tc_chain, test_video_center_rect);
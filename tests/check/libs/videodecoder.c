@@ -79,9 +79,14 @@ struct _GstVideoDecoderTester
 {
   GstVideoDecoder parent;
 
-  guint64 last_buf_num;
-  guint64 last_kf_num;
+  /* handle_frame can run in several frame threads at once */
+  GMutex lock;
+  guint64 last_buf_num;         /* Protected with lock */
+  guint64 last_kf_num;          /* Protected with lock */
   gboolean set_output_state;
+  gboolean hold_frames;
+  gboolean slow_even_frames;
+  guint64 error_frame;
 };
 
 struct _GstVideoDecoderTesterClass
@@ -97,8 +102,10 @@ gst_video_decoder_tester_start (GstVideoDecoder * dec)
 {
   GstVideoDecoderTester *dectester = (GstVideoDecoderTester *) dec;
 
+  g_mutex_lock (&dectester->lock);
   dectester->last_buf_num = -1;
   dectester->last_kf_num = -1;
+  g_mutex_unlock (&dectester->lock);
   dectester->set_output_state = TRUE;
 
   return TRUE;
@@ -115,8 +122,10 @@ gst_video_decoder_tester_flush (GstVideoDecoder * dec)
 {
   GstVideoDecoderTester *dectester = (GstVideoDecoderTester *) dec;
 
+  g_mutex_lock (&dectester->lock);
   dectester->last_buf_num = -1;
   dectester->last_kf_num = -1;
+  g_mutex_unlock (&dectester->lock);
 
   return TRUE;
 }
@@ -146,10 +155,27 @@ gst_video_decoder_tester_handle_frame (GstVideoDecoder * dec,
   gint size;
   GstMapInfo map;
 
+  /* keep the frame pending, the test finishes it later */
+  if (dectester->hold_frames) {
+    gst_video_codec_frame_unref (frame);
+    return GST_FLOW_OK;
+  }
+
   gst_buffer_map (frame->input_buffer, &map, GST_MAP_READ);
 
   input_num = *((guint64 *) map.data);
 
+  /* make frames complete out of order when decoded in parallel */
+  if (dectester->slow_even_frames && input_num % 2 == 0)
+    g_usleep (2000);
+
+  if (input_num == dectester->error_frame) {
+    gst_buffer_unmap (frame->input_buffer, &map);
+    gst_video_decoder_release_frame (dec, frame);
+    return GST_FLOW_ERROR;
+  }
+
+  g_mutex_lock (&dectester->lock);
   if ((input_num == dectester->last_buf_num + 1
           && dectester->last_buf_num != -1)
       || !GST_BUFFER_FLAG_IS_SET (frame->input_buffer,
@@ -169,6 +195,7 @@ gst_video_decoder_tester_handle_frame (GstVideoDecoder * dec,
             GST_BUFFER_FLAG_DELTA_UNIT))
       dectester->last_kf_num = input_num;
   }
+  g_mutex_unlock (&dectester->lock);
 
   gst_buffer_unmap (frame->input_buffer, &map);
 
@@ -178,9 +205,20 @@ gst_video_decoder_tester_handle_frame (GstVideoDecoder * dec,
   return GST_FLOW_OK;
 }
 
+static void
+gst_video_decoder_tester_finalize (GObject * object)
+{
+  GstVideoDecoderTester *dectester = (GstVideoDecoderTester *) object;
+
+  g_mutex_clear (&dectester->lock);
+
+  G_OBJECT_CLASS (gst_video_decoder_tester_parent_class)->finalize (object);
+}
+
 static void
 gst_video_decoder_tester_class_init (GstVideoDecoderTesterClass * klass)
 {
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
   GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
   GstVideoDecoderClass *audiosink_class = GST_VIDEO_DECODER_CLASS (klass);
 
@@ -192,6 +230,8 @@ gst_video_decoder_tester_class_init (GstVideoDecoderTesterClass * klass)
       GST_PAD_SRC, GST_PAD_ALWAYS,
       GST_STATIC_CAPS ("video/x-raw"));
 
+  gobject_class->finalize = gst_video_decoder_tester_finalize;
+
   gst_element_class_add_static_pad_template (element_class, &sink_templ);
   gst_element_class_add_static_pad_template (element_class, &src_templ);
 
@@ -208,6 +248,8 @@ gst_video_decoder_tester_class_init (GstVideoDecoderTesterClass * klass)
 static void
 gst_video_decoder_tester_init (GstVideoDecoderTester * tester)
 {
+  g_mutex_init (&tester->lock);
+  tester->error_frame = -1;
 }
 
 static gboolean
@@ -345,6 +387,221 @@ GST_START_TEST (videodecoder_playback)
 GST_END_TEST;
 
 
+GST_START_TEST (videodecoder_frame_pool)
+{
+  GstSegment segment;
+  GstStructure *stats;
+  guint64 allocated, reused;
+  guint64 i;
+
+  setup_videodecodertester (NULL, NULL);
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (dec, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  /* push a new segment */
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  for (i = 0; i < NUM_BUFFERS; i++) {
+    fail_unless (gst_pad_push (mysrcpad,
+            create_test_buffer (i)) == GST_FLOW_OK);
+  }
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+  fail_unless_equals_int (g_list_length (buffers), NUM_BUFFERS);
+
+  /* every frame is finished right away, so the same frame structure can be
+   * used over and over again */
+  g_object_get (dec, "alloc-stats", &stats, NULL);
+  fail_unless (gst_structure_get_uint64 (stats, "frames-allocated",
+          &allocated));
+  fail_unless (gst_structure_get_uint64 (stats, "frames-reused", &reused));
+  gst_structure_free (stats);
+
+  fail_unless_equals_uint64 (allocated + reused, NUM_BUFFERS);
+  fail_unless (allocated < 10);
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  cleanup_videodecodertest ();
+}
+
+GST_END_TEST;
+
+#define NUM_PARALLEL_BUFFERS 100
+GST_START_TEST (videodecoder_frame_threads)
+{
+  GstSegment segment;
+  GstBuffer *buffer;
+  guint64 i;
+  GList *iter;
+
+  setup_videodecodertester (NULL, NULL);
+  ((GstVideoDecoderTester *) dec)->slow_even_frames = TRUE;
+  gst_video_decoder_set_frame_threads (GST_VIDEO_DECODER (dec), 4);
+  fail_unless_equals_int (gst_video_decoder_get_frame_threads
+      (GST_VIDEO_DECODER (dec)), 4);
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (dec, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  /* push a new segment */
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  /* all buffers are keyframes and get decoded in parallel */
+  for (i = 0; i < NUM_PARALLEL_BUFFERS; i++) {
+    fail_unless (gst_pad_push (mysrcpad,
+            create_test_buffer (i)) == GST_FLOW_OK);
+  }
+
+  /* EOS waits for all frames to be done */
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  /* output is in the input order anyway */
+  fail_unless_equals_int (g_list_length (buffers), NUM_PARALLEL_BUFFERS);
+  i = 0;
+  for (iter = buffers; iter; iter = g_list_next (iter)) {
+    GstMapInfo map;
+
+    buffer = iter->data;
+
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+    fail_unless_equals_uint64 (*(guint64 *) map.data, i);
+    fail_unless (GST_BUFFER_PTS (buffer) == gst_util_uint64_scale_round (i,
+            GST_SECOND * TEST_VIDEO_FPS_D, TEST_VIDEO_FPS_N));
+    gst_buffer_unmap (buffer, &map);
+    i++;
+  }
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  cleanup_videodecodertest ();
+}
+
+GST_END_TEST;
+
+/* errors of the last frames before EOS are not lost */
+GST_START_TEST (videodecoder_frame_threads_error_at_eos)
+{
+  GstSegment segment;
+  GList *iter;
+  guint64 i;
+
+  setup_videodecodertester (NULL, NULL);
+  ((GstVideoDecoderTester *) dec)->error_frame = 7;
+  gst_video_decoder_set_frame_threads (GST_VIDEO_DECODER (dec), 4);
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (dec, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  /* the last frame fails in a frame thread after its buffer was accepted */
+  for (i = 0; i < 8; i++) {
+    fail_unless (gst_pad_push (mysrcpad,
+            create_test_buffer (i)) == GST_FLOW_OK);
+  }
+
+  fail_if (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+  for (iter = events; iter; iter = g_list_next (iter))
+    fail_if (GST_EVENT_TYPE (iter->data) == GST_EVENT_EOS);
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  cleanup_videodecodertest ();
+}
+
+GST_END_TEST;
+
+#define NUM_PENDING_FRAMES 200
+GST_START_TEST (videodecoder_pending_frames)
+{
+  GstSegment segment;
+  GstVideoCodecFrame *frame;
+  GList *frames, *iter;
+  guint i, n;
+
+  setup_videodecodertester (NULL, NULL);
+  ((GstVideoDecoderTester *) dec)->hold_frames = TRUE;
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (dec, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  /* push a new segment */
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  for (i = 0; i < NUM_PENDING_FRAMES; i++) {
+    fail_unless (gst_pad_push (mysrcpad,
+            create_test_buffer (i)) == GST_FLOW_OK);
+  }
+
+  /* all frames are pending, oldest first */
+  frames = gst_video_decoder_get_frames (GST_VIDEO_DECODER (dec));
+  fail_unless_equals_int (g_list_length (frames), NUM_PENDING_FRAMES);
+  for (iter = frames, i = 0; iter; iter = iter->next, i++) {
+    frame = iter->data;
+    fail_unless_equals_int (frame->system_frame_number, i);
+  }
+  g_list_free_full (frames, (GDestroyNotify) gst_video_codec_frame_unref);
+
+  /* finish the odd frames first, then the even ones */
+  for (i = 0; i < NUM_PENDING_FRAMES; i++) {
+    if (i < NUM_PENDING_FRAMES / 2)
+      n = 2 * i + 1;
+    else
+      n = 2 * (i - NUM_PENDING_FRAMES / 2);
+
+    if (i == NUM_PENDING_FRAMES / 2) {
+      frame = gst_video_decoder_get_oldest_frame (GST_VIDEO_DECODER (dec));
+      fail_unless (frame != NULL);
+      fail_unless_equals_int (frame->system_frame_number, 0);
+      gst_video_codec_frame_unref (frame);
+    }
+
+    frame = gst_video_decoder_get_frame (GST_VIDEO_DECODER (dec), n);
+    fail_unless (frame != NULL);
+    fail_unless_equals_int (frame->system_frame_number, n);
+    frame->output_buffer = gst_buffer_new_allocate (NULL,
+        TEST_VIDEO_WIDTH * TEST_VIDEO_HEIGHT, NULL);
+    fail_unless (gst_video_decoder_finish_frame (GST_VIDEO_DECODER (dec),
+            frame) == GST_FLOW_OK);
+
+    fail_unless (gst_video_decoder_get_frame (GST_VIDEO_DECODER (dec),
+            n) == NULL);
+  }
+
+  fail_unless (gst_video_decoder_get_oldest_frame (GST_VIDEO_DECODER (dec))
+      == NULL);
+  fail_unless (gst_video_decoder_get_frames (GST_VIDEO_DECODER (dec)) == NULL);
+  fail_unless_equals_int (g_list_length (buffers), NUM_PENDING_FRAMES);
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  cleanup_videodecodertest ();
+}
+
+GST_END_TEST;
+
 GST_START_TEST (videodecoder_playback_with_events)
 {
   GstSegment segment;
@@ -1160,6 +1417,10 @@ gst_videodecoder_suite (void)
 
   tcase_add_test (tc, videodecoder_playback);
   tcase_add_test (tc, videodecoder_playback_with_events);
+  tcase_add_test (tc, videodecoder_pending_frames);
+  tcase_add_test (tc, videodecoder_frame_pool);
+  tcase_add_test (tc, videodecoder_frame_threads);
+  tcase_add_test (tc, videodecoder_frame_threads_error_at_eos);
   tcase_add_test (tc, videodecoder_playback_first_frames_not_decoded);
   tcase_add_test (tc, videodecoder_buffer_after_segment);
   tcase_add_test (tc, videodecoder_first_data_is_gap);
@@ -48,6 +48,8 @@ struct _GstVideoEncoderTester
   GstVideoEncoder parent;
 
   GstFlowReturn pre_push_result;
+  gboolean use_bands;
+  guint n_bands;
 };
 
 struct _GstVideoEncoderTesterClass
@@ -87,10 +89,22 @@ static GstFlowReturn
 gst_video_encoder_tester_handle_frame (GstVideoEncoder * dec,
     GstVideoCodecFrame * frame)
 {
+  GstVideoEncoderTester *tester = (GstVideoEncoderTester *) dec;
   guint8 *data;
   GstMapInfo map;
   guint64 input_num;
 
+  if (tester->use_bands) {
+    GstFlowReturn ret;
+
+    ret = gst_video_encoder_encode_bands (dec, frame, tester->n_bands, 16);
+    if (ret != GST_FLOW_OK) {
+      gst_video_codec_frame_unref (frame);
+      return ret;
+    }
+    return gst_video_encoder_finish_frame (dec, frame);
+  }
+
   gst_buffer_map (frame->input_buffer, &map, GST_MAP_READ);
   input_num = *((guint64 *) map.data);
   gst_buffer_unmap (frame->input_buffer, &map);
@@ -105,6 +119,26 @@ gst_video_encoder_tester_handle_frame (GstVideoEncoder * dec,
   return gst_video_encoder_finish_frame (dec, frame);
 }
 
+/* outputs the first pixel of each row */
+static GstFlowReturn
+gst_video_encoder_tester_encode_band (GstVideoEncoder * enc,
+    GstVideoCodecFrame * frame, GstVideoFrame * vframe, guint y,
+    guint height, GstBuffer ** output)
+{
+  guint8 *src = GST_VIDEO_FRAME_PLANE_DATA (vframe, 0);
+  gint stride = GST_VIDEO_FRAME_PLANE_STRIDE (vframe, 0);
+  GstMapInfo map;
+  guint i;
+
+  *output = gst_buffer_new_allocate (NULL, height, NULL);
+  gst_buffer_map (*output, &map, GST_MAP_WRITE);
+  for (i = 0; i < height; i++)
+    map.data[i] = src[(y + i) * stride];
+  gst_buffer_unmap (*output, &map);
+
+  return GST_FLOW_OK;
+}
+
 static GstFlowReturn
 gst_video_encoder_tester_pre_push (GstVideoEncoder * enc,
     GstVideoCodecFrame * frame)
@@ -138,6 +172,7 @@ gst_video_encoder_tester_class_init (GstVideoEncoderTesterClass * klass)
   videoencoder_class->stop = gst_video_encoder_tester_stop;
   videoencoder_class->handle_frame = gst_video_encoder_tester_handle_frame;
   videoencoder_class->pre_push = gst_video_encoder_tester_pre_push;
+  videoencoder_class->encode_band = gst_video_encoder_tester_encode_band;
   videoencoder_class->set_format = gst_video_encoder_tester_set_format;
 }
 
@@ -534,6 +569,75 @@ GST_START_TEST (videoencoder_pre_push_fails)
 
 GST_END_TEST;
 
+static GstBuffer *
+create_test_frame (void)
+{
+  GstBuffer *buffer;
+  GstMapInfo map;
+  guint i;
+
+  buffer = gst_buffer_new_allocate (NULL,
+      TEST_VIDEO_WIDTH * TEST_VIDEO_HEIGHT, NULL);
+  gst_buffer_map (buffer, &map, GST_MAP_WRITE);
+  for (i = 0; i < TEST_VIDEO_HEIGHT; i++)
+    memset (map.data + i * TEST_VIDEO_WIDTH, i & 0xff, TEST_VIDEO_WIDTH);
+  gst_buffer_unmap (buffer, &map);
+
+  return buffer;
+}
+
+static void
+check_band_encoding (guint n_threads, guint n_bands)
+{
+  GstVideoEncoderTester *tester;
+  GstHarness *h;
+  GstBuffer *buffer;
+  GstMapInfo map;
+  guint i;
+
+  tester = g_object_new (GST_VIDEO_ENCODER_TESTER_TYPE, NULL);
+  tester->use_bands = TRUE;
+  tester->n_bands = n_bands;
+  gst_video_encoder_set_band_threads (GST_VIDEO_ENCODER (tester), n_threads);
+  fail_unless_equals_int (gst_video_encoder_get_band_threads
+      (GST_VIDEO_ENCODER (tester)), n_threads);
+
+  h = gst_harness_new_with_element (GST_ELEMENT (tester), "sink", "src");
+  gst_harness_set_src_caps (h, create_test_caps ());
+
+  for (i = 0; i < 10; i++)
+    fail_unless_equals_int (gst_harness_push (h, create_test_frame ()),
+        GST_FLOW_OK);
+
+  /* the bands are put back together from top to bottom */
+  for (i = 0; i < 10; i++) {
+    guint row;
+
+    buffer = gst_harness_pull (h);
+    fail_unless_equals_int (gst_buffer_get_size (buffer), TEST_VIDEO_HEIGHT);
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+    for (row = 0; row < TEST_VIDEO_HEIGHT; row++)
+      fail_unless_equals_int (map.data[row], row & 0xff);
+    gst_buffer_unmap (buffer, &map);
+    gst_buffer_unref (buffer);
+  }
+
+  gst_harness_teardown (h);
+  gst_object_unref (tester);
+}
+
+GST_START_TEST (videoencoder_band_threads)
+{
+  /* one band per thread */
+  check_band_encoding (4, 0);
+  /* rounding the band height up to 16 rows leaves 6 bands of 80 rows */
+  check_band_encoding (4, 7);
+  /* all bands in the streaming thread */
+  check_band_encoding (1, 5);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_videoencoder_suite (void)
 {
@@ -547,6 +651,7 @@ gst_videoencoder_suite (void)
   tcase_add_test (tc, videoencoder_events_before_eos);
   tcase_add_test (tc, videoencoder_flush_events);
   tcase_add_test (tc, videoencoder_pre_push_fails);
+  tcase_add_test (tc, videoencoder_band_threads);
 
   return s;
 }
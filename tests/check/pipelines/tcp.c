@@ -215,6 +215,115 @@ GST_START_TEST (test_that_tcpserversink_and_tcpclientsrc_are_symmetrical)
 
 GST_END_TEST;
 
+static GstBuffer *
+new_pattern_buffer (guint n_mem, gsize mem_size, gsize * offset)
+{
+  GstBuffer *buf = gst_buffer_new ();
+  guint i;
+  gsize j;
+
+  for (i = 0; i < n_mem; i++) {
+    guint8 *data = g_malloc (mem_size);
+
+    for (j = 0; j < mem_size; j++)
+      data[j] = (*offset)++ % 251;
+    gst_buffer_append_memory (buf,
+        gst_memory_new_wrapped (0, data, mem_size, 0, mem_size, data, g_free));
+  }
+  return buf;
+}
+
+#define LIST_BUFFERS 32
+#define BUFFER_MEMS 8
+#define MEM_SIZE (32 * 1024)
+
+GST_START_TEST (test_tcpclientsink_buffer_list)
+{
+  GstElement *pipeline, *appsrc, *sink;
+  GSocket *server, *client;
+  GInetAddress *iaddr;
+  GSocketAddress *addr;
+  GstBufferList *list;
+  GstCaps *caps;
+  guint8 *data;
+  gsize i, offset = 0, received = 0;
+  gsize total = LIST_BUFFERS * BUFFER_MEMS * MEM_SIZE;
+  gint port;
+
+  /* with a tiny receive buffer the list is much larger than what the socket
+   * can hold, so the vectored sends only partially succeed and have to
+   * continue in the middle of a chunk */
+  server = g_socket_new (G_SOCKET_FAMILY_IPV4, G_SOCKET_TYPE_STREAM,
+      G_SOCKET_PROTOCOL_TCP, NULL);
+  fail_unless (server != NULL);
+  fail_unless (g_socket_set_option (server, SOL_SOCKET, SO_RCVBUF, 4096,
+          NULL));
+  iaddr = g_inet_address_new_loopback (G_SOCKET_FAMILY_IPV4);
+  addr = g_inet_socket_address_new (iaddr, 0);
+  fail_unless (g_socket_bind (server, addr, TRUE, NULL));
+  g_object_unref (addr);
+  g_object_unref (iaddr);
+  fail_unless (g_socket_listen (server, NULL));
+  addr = g_socket_get_local_address (server, NULL);
+  fail_unless (addr != NULL);
+  port = g_inet_socket_address_get_port (G_INET_SOCKET_ADDRESS (addr));
+  g_object_unref (addr);
+
+  pipeline = gst_pipeline_new (NULL);
+  appsrc = gst_check_setup_element ("appsrc");
+  sink = gst_check_setup_element ("tcpclientsink");
+  g_object_set (sink, "host", "127.0.0.1", "port", port, "sync", FALSE, NULL);
+  caps = gst_caps_from_string ("application/x-gst-check");
+  gst_app_src_set_caps (GST_APP_SRC (appsrc), caps);
+  gst_caps_unref (caps);
+  gst_bin_add_many (GST_BIN (pipeline), appsrc, sink, NULL);
+  fail_unless (gst_element_link (appsrc, sink));
+  fail_unless (gst_element_set_state (pipeline,
+          GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE);
+
+  client = g_socket_accept (server, NULL, NULL);
+  fail_unless (client != NULL);
+
+  /* more chunks than fit in one vectored send */
+  list = gst_buffer_list_new ();
+  for (i = 0; i < LIST_BUFFERS; i++)
+    gst_buffer_list_add (list,
+        new_pattern_buffer (BUFFER_MEMS, MEM_SIZE, &offset));
+  fail_unless_equals_int (gst_app_src_push_buffer_list (GST_APP_SRC (appsrc),
+          list), GST_FLOW_OK);
+
+  /* let the sink fill up the socket buffers before reading anything */
+  g_usleep (G_USEC_PER_SEC / 10);
+
+  data = g_malloc (total);
+  while (received < total) {
+    gssize ret;
+
+    ret = g_socket_receive (client, (gchar *) data + received,
+        MIN (total - received, 4096), NULL, NULL);
+    fail_unless (ret > 0);
+    received += ret;
+  }
+  for (i = 0; i < total; i++) {
+    if (data[i] != i % 251)
+      fail ("byte %" G_GSIZE_FORMAT " is %u instead of %u", i, data[i],
+          (guint) (i % 251));
+  }
+  g_free (data);
+
+  fail_unless (gst_element_set_state (pipeline,
+          GST_STATE_NULL) != GST_STATE_CHANGE_FAILURE);
+  gst_object_unref (pipeline);
+  g_object_unref (client);
+  g_object_unref (server);
+}
+
+GST_END_TEST;
+
+#undef LIST_BUFFERS
+#undef BUFFER_MEMS
+#undef MEM_SIZE
+
 static void
 on_connection_closed (GstElement * socketsrc, gpointer user_data)
 {
@@ -362,6 +471,7 @@ socketintegrationtest_suite (void)
       test_that_tcpclientsink_and_tcpserversrc_are_symmetrical);
   tcase_add_test (tc_chain,
       test_that_tcpserversink_and_tcpclientsrc_are_symmetrical);
+  tcase_add_test (tc_chain, test_tcpclientsink_buffer_list);
   tcase_add_test (tc_chain,
       test_that_we_can_provide_new_socketsrc_sockets_during_signal);
 #ifdef HAVE_GIO_UNIX_2_0
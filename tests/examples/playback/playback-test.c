@@ -65,6 +65,7 @@ typedef enum
   GST_PLAY_FLAG_DEINTERLACE = (1 << 9),
   GST_PLAY_FLAG_SOFT_COLORBALANCE = (1 << 10),
   GST_PLAY_FLAG_FORCE_FILTERS = (1 << 11),
+  GST_PLAY_FLAG_RECYCLE_ELEMENTS = (1 << 12),
 } GstPlayFlags;
 
 /* configuration */